@@ -405,6 +405,120 @@ __device__ void cuWelfordMuSigma2(const __half *__restrict__ vals, const int n1,
   }
 }
 
+template <>
+__device__ void cuWelfordMuSigma2(const float *__restrict__ vals, const int n1,
+                                  const int n2, const int i1, float &mu,
+                                  float &sigma2, float *buf, bool rms_only) {
+  // Float specialization that reads 128 bits per load (float4) when the row
+  // is 16-byte aligned. Otherwise identical to the generic version.
+  float count = 0.0f;
+  mu = float(0);
+  sigma2 = float(0);
+  if (i1 < n1) {
+    const int numx = blockDim.x * blockDim.y;
+    const int thrx = threadIdx.x + threadIdx.y * blockDim.x;
+    const float *lvals = vals + i1 * n2;
+    int l = 4 * thrx;
+    if ((((size_t)lvals) & 15) == 0) {
+      // Threads advance in steps of 4 floats, so every access stays aligned.
+      for (; l + 3 < n2; l += 4 * numx) {
+        float4 curr = *((const float4 *)(lvals + l));
+        if (!rms_only) {
+          cuWelfordOnlineSum(curr.x, mu, sigma2, count);
+          cuWelfordOnlineSum(curr.y, mu, sigma2, count);
+          cuWelfordOnlineSum(curr.z, mu, sigma2, count);
+          cuWelfordOnlineSum(curr.w, mu, sigma2, count);
+        } else {
+          cuRMSOnlineSum(curr.x, sigma2);
+          cuRMSOnlineSum(curr.y, sigma2);
+          cuRMSOnlineSum(curr.z, sigma2);
+          cuRMSOnlineSum(curr.w, sigma2);
+        }
+      }
+    } else {
+      for (; l + 3 < n2; l += 4 * numx) {
+        for (int k = 0; k < 4; ++k) {
+          float curr = lvals[l + k];
+          if (!rms_only) {
+            cuWelfordOnlineSum(curr, mu, sigma2, count);
+          } else {
+            cuRMSOnlineSum(curr, sigma2);
+          }
+        }
+      }
+    }
+    for (; l < n2; ++l) {
+      float curr = lvals[l];
+      if (!rms_only) {
+        cuWelfordOnlineSum(curr, mu, sigma2, count);
+      } else {
+        cuRMSOnlineSum(curr, sigma2);
+      }
+    }
+    // intra-warp reductions
+    for (int l = 0; l <= 4; ++l) {
+      int srcLaneB = (threadIdx.x + (1 << l)) & 31;
+      float sigma2B = __shfl_sync(0xffffffff, sigma2, srcLaneB, warpSize);
+      if (!rms_only) {
+        float muB = __shfl_sync(0xffffffff, mu, srcLaneB, warpSize);
+        float countB = __shfl_sync(0xffffffff, count, srcLaneB, warpSize);
+        cuChanOnlineSum(muB, sigma2B, countB, mu, sigma2, count);
+      } else {
+        cuChanRMSOnlineSum(sigma2B, sigma2);
+      }
+    }
+    // threadIdx.x == 0 has correct values for each warp
+    // inter-warp reductions
+    if (blockDim.y > 1) {
+      float *ubuf = (float *)buf;
+      float *ibuf = (float *)(ubuf + blockDim.y);
+      for (int offset = blockDim.y / 2; offset > 0; offset /= 2) {
+        // upper half of warps write to shared
+        if (threadIdx.x == 0 && threadIdx.y >= offset &&
+            threadIdx.y < 2 * offset) {
+          const int wrt_y = threadIdx.y - offset;
+          ubuf[2 * wrt_y + 1] = sigma2;
+          if (!rms_only) {
+            ubuf[2 * wrt_y] = mu;
+            ibuf[wrt_y] = count;
+          }
+        }
+        __syncthreads();
+        // lower half merges
+        if (threadIdx.x == 0 && threadIdx.y < offset) {
+          float sigma2B = ubuf[2 * threadIdx.y + 1];
+          if (!rms_only) {
+            float muB = ubuf[2 * threadIdx.y];
+            float countB = ibuf[threadIdx.y];
+            cuChanOnlineSum(muB, sigma2B, countB, mu, sigma2, count);
+          } else {
+            cuChanRMSOnlineSum(sigma2B, sigma2);
+          }
+        }
+        __syncthreads();
+      }
+      // threadIdx.x = 0 && threadIdx.y == 0 only thread that has correct values
+      if (threadIdx.x == 0 && threadIdx.y == 0) {
+        if (!rms_only) {
+          ubuf[0] = mu;
+        }
+        ubuf[1] = sigma2;
+      }
+      __syncthreads();
+      if (!rms_only) {
+        mu = ubuf[0];
+      }
+      sigma2 = ubuf[1] / float(n2);
+      // don't care about final value of count, we know count == n2
+    } else {
+      if (!rms_only) {
+        mu = __shfl_sync(0xffffffff, mu, 0, warpSize);
+      }
+      sigma2 = __shfl_sync(0xffffffff, sigma2 / float(n2), 0, warpSize);
+    }
+  }
+}
+
 // This is the un-specialized struct.  Note that we prevent instantiation of
 // this struct by putting an undefined symbol in the function body so it won't
 // compile.
@@ -497,181 +611,37 @@ cuApplyRMSNorm(V *__restrict__ output_vals, U *__restrict__ invvar,
                              gamma, NULL, true);
 }
 
+// Grid sizing for the row-persistent kernels: enough 128-thread blocks to
+// fill the device, each iterating over rows, instead of one block per row.
+// Oversubscribing the SMs by 4x hides the tail without oversizing the grid.
+int PersistentGridY(int n1) {
+  int device;
+  int sm_count;
+  int max_grid_y;
+  cudaGetDevice(&device);
+  cudaDeviceGetAttribute(&sm_count, cudaDevAttrMultiProcessorCount, device);
+  cudaDeviceGetAttribute(&max_grid_y, cudaDevAttrMaxGridDimY, device);
+  int grid_y = 4 * sm_count;
+  if (grid_y > n1) {
+    grid_y = n1;
+  }
+  if (grid_y > max_grid_y) {
+    grid_y = max_grid_y;
+  }
+  return grid_y > 0 ? grid_y : 1;
+}
+
 template <typename T, typename U, typename V = T>
 void HostApplyRMSNorm(cudaStream_t stream, V *output, U *invvar, const T *input,
                       int n1, int n2, double epsilon, const V *gamma) {
-  auto getMaxGridY = []() {
-    int device;
-    int val;
-    cudaGetDevice(&device);
-    cudaDeviceGetAttribute(&val, cudaDevAttrMaxGridDimY, device);
-    return val;
-  };
   const dim3 threads(32, 4, 1);
-  const uint64_t maxGridY = getMaxGridY();
-  const dim3 blocks(1, std::min((uint64_t)n1, maxGridY), 1);
+  const dim3 blocks(1, PersistentGridY(n1), 1);
   int nshared =
       threads.y > 1 ? threads.y * sizeof(U) + (threads.y / 2) * sizeof(U) : 0;
   cuApplyRMSNorm<<<blocks, threads, nshared, stream>>>(
       output, invvar, input, n1, n2, U(epsilon), gamma);
 }
 
-template <typename T, typename U, typename V>
-__device__ void cuLoadWriteStridedInputs(
-    const int i1_block, const int thr_load_row_off, const int thr_load_col_off,
-    const int i2_off, const int row_stride, U *warp_buf1, U *warp_buf2,
-    const T *input, const V *dout, const int i1_end, const int n2,
-    const U *__restrict__ mean, const U *__restrict__ invvar, bool rms_only) {
-  int i1 = i1_block + thr_load_row_off;
-  if (i1 < i1_end) {
-    U curr_mean;
-    if (!rms_only) {
-      curr_mean = mean[i1];
-    }
-    U curr_invvar = invvar[i1];
-    for (int k = 0; k < blockDim.y; ++k) {
-      int i2 = i2_off + k;
-      int load_idx = i1 * n2 + i2;
-      int write_idx = thr_load_row_off * row_stride + thr_load_col_off + k;
-      if (i2 < n2) {
-        U curr_input = static_cast<U>(input[load_idx]);
-        U curr_dout = static_cast<U>(dout[load_idx]);
-        if (!rms_only) {
-          warp_buf1[write_idx] = curr_dout;
-          warp_buf2[write_idx] =
-              curr_dout * (curr_input - curr_mean) * curr_invvar;
-        } else {
-          warp_buf2[write_idx] = curr_dout * (curr_input)*curr_invvar;
-        }
-      } else {
-        if (!rms_only) {
-          warp_buf1[write_idx] = U(0);
-        }
-        warp_buf2[write_idx] = U(0);
-      }
-    }
-  } else {
-    for (int k = 0; k < blockDim.y; ++k) {
-      int write_idx = thr_load_row_off * row_stride + thr_load_col_off + k;
-      if (!rms_only) {
-        warp_buf1[write_idx] = U(0);
-      }
-      warp_buf2[write_idx] = U(0);
-    }
-  }
-}
-
-template <typename T, typename U, typename V>
-__device__ void cuLoadAddStridedInputs(
-    const int i1_block, const int thr_load_row_off, const int thr_load_col_off,
-    const int i2_off, const int row_stride, U *warp_buf1, U *warp_buf2,
-    const T *input, const V *dout, const int i1_end, const int n2,
-    const U *__restrict__ mean, const U *__restrict__ invvar, bool rms_only) {
-  int i1 = i1_block + thr_load_row_off;
-  if (i1 < i1_end) {
-    U curr_mean;
-    if (!rms_only) {
-      curr_mean = mean[i1];
-    }
-    U curr_invvar = invvar[i1];
-    for (int k = 0; k < blockDim.y; ++k) {
-      int i2 = i2_off + k;
-      int load_idx = i1 * n2 + i2;
-      int write_idx = thr_load_row_off * row_stride + thr_load_col_off + k;
-      if (i2 < n2) {
-        U curr_input = static_cast<U>(input[load_idx]);
-        U curr_dout = static_cast<U>(dout[load_idx]);
-        if (!rms_only) {
-          warp_buf1[write_idx] += curr_dout;
-          warp_buf2[write_idx] +=
-              curr_dout * (curr_input - curr_mean) * curr_invvar;
-        } else {
-          warp_buf2[write_idx] += curr_dout * (curr_input)*curr_invvar;
-        }
-      }
-    }
-  }
-}
-
-template <typename T, typename U, typename V>
-__global__ void cuComputePartGradGammaBeta(
-    const V *__restrict__ dout, const T *__restrict__ input, const int n1,
-    const int n2, const U *__restrict__ mean, const U *__restrict__ invvar,
-    U epsilon, U *part_grad_gamma, U *part_grad_beta, bool rms_only) {
-  const int numsegs_n1 =
-      (n1 + blockDim.y * blockDim.y - 1) / (blockDim.y * blockDim.y);
-  const int segs_per_block = (numsegs_n1 + gridDim.y - 1) / gridDim.y;
-  const int i1_beg = blockIdx.y * segs_per_block * blockDim.y * blockDim.y;
-  const int i1_beg_plus_one =
-      (blockIdx.y + 1) * segs_per_block * blockDim.y * blockDim.y;
-  const int i1_end = i1_beg_plus_one < n1 ? i1_beg_plus_one : n1;
-  const int row_stride = blockDim.x + 1;
-  const int thr_load_col_off = (threadIdx.x * blockDim.y) & (blockDim.x - 1);
-  const int thr_load_row_off =
-      (threadIdx.x * blockDim.y) / blockDim.x + threadIdx.y * blockDim.y;
-  const int i2_off = blockIdx.x * blockDim.x + thr_load_col_off;
-  SharedMemory<U> shared;
-  U *buf = shared.getPointer(); // buf has at least blockDim.x * blockDim.y *
-                                // blockDim.y + (blockDim.y -
-                                // 1)*(blockDim.x/blockDim.y) elements
-  U *warp_buf1 = (U *)buf;
-  U *warp_buf2 = warp_buf1 + blockDim.y * blockDim.y * row_stride;
-  // compute partial sums from strided inputs
-  // do this to increase number of loads in flight
-  cuLoadWriteStridedInputs(i1_beg, thr_load_row_off, thr_load_col_off, i2_off,
-                           row_stride, warp_buf1, warp_buf2, input, dout,
-                           i1_end, n2, mean, invvar, rms_only);
-  for (int i1_block = i1_beg + blockDim.y * blockDim.y; i1_block < i1_end;
-       i1_block += blockDim.y * blockDim.y) {
-    cuLoadAddStridedInputs(i1_block, thr_load_row_off, thr_load_col_off, i2_off,
-                           row_stride, warp_buf1, warp_buf2, input, dout,
-                           i1_end, n2, mean, invvar, rms_only);
-  }
-  __syncthreads();
-  // inter-warp reductions
-  // sum within each warp
-  U acc1 = U(0);
-  U acc2 = U(0);
-  for (int k = 0; k < blockDim.y; ++k) {
-    int row1 = threadIdx.y + k * blockDim.y;
-    int idx1 = row1 * row_stride + threadIdx.x;
-    if (!rms_only) {
-      acc1 += warp_buf1[idx1];
-    }
-    acc2 += warp_buf2[idx1];
-  }
-  if (!rms_only) {
-    warp_buf1[threadIdx.y * row_stride + threadIdx.x] = acc1;
-  }
-  warp_buf2[threadIdx.y * row_stride + threadIdx.x] = acc2;
-  __syncthreads();
-  // sum all warps
-  for (int offset = blockDim.y / 2; offset > 1; offset /= 2) {
-    if (threadIdx.y < offset) {
-      int row1 = threadIdx.y;
-      int row2 = threadIdx.y + offset;
-      int idx1 = row1 * row_stride + threadIdx.x;
-      int idx2 = row2 * row_stride + threadIdx.x;
-      if (!rms_only) {
-        warp_buf1[idx1] += warp_buf1[idx2];
-      }
-      warp_buf2[idx1] += warp_buf2[idx2];
-    }
-    __syncthreads();
-  }
-  int i2 = blockIdx.x * blockDim.x + threadIdx.x;
-  if (threadIdx.y == 0 && i2 < n2) {
-    int row1 = threadIdx.y;
-    int row2 = threadIdx.y + 1;
-    int idx1 = row1 * row_stride + threadIdx.x;
-    int idx2 = row2 * row_stride + threadIdx.x;
-    if (!rms_only) {
-      part_grad_beta[blockIdx.y * n2 + i2] = warp_buf1[idx1] + warp_buf1[idx2];
-    }
-    part_grad_gamma[blockIdx.y * n2 + i2] = warp_buf2[idx1] + warp_buf2[idx2];
-  }
-}
-
 template <typename U, typename V>
 __global__ void
 cuComputeGradGammaBeta(const U *part_grad_gamma, const U *part_grad_beta,
@@ -682,19 +652,13 @@ cuComputeGradGammaBeta(const U *part_grad_gamma, const U *part_grad_beta,
   U *buf = shared.getPointer();
   int i2 = blockIdx.x * blockDim.x + threadIdx.x;
   if (i2 < n2) {
-    // each warp does sequential reductions until reduced part_size is num_warps
-    int num_warp_reductions = part_size / blockDim.y;
+    // each warp strides over the partial-sum rows until all are consumed
     U sum_gamma = U(0);
     U sum_beta = U(0);
-    const U *part_grad_gamma_ptr =
-        part_grad_gamma + threadIdx.y * num_warp_reductions * n2 + i2;
-    const U *part_grad_beta_ptr =
-        part_grad_beta + threadIdx.y * num_warp_reductions * n2 + i2;
-    for (int warp_offset = 0; warp_offset < num_warp_reductions;
-         ++warp_offset) {
-      sum_gamma += part_grad_gamma_ptr[warp_offset * n2];
+    for (int row = threadIdx.y; row < part_size; row += blockDim.y) {
+      sum_gamma += part_grad_gamma[row * n2 + i2];
       if (!rms_only) {
-        sum_beta += part_grad_beta_ptr[warp_offset * n2];
+        sum_beta += part_grad_beta[row * n2 + i2];
       }
     }
     // inter-warp reductions
@@ -734,7 +698,17 @@ __global__ void
 cuComputeGradInput(const V *__restrict__ dout, const T *__restrict__ input,
                    const int n1, const int n2, const U *__restrict__ mean,
                    const U *__restrict__ invvar, U epsilon, const V *gamma,
-                   T *grad_input, bool rms_only) {
+                   T *grad_input, U *part_grad_gamma, const int part_size,
+                   bool rms_only) {
+  // When part_grad_gamma is non-NULL, each block also accumulates its rows'
+  // gamma-gradient contributions (dout * x_hat) into one of the part_size
+  // partial rows, so the weight gradient reuses the loads done for
+  // grad_input instead of re-reading input and dout in a separate grid. The
+  // buffer must be zeroed beforehand; blocks mapped to the same partial row
+  // combine with atomics (for double this requires sm_60+).
+  U *k_part_grad_gamma =
+      part_grad_gamma != NULL ? part_grad_gamma + (blockIdx.y % part_size) * n2
+                              : NULL;
   for (auto i1 = blockIdx.y; i1 < n1; i1 += gridDim.y) {
     U sum_loss1 = U(0);
     U sum_loss2 = U(0);
@@ -851,6 +825,10 @@ cuComputeGradInput(const V *__restrict__ dout, const T *__restrict__ input,
       for (int l = thrx; l < n2; l += numx) {
         const U c_h = static_cast<U>(k_input[l]);
         const U c_loss = static_cast<U>(k_dout[l]);
+        if (k_part_grad_gamma != NULL) {
+          U x_hat = rms_only ? (c_h)*c_invvar : (c_h - c_mean) * c_invvar;
+          atomicAdd(&k_part_grad_gamma[l], c_loss * x_hat);
+        }
         U f_grad_input = fH * c_loss * static_cast<U>(gamma[l]);
         if (!rms_only) {
           f_grad_input -= sum_loss1;
@@ -886,45 +864,29 @@ void HostRMSNormGradient(cudaStream_t stream, const V *dout, const U *invvar,
                          const T *input, int n1, int n2, const V *gamma,
                          double epsilon, T *grad_input, V *grad_gamma,
                          int part_size, U *part_grad_gamma) {
-  auto getMaxGridY = []() {
-    int device;
-    int val;
-    cudaGetDevice(&device);
-    cudaDeviceGetAttribute(&val, cudaDevAttrMaxGridDimY, device);
-    return val;
-  };
-  const uint64_t maxGridY = getMaxGridY();
+  // One fused, row-persistent pass reads input and dout exactly once,
+  // producing grad_input and the partial gamma gradients together; a small
+  // second kernel folds the part_size partial rows into grad_gamma.
+  const dim3 threads1(32, 4, 1);
+  const dim3 blocks1(1, PersistentGridY(n1), 1);
+  int nshared = threads1.y > 1 ? threads1.y * threads1.x * sizeof(U) : 0;
+  if (gamma != NULL) {
+    cudaMemsetAsync(part_grad_gamma, 0,
+                    static_cast<size_t>(part_size) * n2 * sizeof(U), stream);
+  }
+  cuComputeGradInput<<<blocks1, threads1, nshared, stream>>>(
+      dout, input, n1, n2, invvar, /* unused */
+      invvar, U(epsilon), gamma, grad_input,
+      gamma != NULL ? part_grad_gamma : NULL, part_size, true);
   if (gamma != NULL) {
-    const dim3 threads2(32, 4, 1);
-    const dim3 blocks2((n2 + threads2.x - 1) / threads2.x, part_size, 1);
-    const int nshared2_a =
-        2 * sizeof(U) * threads2.y * threads2.y * (threads2.x + 1);
-    const int nshared2_b = threads2.x * threads2.y * sizeof(U);
-    const int nshared2 = nshared2_a > nshared2_b ? nshared2_a : nshared2_b;
-    // note (mkozuki): I can hard code part_grad_gamma's dtype as float given
-    // that the `cuda_layer_norm_gradient` doesn't support double.
-    cuComputePartGradGammaBeta<<<blocks2, threads2, nshared2, stream>>>(
-        dout, input, n1, n2,
-        invvar,                                               // unused
-        invvar, U(epsilon), part_grad_gamma, part_grad_gamma, /* unused */
-        true);
-
     const dim3 threads3(32, 8, 1);
-    const dim3 blocks3((n2 + threads2.x - 1) / threads2.x, 1, 1);
+    const dim3 blocks3((n2 + threads3.x - 1) / threads3.x, 1, 1);
     const int nshared3 = threads3.x * threads3.y * sizeof(U);
     cuComputeGradGammaBeta<<<blocks3, threads3, nshared3, stream>>>(
         part_grad_gamma, part_grad_gamma,          /* unused */
         part_size, n1, n2, grad_gamma, grad_gamma, /* unused */
         true);
   }
-
-  // compute grad_input
-  const dim3 blocks1(1, std::min((uint64_t)n1, maxGridY), 1);
-  const dim3 threads1(32, 4, 1);
-  int nshared = threads1.y > 1 ? threads1.y * threads1.x * sizeof(U) : 0;
-  cuComputeGradInput<<<blocks1, threads1, nshared, stream>>>(
-      dout, input, n1, n2, invvar, /* unused */
-      invvar, U(epsilon), gamma, grad_input, true);
 }
 
 } // namespace
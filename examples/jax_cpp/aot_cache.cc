@@ -0,0 +1,141 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "examples/jax_cpp/aot_cache.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/cleanup/cleanup.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/logging.h"
+#include "tsl/platform/statusor.h"
+
+namespace jax_cpp {
+namespace {
+
+// Bump kFormatVersion whenever the layout below changes.
+constexpr char kMagic[8] = {'J', 'A', 'X', 'C', 'P', 'P', 'X', '\0'};
+constexpr uint32_t kFormatVersion = 1;
+
+// Padded to 64 bytes so the payload starts at a cache-line (and, for files
+// written at page-size multiples, mmap-page) aligned offset.
+struct AotFileHeader {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t reserved;
+  uint64_t payload_size;
+  char padding[40];
+};
+static_assert(sizeof(AotFileHeader) == 64, "header layout changed");
+
+}  // namespace
+
+xla::Status SaveExecutable(xla::PjRtLoadedExecutable* executable,
+                           const std::string& path) {
+  TF_ASSIGN_OR_RETURN(std::string serialized,
+                      executable->SerializeExecutable());
+  AotFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.format_version = kFormatVersion;
+  header.payload_size = serialized.size();
+  // Write to a temp file and rename, so a crash mid-write never leaves a
+  // truncated artifact for the next start to trip over.
+  const std::string tmp_path = absl::StrCat(path, ".tmp.", getpid());
+  {
+    std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      return absl::InternalError(absl::StrCat("cannot write ", tmp_path));
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(serialized.data(), serialized.size());
+    if (!out) {
+      return absl::InternalError(absl::StrCat("short write to ", tmp_path));
+    }
+  }
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    unlink(tmp_path.c_str());
+    return absl::InternalError(absl::StrCat("cannot rename to ", path));
+  }
+  return absl::OkStatus();
+}
+
+xla::StatusOr<std::unique_ptr<xla::PjRtLoadedExecutable>> LoadExecutable(
+    xla::PjRtClient* client, const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return absl::NotFoundError(absl::StrCat("no artifact at ", path));
+  }
+  absl::Cleanup close_fd = [fd] { close(fd); };
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(AotFileHeader)) {
+    return absl::InvalidArgumentError(absl::StrCat("truncated ", path));
+  }
+  void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (mapped == MAP_FAILED) {
+    return absl::InternalError(absl::StrCat("mmap failed for ", path));
+  }
+  absl::Cleanup unmap = [mapped, &st] { munmap(mapped, st.st_size); };
+  const auto* header = static_cast<const AotFileHeader*>(mapped);
+  if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 ||
+      header->format_version != kFormatVersion ||
+      header->payload_size != st.st_size - sizeof(AotFileHeader)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat(path, " has an incompatible header"));
+  }
+  // The payload is handed to the runtime straight out of the mapping; pages
+  // are faulted in on demand rather than read up front.
+  absl::string_view payload(
+      static_cast<const char*>(mapped) + sizeof(AotFileHeader),
+      header->payload_size);
+  return client->DeserializeExecutable(payload, /*options=*/std::nullopt);
+}
+
+xla::StatusOr<std::unique_ptr<xla::PjRtLoadedExecutable>> LoadOrCompile(
+    xla::PjRtClient* client, const xla::XlaComputation& computation,
+    const xla::CompileOptions& options, const std::string& path) {
+  xla::StatusOr<std::unique_ptr<xla::PjRtLoadedExecutable>> loaded =
+      LoadExecutable(client, path);
+  if (loaded.ok()) {
+    return loaded;
+  }
+  LOG(INFO) << "Compiling from scratch (" << loaded.status().message() << ")";
+  TF_ASSIGN_OR_RETURN(std::unique_ptr<xla::PjRtLoadedExecutable> executable,
+                      client->Compile(computation, options));
+  // Best effort: some backends do not implement executable serialization.
+  xla::Status saved = SaveExecutable(executable.get(), path);
+  if (!saved.ok()) {
+    LOG(WARNING) << "Could not save AOT artifact: " << saved.message();
+  }
+  return executable;
+}
+
+}  // namespace jax_cpp
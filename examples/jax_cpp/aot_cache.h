@@ -0,0 +1,55 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef JAX_EXAMPLES_JAX_CPP_AOT_CACHE_H_
+#define JAX_EXAMPLES_JAX_CPP_AOT_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/statusor.h"
+
+namespace jax_cpp {
+
+// Ahead-of-time executable cache: compiling a real model with
+// PjRtClient::Compile can take tens of seconds at process start, while
+// deserializing a precompiled artifact takes well under a second.
+//
+// On-disk format: a 64-byte versioned header (magic, format version, payload
+// size) followed by the bytes of PjRtLoadedExecutable::SerializeExecutable at
+// a page-alignment-friendly offset. The loader mmaps the file and hands the
+// payload to PjRtClient::DeserializeExecutable without copying it. Artifacts
+// are only valid for the jaxlib build and topology that produced them; a
+// header mismatch or failed deserialization falls back to compilation.
+
+// Serializes `executable` to `path` (written atomically via a temp file).
+xla::Status SaveExecutable(xla::PjRtLoadedExecutable* executable,
+                           const std::string& path);
+
+// Loads an executable previously written by SaveExecutable.
+xla::StatusOr<std::unique_ptr<xla::PjRtLoadedExecutable>> LoadExecutable(
+    xla::PjRtClient* client, const std::string& path);
+
+// Loads the executable from `path` if possible; otherwise compiles
+// `computation` and saves the result to `path` for the next start.
+xla::StatusOr<std::unique_ptr<xla::PjRtLoadedExecutable>> LoadOrCompile(
+    xla::PjRtClient* client, const xla::XlaComputation& computation,
+    const xla::CompileOptions& options, const std::string& path);
+
+}  // namespace jax_cpp
+
+#endif  // JAX_EXAMPLES_JAX_CPP_AOT_CACHE_H_
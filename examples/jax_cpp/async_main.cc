@@ -0,0 +1,99 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Demonstrates event-driven result retrieval on top of the jax_cpp runner.
+// A single dispatcher thread submits every request and registers the output
+// with a completion queue; no thread ever blocks on an individual result.
+// Uses the same HloModule as main.cc:
+//
+// $ python3 jax/tools/jax_to_hlo.py \
+// --fn examples.jax_cpp.prog.fn \
+// --input_shapes '[("x", "f32[2,2]"), ("y", "f32[2,2]")]' \
+// --constants '{"z": 2.0}' \
+// --hlo_text_dest /tmp/fn_hlo.txt
+//
+// $ bazel build examples/jax_cpp:async_main --experimental_repo_remote_exec \
+//    --check_visibility=false
+// $ bazel-bin/examples/jax_cpp/async_main
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "examples/jax_cpp/completion_queue.h"
+#include "examples/jax_cpp/runner.h"
+#include "xla/literal.h"
+#include "xla/pjrt/cpu/cpu_client.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/statusor.h"
+#include "xla/tools/hlo_module_loader.h"
+#include "tsl/platform/init_main.h"
+#include "tsl/platform/logging.h"
+
+int main(int argc, char** argv) {
+  tsl::port::InitMain("", &argc, &argv);
+
+  std::string hlo_filename = "/tmp/fn_hlo.txt";
+  std::function<void(xla::HloModuleConfig*)> config_modifier_hook =
+      [](xla::HloModuleConfig* config) { config->set_seed(42); };
+  std::unique_ptr<xla::HloModule> test_module =
+      LoadModuleFromFile(hlo_filename, /*format=*/"txt",
+                         xla::hlo_module_loader_details::Config(),
+                         config_modifier_hook)
+          .value();
+  const xla::HloModuleProto test_module_proto = test_module->ToProto();
+
+  std::unique_ptr<xla::PjRtClient> client =
+      xla::GetTfrtCpuClient(/*asynchronous=*/true).value();
+  xla::XlaComputation xla_computation(test_module_proto);
+  xla::CompileOptions compile_options;
+  std::unique_ptr<xla::PjRtLoadedExecutable> executable =
+      client->Compile(xla_computation, compile_options).value();
+
+  jax_cpp::ExecutableRunner runner(client.get(), std::move(executable));
+  jax_cpp::CompletionQueue queue;
+
+  // Dispatch loop: every iteration enqueues an execution and moves on. The
+  // device-to-host copies started by Watch run concurrently with the later
+  // submissions, so all kNumRequests executions are in flight at once.
+  constexpr int kNumRequests = 100;
+  std::vector<std::vector<float>> xs(kNumRequests);
+  std::vector<float> y = {1.0f, 1.0f, 1.0f, 1.0f};
+  for (int i = 0; i < kNumRequests; ++i) {
+    float v = static_cast<float>(i);
+    xs[i] = {v, v, v, v};
+    auto x_buffer =
+        runner
+            .WrapHostBuffer(xs[i].data(), xla::F32, {2, 2},
+                            /*donatable=*/false)
+            .value();
+    auto y_buffer =
+        runner.WrapHostBuffer(y.data(), xla::F32, {2, 2}, /*donatable=*/false)
+            .value();
+    auto results = runner.Run({x_buffer.get(), y_buffer.get()}).value();
+    queue.Watch(/*tag=*/static_cast<uint64_t>(i), std::move(results[0]));
+  }
+
+  // Consume completions as copies finish; this is the only blocking point.
+  for (int i = 0; i < kNumRequests; ++i) {
+    jax_cpp::CompletionQueue::Completion completion = queue.Next();
+    TF_CHECK_OK(completion.status);
+    LOG(INFO) << "request " << completion.tag << " -> "
+              << completion.literal->ToStringWithoutShape();
+  }
+  return 0;
+}
@@ -0,0 +1,100 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Demonstrates dynamic batching of concurrent inference requests on top of
+// the jax_cpp runner. The HloModule must be compiled with a leading batch
+// dimension, e.g.:
+//
+// $ python3 jax/tools/jax_to_hlo.py \
+// --fn examples.jax_cpp.prog.fn \
+// --input_shapes '[("x", "f32[8,2,2]"), ("y", "f32[8,2,2]")]' \
+// --constants '{"z": 2.0}' \
+// --hlo_text_dest /tmp/fn_hlo_batched.txt
+//
+// $ bazel build examples/jax_cpp:batch_main --experimental_repo_remote_exec \
+//    --check_visibility=false
+// $ bazel-bin/examples/jax_cpp/batch_main
+
+#include <future>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "examples/jax_cpp/batcher.h"
+#include "examples/jax_cpp/runner.h"
+#include "xla/pjrt/cpu/cpu_client.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/statusor.h"
+#include "xla/tools/hlo_module_loader.h"
+#include "tsl/platform/init_main.h"
+#include "tsl/platform/logging.h"
+
+int main(int argc, char** argv) {
+  tsl::port::InitMain("", &argc, &argv);
+
+  std::string hlo_filename = "/tmp/fn_hlo_batched.txt";
+  std::function<void(xla::HloModuleConfig*)> config_modifier_hook =
+      [](xla::HloModuleConfig* config) { config->set_seed(42); };
+  std::unique_ptr<xla::HloModule> test_module =
+      LoadModuleFromFile(hlo_filename, /*format=*/"txt",
+                         xla::hlo_module_loader_details::Config(),
+                         config_modifier_hook)
+          .value();
+  const xla::HloModuleProto test_module_proto = test_module->ToProto();
+
+  std::unique_ptr<xla::PjRtClient> client =
+      xla::GetTfrtCpuClient(/*asynchronous=*/true).value();
+  xla::XlaComputation xla_computation(test_module_proto);
+  xla::CompileOptions compile_options;
+  std::unique_ptr<xla::PjRtLoadedExecutable> executable =
+      client->Compile(xla_computation, compile_options).value();
+
+  jax_cpp::ExecutableRunner runner(client.get(), std::move(executable));
+
+  jax_cpp::BatchScheduler::Options options;
+  options.batch_size = 8;
+  options.max_batch_latency = absl::Milliseconds(2);
+  jax_cpp::BatchScheduler scheduler(
+      &runner,
+      /*arg_dims=*/{{8, 2, 2}, {8, 2, 2}},
+      /*result_size=*/4, options);
+
+  // Submit a dozen single-example requests from four threads; the scheduler
+  // coalesces them into two padded batches of 8.
+  std::vector<std::future<xla::StatusOr<std::vector<float>>>> futures(12);
+  std::vector<std::thread> producers;
+  for (int t = 0; t < 4; ++t) {
+    producers.emplace_back([t, &scheduler, &futures] {
+      for (int i = t; i < 12; i += 4) {
+        float v = static_cast<float>(i);
+        futures[i] = scheduler.Schedule(
+            {{v, v, v, v}, {1.0f, 1.0f, 1.0f, 1.0f}});
+      }
+    });
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+
+  for (int i = 0; i < 12; ++i) {
+    std::vector<float> row = futures[i].get().value();
+    LOG(INFO) << "result[" << i << "] = { " << row[0] << ", " << row[1]
+              << ", " << row[2] << ", " << row[3] << " }";
+  }
+  return 0;
+}
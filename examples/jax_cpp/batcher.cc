@@ -0,0 +1,225 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "examples/jax_cpp/batcher.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/xla_data.pb.h"
+
+namespace jax_cpp {
+namespace {
+
+int64_t NumElements(const std::vector<int64_t>& dims) {
+  int64_t n = 1;
+  for (int64_t d : dims) {
+    n *= d;
+  }
+  return n;
+}
+
+std::vector<int64_t> PerExampleSizes(
+    const std::vector<std::vector<int64_t>>& arg_dims, int batch_size) {
+  std::vector<int64_t> sizes;
+  sizes.reserve(arg_dims.size());
+  for (const std::vector<int64_t>& dims : arg_dims) {
+    sizes.push_back(NumElements(dims) / batch_size);
+  }
+  return sizes;
+}
+
+}  // namespace
+
+BatchScheduler::BatchScheduler(ExecutableRunner* runner,
+                               std::vector<std::vector<int64_t>> arg_dims,
+                               int64_t result_size, const Options& options)
+    : runner_(runner),
+      arg_dims_(std::move(arg_dims)),
+      arg_sizes_(PerExampleSizes(arg_dims_, options.batch_size)),
+      result_size_(result_size),
+      options_(options) {
+  scheduler_thread_ = std::thread([this] { SchedulerLoop(); });
+}
+
+BatchScheduler::~BatchScheduler() {
+  shutdown_.store(true, std::memory_order_release);
+  {
+    // Taking the lock orders the store against the scheduler's
+    // predicate-check-then-block sequence, so the notify cannot be lost.
+    std::lock_guard<std::mutex> lock(wakeup_mu_);
+  }
+  wakeup_cv_.notify_one();
+  scheduler_thread_.join();
+  for (Request* request : TakePending()) {
+    request->result.set_value(
+        absl::CancelledError("BatchScheduler destroyed"));
+    delete request;
+  }
+}
+
+std::future<xla::StatusOr<std::vector<float>>> BatchScheduler::Schedule(
+    std::vector<std::vector<float>> args) {
+  auto* request = new Request;
+  request->args = std::move(args);
+  std::future<xla::StatusOr<std::vector<float>>> future =
+      request->result.get_future();
+  // Lock-free push onto the pending stack.
+  Request* head = head_.load(std::memory_order_relaxed);
+  do {
+    request->next = head;
+  } while (!head_.compare_exchange_weak(head, request,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+  {
+    // The push itself is lock-free, but the notify must be ordered against
+    // the scheduler's predicate-check-then-block sequence or it can land in
+    // the window between the two and be lost, stalling this request.
+    std::lock_guard<std::mutex> lock(wakeup_mu_);
+  }
+  wakeup_cv_.notify_one();
+  return future;
+}
+
+std::vector<BatchScheduler::Request*> BatchScheduler::TakePending() {
+  Request* head = head_.exchange(nullptr, std::memory_order_acquire);
+  // The stack is LIFO; reverse it to recover submission order.
+  std::vector<Request*> requests;
+  for (Request* r = head; r != nullptr; r = r->next) {
+    requests.push_back(r);
+  }
+  std::reverse(requests.begin(), requests.end());
+  return requests;
+}
+
+void BatchScheduler::SchedulerLoop() {
+  std::vector<Request*> pending;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(wakeup_mu_);
+      wakeup_cv_.wait(lock, [this, &pending] {
+        return !pending.empty() ||
+               head_.load(std::memory_order_acquire) != nullptr ||
+               shutdown_.load(std::memory_order_acquire);
+      });
+    }
+    if (shutdown_.load(std::memory_order_acquire)) {
+      break;
+    }
+    // The flush deadline is anchored at the first arrival of this round:
+    // no request waits longer than max_batch_latency for peers.
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::nanoseconds(
+                              absl::ToInt64Nanoseconds(
+                                  options_.max_batch_latency));
+    while (true) {
+      for (Request* r : TakePending()) {
+        pending.push_back(r);
+      }
+      if (pending.size() >= static_cast<size_t>(options_.batch_size) ||
+          shutdown_.load(std::memory_order_acquire)) {
+        break;
+      }
+      std::unique_lock<std::mutex> lock(wakeup_mu_);
+      if (wakeup_cv_.wait_until(lock, deadline) ==
+          std::cv_status::timeout) {
+        for (Request* r : TakePending()) {
+          pending.push_back(r);
+        }
+        break;
+      }
+    }
+    while (!pending.empty()) {
+      size_t n = std::min(pending.size(),
+                          static_cast<size_t>(options_.batch_size));
+      std::vector<Request*> batch(pending.begin(), pending.begin() + n);
+      pending.erase(pending.begin(), pending.begin() + n);
+      RunBatch(std::move(batch));
+      if (pending.size() < static_cast<size_t>(options_.batch_size)) {
+        break;  // Leftovers wait for the next round's deadline.
+      }
+    }
+  }
+  // Drain: execute what is queued so no accepted request is dropped.
+  for (Request* r : TakePending()) {
+    pending.push_back(r);
+  }
+  while (!pending.empty()) {
+    size_t n =
+        std::min(pending.size(), static_cast<size_t>(options_.batch_size));
+    std::vector<Request*> batch(pending.begin(), pending.begin() + n);
+    pending.erase(pending.begin(), pending.begin() + n);
+    RunBatch(std::move(batch));
+  }
+}
+
+void BatchScheduler::RunBatch(std::vector<Request*> batch) {
+  auto fail = [&batch](const absl::Status& status) {
+    for (Request* r : batch) {
+      r->result.set_value(status);
+      delete r;
+    }
+  };
+  // Pack the examples row by row; unfilled rows stay zero.
+  std::vector<std::vector<float>> staging(arg_dims_.size());
+  for (size_t a = 0; a < arg_dims_.size(); ++a) {
+    staging[a].resize(options_.batch_size * arg_sizes_[a], 0.0f);
+    for (size_t i = 0; i < batch.size(); ++i) {
+      const std::vector<float>& arg = batch[i]->args[a];
+      std::memcpy(staging[a].data() + i * arg_sizes_[a], arg.data(),
+                  std::min<size_t>(arg.size(), arg_sizes_[a]) *
+                      sizeof(float));
+    }
+  }
+  std::vector<std::unique_ptr<xla::PjRtBuffer>> params;
+  std::vector<xla::PjRtBuffer*> param_ptrs;
+  for (size_t a = 0; a < arg_dims_.size(); ++a) {
+    auto param = runner_->WrapHostBuffer(staging[a].data(), xla::F32,
+                                         arg_dims_[a], /*donatable=*/true);
+    if (!param.ok()) {
+      fail(param.status());
+      return;
+    }
+    param_ptrs.push_back(param->get());
+    params.push_back(std::move(*param));
+  }
+  auto results = runner_->Run(param_ptrs);
+  if (!results.ok()) {
+    fail(results.status());
+    return;
+  }
+  auto mapped = ExecutableRunner::MapOutput((*results)[0].get());
+  if (!mapped.ok()) {
+    fail(mapped.status());
+    return;
+  }
+  const float* output = static_cast<const float*>(mapped->second);
+  for (size_t i = 0; i < batch.size(); ++i) {
+    std::vector<float> row(output + i * result_size_,
+                           output + (i + 1) * result_size_);
+    batch[i]->result.set_value(std::move(row));
+    delete batch[i];
+  }
+}
+
+}  // namespace jax_cpp
@@ -0,0 +1,99 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef JAX_EXAMPLES_JAX_CPP_BATCHER_H_
+#define JAX_EXAMPLES_JAX_CPP_BATCHER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/time/time.h"
+#include "examples/jax_cpp/runner.h"
+#include "xla/statusor.h"
+
+namespace jax_cpp {
+
+// Dynamic batching for a PjRtLoadedExecutable compiled with a fixed leading
+// batch dimension. Callers submit single examples from any number of threads;
+// a scheduler thread coalesces them into one Execute call when either the
+// batch fills up or the oldest request has waited `max_batch_latency`,
+// padding any unfilled rows with zeros. Executing one full batch costs about
+// the same as one example on CPU (the work is vectorized across rows), which
+// is where the throughput win comes from.
+//
+// Requests travel through a lock-free multi-producer single-consumer stack:
+// producers only do one compare-exchange per submit, and the scheduler thread
+// takes the whole pending list with a single exchange. A mutex + condition
+// variable pair is used solely to let the scheduler sleep between arrivals.
+class BatchScheduler {
+ public:
+  struct Options {
+    // Leading batch dimension the executable was compiled for.
+    int batch_size = 8;
+    // Upper bound on how long a request may wait for co-batched peers.
+    absl::Duration max_batch_latency = absl::Milliseconds(2);
+  };
+
+  // `arg_dims` are the batched dimensions of each parameter (leading
+  // dimension equal to options.batch_size); `result_size` is the per-example
+  // element count of the first output. All parameters and the output must be
+  // F32.
+  BatchScheduler(ExecutableRunner* runner,
+                 std::vector<std::vector<int64_t>> arg_dims,
+                 int64_t result_size, const Options& options);
+
+  // Drains in-flight requests (failing any not yet executed) and joins the
+  // scheduler thread.
+  ~BatchScheduler();
+
+  // Submits one example (one vector of elements per parameter). Thread-safe.
+  // The future resolves to the example's slice of the first output.
+  std::future<xla::StatusOr<std::vector<float>>> Schedule(
+      std::vector<std::vector<float>> args);
+
+ private:
+  struct Request {
+    std::vector<std::vector<float>> args;
+    std::promise<xla::StatusOr<std::vector<float>>> result;
+    Request* next = nullptr;
+  };
+
+  void SchedulerLoop();
+  // Pops the whole pending stack in submission order.
+  std::vector<Request*> TakePending();
+  void RunBatch(std::vector<Request*> batch);
+
+  ExecutableRunner* runner_;
+  const std::vector<std::vector<int64_t>> arg_dims_;
+  const std::vector<int64_t> arg_sizes_;  // Per-example elements, per arg.
+  const int64_t result_size_;
+  const Options options_;
+
+  std::atomic<Request*> head_{nullptr};
+  std::atomic<bool> shutdown_{false};
+  std::mutex wakeup_mu_;
+  std::condition_variable wakeup_cv_;
+  std::thread scheduler_thread_;
+};
+
+}  // namespace jax_cpp
+
+#endif  // JAX_EXAMPLES_JAX_CPP_BATCHER_H_
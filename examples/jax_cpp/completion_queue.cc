@@ -0,0 +1,77 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "examples/jax_cpp/completion_queue.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "xla/literal.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/shape_util.h"
+#include "xla/status.h"
+
+namespace jax_cpp {
+
+void CompletionQueue::Watch(uint64_t tag,
+                            std::unique_ptr<xla::PjRtBuffer> buffer) {
+  {
+    absl::MutexLock lock(&mu_);
+    ++pending_;
+  }
+  auto shape = buffer->logical_on_device_shape();
+  if (!shape.ok()) {
+    Push({tag, shape.status(), nullptr});
+    return;
+  }
+  auto literal = std::make_unique<xla::Literal>(
+      xla::ShapeUtil::DeviceShapeToHostShape(*shape));
+  xla::MutableLiteralBase* literal_ptr = literal.get();
+  // The callback owns the buffer and the literal: the buffer must outlive
+  // the copy, and the literal is handed to the consumer on success. `this`
+  // must outlive every watched buffer, which the destructor does not
+  // enforce — drain the queue before destroying it.
+  buffer->ToLiteral(literal_ptr)
+      .OnReady([this, tag, buffer = std::move(buffer),
+                literal = std::move(literal)](xla::Status status) mutable {
+        bool ok = status.ok();
+        Push({tag, std::move(status), ok ? std::move(literal) : nullptr});
+      });
+}
+
+CompletionQueue::Completion CompletionQueue::Next() {
+  absl::MutexLock lock(&mu_);
+  mu_.Await(absl::Condition(
+      +[](std::deque<Completion>* ready) { return !ready->empty(); },
+      &ready_));
+  Completion completion = std::move(ready_.front());
+  ready_.pop_front();
+  --pending_;
+  return completion;
+}
+
+int64_t CompletionQueue::pending() const {
+  absl::MutexLock lock(&mu_);
+  return pending_;
+}
+
+void CompletionQueue::Push(Completion completion) {
+  absl::MutexLock lock(&mu_);
+  ready_.push_back(std::move(completion));
+}
+
+}  // namespace jax_cpp
@@ -0,0 +1,70 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef JAX_EXAMPLES_JAX_CPP_COMPLETION_QUEUE_H_
+#define JAX_EXAMPLES_JAX_CPP_COMPLETION_QUEUE_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+#include "absl/synchronization/mutex.h"
+#include "xla/literal.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/status.h"
+
+namespace jax_cpp {
+
+// Event-driven retrieval of execution results. Instead of parking one thread
+// per request in ToLiteralSync, a dispatcher hands each output buffer to
+// Watch, which starts the device-to-host copy immediately and reports its
+// completion through the buffer's OnReady callback. The dispatcher keeps
+// submitting while copies are in flight and a single consumer drains Next;
+// the number of blocked threads is constant regardless of how many
+// executions are outstanding.
+class CompletionQueue {
+ public:
+  // One finished device-to-host copy. `literal` is valid iff `status` is ok.
+  struct Completion {
+    uint64_t tag;
+    xla::Status status;
+    std::unique_ptr<xla::Literal> literal;
+  };
+
+  // Takes ownership of `buffer`, starts copying it to a host literal, and
+  // queues a Completion carrying `tag` once the copy finishes. Returns
+  // immediately; safe to call from any thread, including from within an
+  // OnReady callback.
+  void Watch(uint64_t tag, std::unique_ptr<xla::PjRtBuffer> buffer);
+
+  // Blocks until a completion is available and returns the oldest one.
+  // Completions surface in the order the copies finish, not the order they
+  // were watched.
+  Completion Next();
+
+  // Number of watched buffers whose copies have not been consumed yet.
+  int64_t pending() const;
+
+ private:
+  void Push(Completion completion);
+
+  mutable absl::Mutex mu_;
+  std::deque<Completion> ready_;  // guarded by mu_
+  int64_t pending_ = 0;           // guarded by mu_
+};
+
+}  // namespace jax_cpp
+
+#endif  // JAX_EXAMPLES_JAX_CPP_COMPLETION_QUEUE_H_
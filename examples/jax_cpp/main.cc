@@ -38,16 +38,19 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
-#include "xla/literal.h"
-#include "xla/literal_util.h"
+#include "examples/jax_cpp/aot_cache.h"
+#include "examples/jax_cpp/runner.h"
 #include "xla/pjrt/cpu/cpu_client.h"
 #include "xla/pjrt/pjrt_client.h"
 #include "xla/statusor.h"
 #include "xla/tools/hlo_module_loader.h"
+#include "xla/xla_data.pb.h"
 #include "tsl/platform/init_main.h"
 #include "tsl/platform/logging.h"
+#include "tsl/platform/status.h"
 
 int main(int argc, char** argv) {
   tsl::port::InitMain("", &argc, &argv);
@@ -61,6 +64,11 @@ int main(int argc, char** argv) {
                          xla::hlo_module_loader_details::Config(),
                          config_modifier_hook)
           .value();
+  // Let the output reuse parameter 0's storage: with this alias in place,
+  // PJRT donates x's buffer to the execution instead of allocating a fresh
+  // result buffer.
+  TF_CHECK_OK(test_module->input_output_alias_config().SetUpAlias(
+      /*output_index=*/{0}, /*param_number=*/0, /*param_index=*/{}));
   const xla::HloModuleProto test_module_proto = test_module->ToProto();
 
   // Run it using JAX C++ Runtime (PJRT).
@@ -69,34 +77,36 @@ int main(int argc, char** argv) {
   std::unique_ptr<xla::PjRtClient> client =
       xla::GetTfrtCpuClient(/*asynchronous=*/true).value();
 
-  // Compile XlaComputation to PjRtExecutable.
+  // Compile XlaComputation to PjRtExecutable -- or, after the first start,
+  // deserialize the precompiled artifact instead of recompiling.
   xla::XlaComputation xla_computation(test_module_proto);
   xla::CompileOptions compile_options;
   std::unique_ptr<xla::PjRtLoadedExecutable> executable =
-      client->Compile(xla_computation, compile_options).value();
+      jax_cpp::LoadOrCompile(client.get(), xla_computation, compile_options,
+                             "/tmp/fn_hlo.pjrt")
+          .value();
+
+  jax_cpp::ExecutableRunner runner(client.get(), std::move(executable));
 
-  // Prepare inputs.
-  xla::Literal literal_x =
-      xla::LiteralUtil::CreateR2<float>({{1.0f, 2.0f}, {3.0f, 4.0f}});
-  xla::Literal literal_y =
-      xla::LiteralUtil::CreateR2<float>({{1.0f, 1.0f}, {1.0f, 1.0f}});
+  // Prepare inputs straight from host arrays; no literals are materialized.
+  // x is donatable (its parameter is aliased with the output above), y is
+  // wrapped zero-copy and must outlive the buffers of this call.
+  float x[4] = {1.0f, 2.0f, 3.0f, 4.0f};
+  float y[4] = {1.0f, 1.0f, 1.0f, 1.0f};
   std::unique_ptr<xla::PjRtBuffer> param_x =
-      client->BufferFromHostLiteral(literal_x, client->addressable_devices()[0])
-          .value();
+      runner.WrapHostBuffer(x, xla::F32, {2, 2}, /*donatable=*/true).value();
   std::unique_ptr<xla::PjRtBuffer> param_y =
-      client->BufferFromHostLiteral(literal_y, client->addressable_devices()[0])
-          .value();
+      runner.WrapHostBuffer(y, xla::F32, {2, 2}, /*donatable=*/false).value();
 
-  // Execute on CPU.
-  xla::ExecuteOptions execute_options;
-  // One vector<buffer> for each device.
-  std::vector<std::vector<std::unique_ptr<xla::PjRtBuffer>>> results =
-      executable->Execute({{param_x.get(), param_y.get()}}, execute_options)
-          .value();
+  // Execute on CPU. param_x is donated by the call and must not be reused.
+  std::vector<std::unique_ptr<xla::PjRtBuffer>> results =
+      runner.Run({param_x.get(), param_y.get()}).value();
 
-  // Get result.
-  std::shared_ptr<xla::Literal> result_literal =
-      results[0][0]->ToLiteralSync().value();
-  LOG(INFO) << "result = " << *result_literal;
+  // Read the result in place instead of copying it into a literal.
+  auto [reference, data] =
+      jax_cpp::ExecutableRunner::MapOutput(results[0].get()).value();
+  const float* result = static_cast<const float*>(data);
+  LOG(INFO) << "result = { " << result[0] << ", " << result[1] << ", "
+            << result[2] << ", " << result[3] << " }";
   return 0;
 }
@@ -0,0 +1,72 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "examples/jax_cpp/runner.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/statusor.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
+
+namespace jax_cpp {
+
+ExecutableRunner::ExecutableRunner(
+    xla::PjRtClient* client,
+    std::unique_ptr<xla::PjRtLoadedExecutable> executable)
+    : client_(client), executable_(std::move(executable)) {}
+
+xla::StatusOr<std::unique_ptr<xla::PjRtBuffer>>
+ExecutableRunner::WrapHostBuffer(const void* data, xla::PrimitiveType type,
+                                 absl::Span<const int64_t> dims,
+                                 bool donatable) {
+  // Donated buffers may have their storage handed over to an output, so they
+  // cannot alias immutable caller memory; everything else can.
+  auto semantics =
+      donatable ? xla::PjRtClient::HostBufferSemantics::
+                      kImmutableUntilTransferCompletes
+                : xla::PjRtClient::HostBufferSemantics::kImmutableZeroCopy;
+  return client_->BufferFromHostBuffer(
+      data, type, dims, /*byte_strides=*/std::nullopt, semantics,
+      /*on_done_with_host_buffer=*/nullptr, client_->addressable_devices()[0]);
+}
+
+xla::StatusOr<std::vector<std::unique_ptr<xla::PjRtBuffer>>>
+ExecutableRunner::Run(absl::Span<xla::PjRtBuffer* const> args) {
+  xla::ExecuteOptions options;
+  // Hand each output back as its own buffer; a tuple-shaped result could
+  // only be read through a literal copy.
+  options.untuple_result = true;
+  std::vector<xla::PjRtBuffer*> arg_ptrs(args.begin(), args.end());
+  TF_ASSIGN_OR_RETURN(auto results, executable_->Execute({arg_ptrs}, options));
+  return std::move(results[0]);
+}
+
+xla::StatusOr<std::pair<std::unique_ptr<xla::PjRtBuffer::ExternalReference>,
+                        const void*>>
+ExecutableRunner::MapOutput(xla::PjRtBuffer* buffer) {
+  TF_RETURN_IF_ERROR(buffer->GetReadyFuture().Await());
+  TF_ASSIGN_OR_RETURN(auto reference, buffer->AcquireExternalReference());
+  const void* data = reference->OpaqueDeviceMemoryDataPointer();
+  return std::make_pair(std::move(reference), data);
+}
+
+}  // namespace jax_cpp
@@ -0,0 +1,75 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef JAX_EXAMPLES_JAX_CPP_RUNNER_H_
+#define JAX_EXAMPLES_JAX_CPP_RUNNER_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/statusor.h"
+#include "xla/xla_data.pb.h"
+
+namespace jax_cpp {
+
+// A small reusable runtime around one PjRtLoadedExecutable. It avoids the
+// copy-everything pattern of going through xla::Literal on both ends of each
+// call:
+//  - inputs wrap caller-owned host memory (zero copy on the CPU client)
+//    instead of being copied out of literals;
+//  - parameters marked for donation in the module's input/output alias config
+//    let XLA reuse their storage for outputs;
+//  - outputs are read in place through PjRtBuffer external references instead
+//    of ToLiteralSync round trips.
+class ExecutableRunner {
+ public:
+  ExecutableRunner(xla::PjRtClient* client,
+                   std::unique_ptr<xla::PjRtLoadedExecutable> executable);
+
+  // Wraps caller-owned host memory as a parameter buffer. If `donatable` is
+  // false, the buffer aliases `data` directly and `data` must stay alive and
+  // unmodified for the lifetime of the returned buffer. If `donatable` is
+  // true, one staging copy is made, so the buffer's storage can be handed
+  // over to an output when the corresponding parameter is donated.
+  xla::StatusOr<std::unique_ptr<xla::PjRtBuffer>> WrapHostBuffer(
+      const void* data, xla::PrimitiveType type, absl::Span<const int64_t> dims,
+      bool donatable);
+
+  // Runs the executable on the first addressable device and returns one
+  // buffer per output. Buffers passed for donated parameters are invalidated
+  // by the call.
+  xla::StatusOr<std::vector<std::unique_ptr<xla::PjRtBuffer>>> Run(
+      absl::Span<xla::PjRtBuffer* const> args);
+
+  // Waits for `buffer` and maps its contents into host memory without
+  // copying (the CPU client's device memory is host memory). The pointer
+  // stays valid for as long as the returned external reference is held.
+  static xla::StatusOr<
+      std::pair<std::unique_ptr<xla::PjRtBuffer::ExternalReference>,
+                const void*>>
+  MapOutput(xla::PjRtBuffer* buffer);
+
+ private:
+  xla::PjRtClient* client_;
+  std::unique_ptr<xla::PjRtLoadedExecutable> executable_;
+};
+
+}  // namespace jax_cpp
+
+#endif  // JAX_EXAMPLES_JAX_CPP_RUNNER_H_
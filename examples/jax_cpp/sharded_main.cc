@@ -0,0 +1,98 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Demonstrates data-parallel execution of one computation across several
+// devices with the jax_cpp sharded runner. Uses the same HloModule as
+// main.cc:
+//
+// $ python3 jax/tools/jax_to_hlo.py \
+// --fn examples.jax_cpp.prog.fn \
+// --input_shapes '[("x", "f32[2,2]"), ("y", "f32[2,2]")]' \
+// --constants '{"z": 2.0}' \
+// --hlo_text_dest /tmp/fn_hlo.txt
+//
+// $ bazel build examples/jax_cpp:sharded_main --experimental_repo_remote_exec \
+//    --check_visibility=false
+// $ bazel-bin/examples/jax_cpp/sharded_main
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "examples/jax_cpp/runner.h"
+#include "examples/jax_cpp/sharded_runner.h"
+#include "xla/pjrt/cpu/cpu_client.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/statusor.h"
+#include "xla/tools/hlo_module_loader.h"
+#include "tsl/platform/init_main.h"
+#include "tsl/platform/logging.h"
+
+int main(int argc, char** argv) {
+  tsl::port::InitMain("", &argc, &argv);
+
+  std::string hlo_filename = "/tmp/fn_hlo.txt";
+  std::function<void(xla::HloModuleConfig*)> config_modifier_hook =
+      [](xla::HloModuleConfig* config) { config->set_seed(42); };
+  std::unique_ptr<xla::HloModule> test_module =
+      LoadModuleFromFile(hlo_filename, /*format=*/"txt",
+                         xla::hlo_module_loader_details::Config(),
+                         config_modifier_hook)
+          .value();
+  const xla::HloModuleProto test_module_proto = test_module->ToProto();
+
+  // The CPU client exposes one device per core by default; ask for four so
+  // the demo shards even on small machines.
+  std::unique_ptr<xla::PjRtClient> client =
+      xla::GetTfrtCpuClient(/*asynchronous=*/true, /*cpu_device_count=*/4)
+          .value();
+  xla::XlaComputation xla_computation(test_module_proto);
+  std::unique_ptr<jax_cpp::ShardedRunner> runner =
+      jax_cpp::ShardedRunner::Create(client.get(), xla_computation).value();
+  LOG(INFO) << "sharding across " << runner->num_devices() << " devices";
+
+  // One full batch: one request per device, staged before any execution.
+  std::vector<std::vector<float>> xs(runner->num_devices());
+  std::vector<float> y = {1.0f, 1.0f, 1.0f, 1.0f};
+  std::vector<std::vector<jax_cpp::ShardedRunner::HostInput>> requests;
+  for (int i = 0; i < runner->num_devices(); ++i) {
+    float v = static_cast<float>(i + 1);
+    xs[i] = {v, v, v, v};
+    requests.push_back({{xs[i].data(), xla::F32, {2, 2}},
+                        {y.data(), xla::F32, {2, 2}}});
+  }
+  auto results = runner->RunBatch(requests).value();
+
+  for (int i = 0; i < runner->num_devices(); ++i) {
+    auto [reference, data] =
+        jax_cpp::ExecutableRunner::MapOutput(results[i][0].get()).value();
+    const float* row = static_cast<const float*>(data);
+    LOG(INFO) << "result[" << i << "] = { " << row[0] << ", " << row[1]
+              << ", " << row[2] << ", " << row[3] << " }";
+  }
+
+  // Single requests land on successive devices round-robin.
+  std::vector<float> x = {5.0f, 5.0f, 5.0f, 5.0f};
+  auto one = runner
+                 ->RunOne({{x.data(), xla::F32, {2, 2}},
+                           {y.data(), xla::F32, {2, 2}}})
+                 .value();
+  auto [reference, data] =
+      jax_cpp::ExecutableRunner::MapOutput(one[0].get()).value();
+  const float* row = static_cast<const float*>(data);
+  LOG(INFO) << "single result = { " << row[0] << ", " << row[1] << ", "
+            << row[2] << ", " << row[3] << " }";
+  return 0;
+}
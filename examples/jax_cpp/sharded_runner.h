@@ -0,0 +1,91 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef JAX_EXAMPLES_JAX_CPP_SHARDED_RUNNER_H_
+#define JAX_EXAMPLES_JAX_CPP_SHARDED_RUNNER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "xla/client/xla_computation.h"
+#include "xla/pjrt/pjrt_client.h"
+#include "xla/statusor.h"
+#include "xla/xla_data.pb.h"
+
+namespace jax_cpp {
+
+// Data-parallel execution of one computation across all addressable devices.
+//
+// The executable is compiled with one replica per local device, so the same
+// program is resident everywhere and each device can serve requests
+// independently. The helper owns the two parts of the multi-device buffer
+// lifecycle that are easy to get wrong:
+//  - every input buffer is staged on the device that will execute with it
+//    (PjRt rejects cross-device arguments rather than transferring them);
+//  - staging is issued for all requests of a batch before any execution is
+//    dispatched, so the host-to-device copies overlap with each other and
+//    with the executions already in flight.
+class ShardedRunner {
+ public:
+  // One host-side argument. The memory only needs to stay alive until the
+  // staging copy completes, which Create's client guarantees internally
+  // (kImmutableUntilTransferCompletes semantics).
+  struct HostInput {
+    const void* data;
+    xla::PrimitiveType type;
+    std::vector<int64_t> dims;
+  };
+
+  // Compiles `computation` with num_replicas equal to the number of
+  // addressable devices, using the default device assignment.
+  static xla::StatusOr<std::unique_ptr<ShardedRunner>> Create(
+      xla::PjRtClient* client, const xla::XlaComputation& computation);
+
+  int num_devices() const { return static_cast<int>(devices_.size()); }
+
+  // Runs one request on the next device in round-robin order and returns one
+  // buffer per output. Thread-safe; concurrent callers land on different
+  // devices.
+  xla::StatusOr<std::vector<std::unique_ptr<xla::PjRtBuffer>>> RunOne(
+      absl::Span<const HostInput> inputs);
+
+  // Runs up to num_devices() requests, one per device, and returns one
+  // result vector per request (in request order). All input staging is
+  // issued before the first execution is dispatched. When the batch fills
+  // every device, the executions go down as a single replicated Execute
+  // call; a partial batch is dispatched device by device.
+  xla::StatusOr<std::vector<std::vector<std::unique_ptr<xla::PjRtBuffer>>>>
+  RunBatch(absl::Span<const std::vector<HostInput>> requests);
+
+ private:
+  ShardedRunner(xla::PjRtClient* client,
+                std::unique_ptr<xla::PjRtLoadedExecutable> executable);
+
+  // Starts the asynchronous host-to-device copies for one request's inputs.
+  xla::StatusOr<std::vector<std::unique_ptr<xla::PjRtBuffer>>> StageInputs(
+      absl::Span<const HostInput> inputs, xla::PjRtDevice* device);
+
+  xla::PjRtClient* client_;
+  std::unique_ptr<xla::PjRtLoadedExecutable> executable_;
+  std::vector<xla::PjRtDevice*> devices_;
+  std::atomic<uint64_t> next_device_{0};
+};
+
+}  // namespace jax_cpp
+
+#endif  // JAX_EXAMPLES_JAX_CPP_SHARDED_RUNNER_H_
@@ -419,7 +419,47 @@ def _source_info_to_location(
 
 upstream_dialects = ir.DialectRegistry()
 if register_jax_dialects:
-  register_jax_dialects.register_dialects(upstream_dialects)
+  if hasattr(register_jax_dialects, "register_tracing_dialects"):
+    # Dialect and pass registration is split into groups so that the hot
+    # `import jax` path only registers what tracing needs. The Mosaic
+    # lowering paths trigger the remaining groups on first use via the
+    # functions below.
+    register_jax_dialects.register_tracing_dialects(upstream_dialects)
+  else:  # Older jaxlib only has the eager all-in-one entry point.
+    register_jax_dialects.register_dialects(upstream_dialects)
+
+_transforms_passes_registered = False
+
+def register_transforms_passes() -> None:
+  """Registers the upstream MLIR transforms passes (canonicalize, cse, ...).
+
+  Deferred from import time since only the Mosaic pipelines run these passes.
+  Idempotent; pass registration is process-global.
+  """
+  global _transforms_passes_registered
+  if _transforms_passes_registered or not register_jax_dialects:
+    return
+  _transforms_passes_registered = True
+  if hasattr(register_jax_dialects, "register_transforms_passes"):
+    register_jax_dialects.register_transforms_passes()
+  # Older jaxlib registered them eagerly in register_dialects.
+
+_mosaic_gpu_dialects_registered = False
+
+def register_mosaic_gpu_dialects() -> None:
+  """Registers the dialects Mosaic GPU lowers through (gpu, nvgpu, nvvm, llvm).
+
+  Deferred from import time so that CPU-only processes never pay for them.
+  Only affects contexts created after the call, so it must run before the
+  kernel's context is built (importing jax.experimental.mosaic.gpu does this).
+  """
+  global _mosaic_gpu_dialects_registered
+  if _mosaic_gpu_dialects_registered or not register_jax_dialects:
+    return
+  _mosaic_gpu_dialects_registered = True
+  if hasattr(register_jax_dialects, "register_mosaic_gpu_dialects"):
+    register_jax_dialects.register_mosaic_gpu_dialects(upstream_dialects)
+  register_transforms_passes()
 
 # Dumping MLIR modules
 _ir_dump_counter = itertools.count()
@@ -19,6 +19,7 @@ from __future__ import annotations
 
 import base64
 import collections.abc
+import contextlib
 import dataclasses
 import functools
 import io
@@ -264,6 +265,43 @@ mlir.register_lowering(tpu_custom_call_p, _tpu_custom_call_lowering,
                        platform="tpu")
 
 
+# Wall-clock seconds spent in each stage of the most recent Mosaic lowering,
+# keyed by the stage names also used for MLIR dumps. Complements the op and
+# relayout counters exposed by tpu.compile_stats().
+_mosaic_stage_timings: dict[str, float] = {}
+
+
+def get_mosaic_stage_timings() -> dict[str, float]:
+  """Returns per-stage timings of the most recent Mosaic lowering, in seconds."""
+  return dict(_mosaic_stage_timings)
+
+
+def _run_stage(pipeline: PassManager, module: ir.Module, name: str):
+  """Runs a pipeline stage on the module, recording its wall time and dump."""
+  start = time.perf_counter()
+  pipeline.run(module.operation)
+  _mosaic_stage_timings[name] = time.perf_counter() - start
+  dump_mlir(module, name)
+
+
+@contextlib.contextmanager
+def _passmanager_multithreading(ctx: ir.Context):
+  """Temporarily enables MLIR threading on the given context.
+
+  JAX creates its MLIR contexts with threading disabled, since contexts are
+  cached and each live thread pool would otherwise pin several threads (see
+  mlir.make_ir_context). The Mosaic layout passes all run on func.func though,
+  so with threading enabled the pass manager fans independent functions out
+  across cores. Enable it just for the duration of the pipeline; disabling it
+  again drops the thread pool.
+  """
+  ctx.enable_multithreading(True)
+  try:
+    yield
+  finally:
+    ctx.enable_multithreading(False)
+
+
 def _lower_tpu_kernel(
     module: ir.Module,
     hardware_generation: int,
@@ -290,75 +328,73 @@ def _lower_tpu_kernel(
     tpu.register_dialect(ctx)
     mhlo.register_mhlo_dialect(ctx)
     mhlo.register_mhlo_passes()
+    # The upstream transforms passes (canonicalize, cse) are registered
+    # lazily, since most processes never run this pipeline.
+    mlir.register_transforms_passes()
 
     dump_mlir(module, "original")
+    _mosaic_stage_timings.clear()
+
+    with _passmanager_multithreading(ctx):
+      if _MOSAIC_ALLOW_HLO.value:
+        # Run hlo dialect conversion: hlo -> linalg -> vector.
+        pipeline = [
+            "hlo-legalize-to-arithmetic",
+            "func.func(hlo-legalize-to-linalg)",
+            "func.func(linalg-vectorization)",
+        ]
+        pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
+        _run_stage(pipeline, module, "post-hlo-conversion")
 
-    if _MOSAIC_ALLOW_HLO.value:
-      # Run hlo dialect conversion: hlo -> linalg -> vector.
       pipeline = [
-          "hlo-legalize-to-arithmetic",
-          "func.func(hlo-legalize-to-linalg)",
-          "func.func(linalg-vectorization)",
+          f"func.func(tpu-infer-memref-layout{{hardware-generation={hardware_generation}}})"
       ]
       pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
-      pipeline.run(module.operation)
-      dump_mlir(module, "post-hlo-conversion")
-
-    pipeline = [
-        f"func.func(tpu-infer-memref-layout{{hardware-generation={hardware_generation}}})"
-    ]
-    pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
-    pipeline.run(module.operation)
-    dump_mlir(module, "post-infer-memref-layout")
-
-    pipeline = [
-        "canonicalize",
-        "cse",
-    ]
-    pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
-    pipeline.run(module.operation)
-    dump_mlir(module, "post-simplify")
+      _run_stage(pipeline, module, "post-infer-memref-layout")
 
-    try:
-      on_device_checks = FLAGS["xla_mosaic_on_device_checks"].value
-    except KeyError:
-      on_device_checks = False
-
-    if checks := on_device_checks:
-      checks = set(checks.split(","))
-      if checks == {"bounds"}:  # We only support one kind of checks now.
-        pipeline = PassManager.parse(
-            "builtin.module(func.func(debug-assert-insertion))"
-        )
-        pipeline.run(module.operation)
-        dump_mlir(module, "post-assert-insertion")
-      elif checks:
-        checks.discard("bounds")
-        raise ValueError(
-            f"Unrecognized on-device check categories: {', '.join(checks)}"
-        )
+      pipeline = [
+          "canonicalize",
+          "cse",
+      ]
+      pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
+      _run_stage(pipeline, module, "post-simplify")
+
+      try:
+        on_device_checks = FLAGS["xla_mosaic_on_device_checks"].value
+      except KeyError:
+        on_device_checks = False
+
+      if checks := on_device_checks:
+        checks = set(checks.split(","))
+        if checks == {"bounds"}:  # We only support one kind of checks now.
+          pipeline = PassManager.parse(
+              "builtin.module(func.func(debug-assert-insertion))"
+          )
+          _run_stage(pipeline, module, "post-assert-insertion")
+        elif checks:
+          checks.discard("bounds")
+          raise ValueError(
+              f"Unrecognized on-device check categories: {', '.join(checks)}"
+          )
+
+      pipeline = [
+          "func.func(tpu-infer-vector-layout{sublane-count=8 lane-count=128})",
+      ]
+      pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
+      _run_stage(pipeline, module, "post-infer-vector-layout")
+
+      mxu_size = 128 if hardware_generation < 6 else 256
+      pipeline = [
+          "func.func(tpu-apply-vector-layout{sublane-count=8 lane-count=128"
+          f" hardware-generation={hardware_generation}"
+          f" mxu-contracting-size={mxu_size} mxu-noncontracting-size={mxu_size}"
+          "})"
+      ]
+      pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
+      _run_stage(pipeline, module, "post-apply-vector-layout")
 
-    pipeline = [
-        "func.func(tpu-infer-vector-layout{sublane-count=8 lane-count=128})",
-    ]
-    pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
-    pipeline.run(module.operation)
-    dump_mlir(module, "post-infer-vector-layout")
-
-    mxu_size = 128 if hardware_generation < 6 else 256
-    pipeline = [
-        "func.func(tpu-apply-vector-layout{sublane-count=8 lane-count=128"
-        f" hardware-generation={hardware_generation}"
-        f" mxu-contracting-size={mxu_size} mxu-noncontracting-size={mxu_size}"
-        "})"
-    ]
-    pipeline = PassManager.parse(f"builtin.module({','.join(pipeline)})")
-    pipeline.run(module.operation)
-    dump_mlir(module, "post-apply-vector-layout")
-
-    pipeline = PassManager.parse("builtin.module(canonicalize)")
-    pipeline.run(module.operation)
-    dump_mlir(module, "pre-lower-to-llo")
+      pipeline = PassManager.parse("builtin.module(canonicalize)")
+      _run_stage(pipeline, module, "pre-lower-to-llo")
 
     return module
 
@@ -91,6 +91,14 @@ if TYPE_CHECKING:
 else:
   safe_map = jaxlib_utils.safe_map
 
+if not TYPE_CHECKING and hasattr(jaxlib_utils, "safe_map_tuple"):
+  safe_map_tuple = jaxlib_utils.safe_map_tuple
+else:
+  def safe_map_tuple(f: Callable[..., T], *args: Iterable[Any]
+                     ) -> tuple[T, ...]:
+    """Like safe_map, but returns a tuple instead of a list."""
+    return tuple(safe_map(f, *args))
+
 def unzip2(xys: Iterable[tuple[T1, T2]]
     ) -> tuple[tuple[T1, ...], tuple[T2, ...]]:
   """Unzip sequence of length-2 tuples into two tuples."""
@@ -103,6 +111,9 @@ def unzip2(xys: Iterable[tuple[T1, T2]]
     ys.append(y)
   return tuple(xs), tuple(ys)
 
+if not TYPE_CHECKING and hasattr(jaxlib_utils, "unzip2"):
+  unzip2 = jaxlib_utils.unzip2
+
 def unzip3(xyzs: Iterable[tuple[T1, T2, T3]]
     ) -> tuple[tuple[T1, ...], tuple[T2, ...], tuple[T3, ...]]:
   """Unzip sequence of length-3 tuples into three tuples."""
@@ -117,6 +128,9 @@ def unzip3(xyzs: Iterable[tuple[T1, T2, T3]]
     zs.append(z)
   return tuple(xs), tuple(ys), tuple(zs)
 
+if not TYPE_CHECKING and hasattr(jaxlib_utils, "unzip3"):
+  unzip3 = jaxlib_utils.unzip3
+
 def subvals(lst, replace):
   lst = list(lst)
   for i, v in replace:
@@ -67,6 +67,11 @@ TMA_DESCRIPTOR_ALIGNMENT = 64
 
 c = mgpu.c  # This is too common to fully qualify.
 
+# The GPU-side dialects (gpu, nvgpu, nvvm, llvm) are registered lazily so that
+# processes that never import this module do not pay for them. This must run
+# before any context that lowers a Mosaic GPU kernel is created.
+mlir.register_mosaic_gpu_dialects()
+
 
 RUNTIME_PATH = pathlib.Path(mosaic_gpu_lib._mosaic_gpu_ext.__file__).parent / "libmosaic_gpu_runtime.so"
 if RUNTIME_PATH.exists():
@@ -98,8 +103,10 @@ def _mosaic_gpu_lowering_rule(ctx, *args, module, out_types, gmem_scratch_bytes)
           ),
       ],
       operands=args,
-      backend_config=idx_bytes
-      + module.operation.get_asm(binary=True, enable_debug_info=True),
+      # Bytecode is much faster to parse on the first kernel launch than
+      # textual IR, and is considerably smaller inside the serialized
+      # executable.
+      backend_config=idx_bytes + mlir.module_to_bytecode(module),
   )
   return op.results[:-1]  # Skip the scratch space.
 
@@ -16,7 +16,10 @@ limitations under the License.
 #ifndef JAXLIB_ABSL_STATUS_CASTERS_H_
 #define JAXLIB_ABSL_STATUS_CASTERS_H_
 
+#include <Python.h>
+
 #include <stdexcept>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -137,6 +140,112 @@ struct ThrowIfErrorWrapper<absl::Status(Args...) const, C> {
   absl::Status (C::*ptmf)(Args...) const;
 };
 
+// GIL-releasing variants.
+//
+// The wrappers above invoke the wrapped function while still holding the
+// GIL, so a long-running native call (a Triton or Mosaic compile, say)
+// blocks every other Python thread for its full duration. The NoGil
+// variants below release the GIL before the native call and reacquire it
+// before a failing status is translated into an exception.
+//
+// The wrapped function runs without the GIL: it must not touch Python state,
+// and in particular the binding must use plain C++ argument and return types
+// (std::string rather than nb::bytes, etc.) so all conversions happen in the
+// binding layer while the GIL is still held.
+
+// Releases the GIL for the duration of a scope via the raw CPython API, so
+// this header stays independent of the binding framework (it is included
+// from both nanobind and pybind11 extensions).
+class ScopedGilRelease {
+ public:
+  ScopedGilRelease() : tstate_(PyEval_SaveThread()) {}
+  ~ScopedGilRelease() { PyEval_RestoreThread(tstate_); }
+  ScopedGilRelease(const ScopedGilRelease&) = delete;
+  ScopedGilRelease& operator=(const ScopedGilRelease&) = delete;
+
+ private:
+  PyThreadState* tstate_;
+};
+
+// GIL-releasing counterpart of `ThrowIfErrorWrapper`, with the same three
+// specializations and deduction guides.
+template <typename Sig, typename F>
+struct ThrowIfErrorNoGilWrapper;
+
+template <typename F>
+ThrowIfErrorNoGilWrapper(F)
+    -> ThrowIfErrorNoGilWrapper<decltype(&F::operator()), F>;
+
+template <typename... Args>
+ThrowIfErrorNoGilWrapper(absl::Status (&)(Args...))
+    -> ThrowIfErrorNoGilWrapper<absl::Status(Args...),
+                                absl::Status (&)(Args...)>;
+
+template <typename C, typename... Args>
+ThrowIfErrorNoGilWrapper(absl::Status (C::*)(Args...))
+    -> ThrowIfErrorNoGilWrapper<absl::Status(Args...), C>;
+
+template <typename... Args>
+struct ThrowIfErrorNoGilWrapper<absl::Status(Args...),
+                                absl::Status (&)(Args...)> {
+  explicit ThrowIfErrorNoGilWrapper(absl::Status (&f)(Args...)) : func(f) {}
+  void operator()(Args... args) {
+    ThrowIfError([&] {
+      ScopedGilRelease release;
+      return func(std::forward<Args>(args)...);
+    }());
+  }
+  absl::Status (&func)(Args...);
+};
+
+template <typename C, typename... Args, typename F>
+struct ThrowIfErrorNoGilWrapper<absl::Status (C::*)(Args...), F> {
+  explicit ThrowIfErrorNoGilWrapper(F&& f) : func(std::move(f)) {}
+  void operator()(Args... args) {
+    ThrowIfError([&] {
+      ScopedGilRelease release;
+      return func(std::forward<Args>(args)...);
+    }());
+  }
+  F func;
+};
+template <typename C, typename... Args, typename F>
+struct ThrowIfErrorNoGilWrapper<absl::Status (C::*)(Args...) const, F> {
+  explicit ThrowIfErrorNoGilWrapper(F&& f) : func(std::move(f)) {}
+  void operator()(Args... args) const {
+    ThrowIfError([&] {
+      ScopedGilRelease release;
+      return func(std::forward<Args>(args)...);
+    }());
+  }
+  F func;
+};
+
+template <typename C, typename... Args>
+struct ThrowIfErrorNoGilWrapper<absl::Status(Args...), C> {
+  explicit ThrowIfErrorNoGilWrapper(absl::Status (C::*ptmf)(Args...))
+      : ptmf(ptmf) {}
+  void operator()(C& instance, Args... args) {
+    ThrowIfError([&] {
+      ScopedGilRelease release;
+      return (instance.*ptmf)(std::forward<Args>(args)...);
+    }());
+  }
+  absl::Status (C::*ptmf)(Args...);
+};
+template <typename C, typename... Args>
+struct ThrowIfErrorNoGilWrapper<absl::Status(Args...) const, C> {
+  explicit ThrowIfErrorNoGilWrapper(absl::Status (C::*ptmf)(Args...) const)
+      : ptmf(ptmf) {}
+  void operator()(const C& instance, Args... args) const {
+    ThrowIfError([&] {
+      ScopedGilRelease release;
+      return (instance.*ptmf)(std::forward<Args>(args)...);
+    }());
+  }
+  absl::Status (C::*ptmf)(Args...) const;
+};
+
 // Utilities for `StatusOr`.
 template <typename T>
 T ValueOrThrow(absl::StatusOr<T> v) {
@@ -213,6 +322,90 @@ struct ValueOrThrowWrapper<absl::StatusOr<R>(Args...) const, C> {
   absl::StatusOr<R> (C::*ptmf)(Args...) const;
 };
 
+// GIL-releasing counterpart of `ValueOrThrowWrapper`; see the NoGil notes
+// above for the constraints on the wrapped function.
+template <typename Sig, typename F>
+struct ValueOrThrowNoGilWrapper;
+
+template <typename F>
+ValueOrThrowNoGilWrapper(F)
+    -> ValueOrThrowNoGilWrapper<decltype(&F::operator()), F>;
+
+template <typename R, typename... Args>
+ValueOrThrowNoGilWrapper(absl::StatusOr<R> (&)(Args...))
+    -> ValueOrThrowNoGilWrapper<absl::StatusOr<R>(Args...),
+                                absl::StatusOr<R> (&)(Args...)>;
+
+template <typename C, typename R, typename... Args>
+ValueOrThrowNoGilWrapper(absl::StatusOr<R> (C::*)(Args...))
+    -> ValueOrThrowNoGilWrapper<absl::StatusOr<R>(Args...), C>;
+
+template <typename C, typename R, typename... Args>
+ValueOrThrowNoGilWrapper(absl::StatusOr<R> (C::*)(Args...) const)
+    -> ValueOrThrowNoGilWrapper<absl::StatusOr<R>(Args...) const, C>;
+
+template <typename R, typename... Args>
+struct ValueOrThrowNoGilWrapper<absl::StatusOr<R>(Args...),
+                                absl::StatusOr<R> (&)(Args...)> {
+  explicit ValueOrThrowNoGilWrapper(absl::StatusOr<R> (&f)(Args...))
+      : func(f) {}
+  R operator()(Args... args) const {
+    return ValueOrThrow([&] {
+      ScopedGilRelease release;
+      return func(std::forward<Args>(args)...);
+    }());
+  }
+  absl::StatusOr<R> (&func)(Args...);
+};
+template <typename R, typename C, typename... Args, typename F>
+struct ValueOrThrowNoGilWrapper<absl::StatusOr<R> (C::*)(Args...), F> {
+  explicit ValueOrThrowNoGilWrapper(F&& f) : func(std::move(f)) {}
+  R operator()(Args... args) const {
+    return ValueOrThrow([&] {
+      ScopedGilRelease release;
+      return func(std::forward<Args>(args)...);
+    }());
+  }
+  F func;
+};
+template <typename R, typename C, typename... Args, typename F>
+struct ValueOrThrowNoGilWrapper<absl::StatusOr<R> (C::*)(Args...) const, F> {
+  explicit ValueOrThrowNoGilWrapper(F&& f) : func(std::move(f)) {}
+  R operator()(Args... args) const {
+    return ValueOrThrow([&] {
+      ScopedGilRelease release;
+      return func(std::forward<Args>(args)...);
+    }());
+  }
+  F func;
+};
+
+template <typename R, typename C, typename... Args>
+struct ValueOrThrowNoGilWrapper<absl::StatusOr<R>(Args...), C> {
+  explicit ValueOrThrowNoGilWrapper(absl::StatusOr<R> (C::*ptmf)(Args...))
+      : ptmf(ptmf) {}
+  R operator()(C& instance, Args... args) {
+    return ValueOrThrow([&] {
+      ScopedGilRelease release;
+      return (instance.*ptmf)(std::forward<Args>(args)...);
+    }());
+  }
+  absl::StatusOr<R> (C::*ptmf)(Args...);
+};
+template <typename R, typename C, typename... Args>
+struct ValueOrThrowNoGilWrapper<absl::StatusOr<R>(Args...) const, C> {
+  explicit ValueOrThrowNoGilWrapper(absl::StatusOr<R> (C::*ptmf)(Args...)
+                                        const)
+      : ptmf(ptmf) {}
+  R operator()(const C& instance, Args... args) const {
+    return ValueOrThrow([&] {
+      ScopedGilRelease release;
+      return (instance.*ptmf)(std::forward<Args>(args)...);
+    }());
+  }
+  absl::StatusOr<R> (C::*ptmf)(Args...) const;
+};
+
 }  // namespace jax
 
 #endif  // JAXLIB_ABSL_STATUS_CASTERS_H_
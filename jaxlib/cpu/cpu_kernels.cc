@@ -53,6 +53,16 @@ XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_cgetrf",
 XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_zgetrf",
                                          Getrf<std::complex<double>>::Kernel,
                                          "Host");
+XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_sgetrs", Getrs<float>::Kernel,
+                                         "Host");
+XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_dgetrs", Getrs<double>::Kernel,
+                                         "Host");
+XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_cgetrs",
+                                         Getrs<std::complex<float>>::Kernel,
+                                         "Host");
+XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_zgetrs",
+                                         Getrs<std::complex<double>>::Kernel,
+                                         "Host");
 XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_sgeqrf", Geqrf<float>::Kernel,
                                          "Host");
 XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("lapack_dgeqrf", Geqrf<double>::Kernel,
@@ -122,6 +132,10 @@ JAX_CPU_REGISTER_HANDLER(lapack_spotrf_ffi);
 JAX_CPU_REGISTER_HANDLER(lapack_dpotrf_ffi);
 JAX_CPU_REGISTER_HANDLER(lapack_cpotrf_ffi);
 JAX_CPU_REGISTER_HANDLER(lapack_zpotrf_ffi);
+JAX_CPU_REGISTER_HANDLER(lapack_sgetrf_ffi);
+JAX_CPU_REGISTER_HANDLER(lapack_dgetrf_ffi);
+JAX_CPU_REGISTER_HANDLER(lapack_cgetrf_ffi);
+JAX_CPU_REGISTER_HANDLER(lapack_zgetrf_ffi);
 
 #undef JAX_CPU_REGISTER_HANDLER
 
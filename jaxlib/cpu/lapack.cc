@@ -55,6 +55,15 @@ void GetLapackKernelsFromScipy() {
   AssignKernelFn<Getrf<double>>(lapack_ptr("dgetrf"));
   AssignKernelFn<Getrf<std::complex<float>>>(lapack_ptr("cgetrf"));
   AssignKernelFn<Getrf<std::complex<double>>>(lapack_ptr("zgetrf"));
+  AssignKernelFn<LuDecomposition<DataType::F32>>(lapack_ptr("sgetrf"));
+  AssignKernelFn<LuDecomposition<DataType::F64>>(lapack_ptr("dgetrf"));
+  AssignKernelFn<LuDecomposition<DataType::C64>>(lapack_ptr("cgetrf"));
+  AssignKernelFn<LuDecomposition<DataType::C128>>(lapack_ptr("zgetrf"));
+
+  AssignKernelFn<Getrs<float>>(lapack_ptr("sgetrs"));
+  AssignKernelFn<Getrs<double>>(lapack_ptr("dgetrs"));
+  AssignKernelFn<Getrs<std::complex<float>>>(lapack_ptr("cgetrs"));
+  AssignKernelFn<Getrs<std::complex<double>>>(lapack_ptr("zgetrs"));
 
   AssignKernelFn<Geqrf<float>>(lapack_ptr("sgeqrf"));
   AssignKernelFn<Geqrf<double>>(lapack_ptr("dgeqrf"));
@@ -120,6 +129,12 @@ nb::dict Registrations() {
       EncapsulateFunction(Getrf<std::complex<float>>::Kernel);
   dict["lapack_zgetrf"] =
       EncapsulateFunction(Getrf<std::complex<double>>::Kernel);
+  dict["lapack_sgetrs"] = EncapsulateFunction(Getrs<float>::Kernel);
+  dict["lapack_dgetrs"] = EncapsulateFunction(Getrs<double>::Kernel);
+  dict["lapack_cgetrs"] =
+      EncapsulateFunction(Getrs<std::complex<float>>::Kernel);
+  dict["lapack_zgetrs"] =
+      EncapsulateFunction(Getrs<std::complex<double>>::Kernel);
   dict["lapack_sgeqrf"] = EncapsulateFunction(Geqrf<float>::Kernel);
   dict["lapack_dgeqrf"] = EncapsulateFunction(Geqrf<double>::Kernel);
   dict["lapack_cgeqrf"] =
@@ -183,6 +198,11 @@ nb::dict Registrations() {
   dict["lapack_cpotrf_ffi"] = EncapsulateFunction(lapack_cpotrf_ffi);
   dict["lapack_zpotrf_ffi"] = EncapsulateFunction(lapack_zpotrf_ffi);
 
+  dict["lapack_sgetrf_ffi"] = EncapsulateFunction(lapack_sgetrf_ffi);
+  dict["lapack_dgetrf_ffi"] = EncapsulateFunction(lapack_dgetrf_ffi);
+  dict["lapack_cgetrf_ffi"] = EncapsulateFunction(lapack_cgetrf_ffi);
+  dict["lapack_zgetrf_ffi"] = EncapsulateFunction(lapack_zgetrf_ffi);
+
   return dict;
 }
 
@@ -191,6 +211,13 @@ NB_MODULE(_lapack, m) {
   m.def("initialize", GetLapackKernelsFromScipy);
   m.def("registrations", &Registrations);
 
+  // BLAS thread budget for single large factorizations; see the BLAS Thread
+  // Budget section of lapack_kernels.h.
+  m.def("set_blas_thread_budget", &SetBlasThreadBudget,
+        nb::arg("num_threads"));
+  m.def("get_blas_thread_budget", &GetBlasThreadBudget);
+  m.def("blas_thread_control_available", &BlasThreadControlAvailable);
+
   // Old-style LAPACK Workspace Size Queries
   m.def("lapack_sgeqrf_workspace", &Geqrf<float>::Workspace, nb::arg("m"),
         nb::arg("n"));
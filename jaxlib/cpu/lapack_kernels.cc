@@ -22,17 +22,28 @@ limitations under the License.
 #include <cstdint>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#endif
+
+#include <atomic>
 
 #include "absl/algorithm/container.h"
 #include "absl/base/dynamic_annotations.h"
 #include "absl/strings/str_format.h"
 #include "xla/ffi/api/c_api.h"
 #include "xla/ffi/api/ffi.h"
+#include "tsl/platform/env.h"
+#include "tsl/platform/threadpool.h"
 
 static_assert(sizeof(jax::lapack_int) == sizeof(int32_t),
               "Expected LAPACK integers to be 32-bit");
@@ -76,6 +87,165 @@ void CopyIfDiffBuffer(ffi::Buffer<dtype> x, ffi::ResultBuffer<dtype> x_out) {
   }
 }
 
+// Optional intra-op thread pool for the batched kernels. Each matrix in a
+// batch is handled by a single-threaded LAPACK call, so batched
+// factorizations of many small matrices otherwise use one core. Opt in by
+// setting JAX_CPU_LAPACK_NUM_THREADS to the number of worker threads.
+tsl::thread::ThreadPool* BatchThreadPool() {
+  static tsl::thread::ThreadPool* const pool =
+      []() -> tsl::thread::ThreadPool* {
+    const char* env = std::getenv("JAX_CPU_LAPACK_NUM_THREADS");
+    int num_threads = (env != nullptr) ? std::atoi(env) : 0;
+    if (num_threads <= 1) return nullptr;
+    return new tsl::thread::ThreadPool(tsl::Env::Default(), "jax_lapack",
+                                       num_threads);
+  }();
+  return pool;
+}
+
+// Runtime thread-control entry points of the BLAS implementations scipy is
+// known to ship (OpenBLAS, MKL), resolved lazily from the already-loaded
+// library. jaxlib does not link a BLAS of its own, so compile-time control
+// is not an option.
+struct BlasThreadControl {
+  void (*openblas_set)(int) = nullptr;
+  int (*openblas_get)() = nullptr;
+  void (*mkl_set)(int) = nullptr;
+  int (*mkl_get_max)() = nullptr;
+};
+
+const BlasThreadControl& GetBlasThreadControl() {
+  static const BlasThreadControl control = [] {
+    BlasThreadControl c;
+#ifndef _WIN32
+    c.openblas_set = reinterpret_cast<void (*)(int)>(
+        dlsym(RTLD_DEFAULT, "openblas_set_num_threads"));
+    c.openblas_get = reinterpret_cast<int (*)()>(
+        dlsym(RTLD_DEFAULT, "openblas_get_num_threads"));
+    c.mkl_set = reinterpret_cast<void (*)(int)>(
+        dlsym(RTLD_DEFAULT, "MKL_Set_Num_Threads"));
+    c.mkl_get_max = reinterpret_cast<int (*)()>(
+        dlsym(RTLD_DEFAULT, "MKL_Get_Max_Threads"));
+#endif
+    return c;
+  }();
+  return control;
+}
+
+void ApplyBlasNumThreads(int num_threads) {
+  const BlasThreadControl& control = GetBlasThreadControl();
+  if (control.openblas_set != nullptr) {
+    control.openblas_set(num_threads);
+  }
+  if (control.mkl_set != nullptr) {
+    control.mkl_set(num_threads);
+  }
+}
+
+int QueryBlasNumThreads() {
+  const BlasThreadControl& control = GetBlasThreadControl();
+  if (control.openblas_get != nullptr) {
+    return control.openblas_get();
+  }
+  if (control.mkl_get_max != nullptr) {
+    return control.mkl_get_max();
+  }
+  return 0;
+}
+
+std::atomic<int> blas_thread_budget{0};
+
+// Batches smaller than this run inline; they are not worth the dispatch
+// overhead of the thread pool.
+constexpr int64_t kMinParallelBatch = 8;
+
+// Runs task(begin, end) over shards of [0, batch), in parallel if the batch
+// thread pool is enabled and the batch is large enough, inline as a single
+// shard otherwise. Shards may run concurrently, so a task that needs scratch
+// space must not use it across shards. Blocks until all shards complete.
+// `cost_per_element` is a rough per-matrix work estimate (in the units
+// expected by tsl::thread::ThreadPool::ParallelFor) used to pick shard sizes.
+template <typename Task>
+void BatchParallelFor(int64_t batch, int64_t cost_per_element, Task&& task) {
+  tsl::thread::ThreadPool* pool = BatchThreadPool();
+  if (pool == nullptr || batch < kMinParallelBatch) {
+    task(int64_t{0}, batch);
+    return;
+  }
+  // The shards issue concurrent LAPACK calls, so clamp the BLAS to one
+  // thread for the duration lest a multithreaded BLAS oversubscribe against
+  // the pool.
+  jax::ScopedBlasThreadBudget blas_budget(
+      QueryBlasNumThreads() > 1 ? 1 : 0);
+  pool->ParallelFor(batch, cost_per_element, std::forward<Task>(task));
+}
+
+// Reusable per-thread scratch for kernels whose LAPACK workspace is not one
+// of the XLA-provided output buffers. The geev/gees custom call signatures
+// predate workspace outputs and are pinned by serialized computations, so
+// instead the workspace is kept alive between calls and only regrown when a
+// larger one is needed; steady-state executions allocate nothing. The
+// parallel shards of the batched kernels use it for the same reason: the
+// XLA-provided workspace is sized for one LAPACK call, and growing it per
+// shard would change buffer shapes pinned the same way.
+template <typename T>
+T* WorkspaceBuffer(int64_t size) {
+  static thread_local std::unique_ptr<T[]> buffer;
+  static thread_local int64_t capacity = 0;
+  if (capacity < size) {
+    buffer.reset(new T[size]);
+    capacity = size;
+  }
+  return buffer.get();
+}
+
+// Runtime SIMD dispatch for the element-wise helper loops in this file. The
+// loops are plain C++ left to the auto-vectorizer, so rather than hand-written
+// intrinsics each helper is compiled once per target ISA with GCC/Clang
+// function multiversioning and the dynamic loader's ifunc resolver picks the
+// widest variant the CPU supports, once, at load time. On toolchains or
+// targets without multiversioning the helpers build for the baseline ISA
+// exactly as before.
+#if defined(__x86_64__) && defined(__ELF__) && \
+    (defined(__clang__) || defined(__GNUC__))
+#define JAX_CPU_TARGET_CLONES \
+  __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#else
+#define JAX_CPU_TARGET_CLONES
+#endif
+
+// Returns true if every element of the buffer is finite. Multiplying by zero
+// maps NaN and infinity to NaN and everything else to zero, so the inner loop
+// is a branch-free accumulation that the compiler vectorizes; blocking keeps
+// early exit on bad data at block rather than element granularity. This scan
+// runs over the full matrix on every geev call, which makes the scalar
+// per-element std::isfinite formulation noticeable on large inputs.
+template <typename T>
+inline bool AllFiniteImpl(const T* data, int64_t size) {
+  constexpr int64_t kBlockSize = 4096;
+  int64_t i = 0;
+  for (; i + kBlockSize <= size; i += kBlockSize) {
+    T acc = T{0};
+    for (int64_t j = 0; j < kBlockSize; ++j) {
+      acc += data[i + j] * T{0};
+    }
+    if (!(acc == T{0})) return false;
+  }
+  T acc = T{0};
+  for (; i < size; ++i) {
+    acc += data[i] * T{0};
+  }
+  return acc == T{0};
+}
+
+JAX_CPU_TARGET_CLONES bool AllFinite(const float* data, int64_t size) {
+  return AllFiniteImpl(data, size);
+}
+
+JAX_CPU_TARGET_CLONES bool AllFinite(const double* data, int64_t size) {
+  return AllFiniteImpl(data, size);
+}
+
 }  // namespace
 
 #define REGISTER_CHAR_ENUM_ATTR_DECODING(type)                                \
@@ -104,6 +274,269 @@ REGISTER_CHAR_ENUM_ATTR_DECODING(jax::MatrixParams::UpLo);
 
 namespace jax {
 
+//== BLAS Thread Budget ==//
+
+bool BlasThreadControlAvailable() {
+  const BlasThreadControl& control = GetBlasThreadControl();
+  return control.openblas_set != nullptr || control.mkl_set != nullptr;
+}
+
+bool SetBlasThreadBudget(int num_threads) {
+  blas_thread_budget.store(num_threads < 0 ? 0 : num_threads,
+                           std::memory_order_relaxed);
+  return BlasThreadControlAvailable();
+}
+
+int GetBlasThreadBudget() {
+  return blas_thread_budget.load(std::memory_order_relaxed);
+}
+
+ScopedBlasThreadBudget::ScopedBlasThreadBudget(int num_threads) {
+  if (num_threads <= 0 || !BlasThreadControlAvailable()) {
+    return;
+  }
+  previous_ = QueryBlasNumThreads();
+  ApplyBlasNumThreads(num_threads);
+}
+
+ScopedBlasThreadBudget::~ScopedBlasThreadBudget() {
+  if (previous_ > 0) {
+    ApplyBlasNumThreads(previous_);
+  }
+}
+
+namespace {
+
+// Direct factorizations and solves for matrices no larger than kMaxDirectDim
+// bypass LAPACK entirely: at 2x2..4x4 the call overhead (argument
+// validation, workspace logic, function-pointer dispatch) dwarfs the
+// arithmetic. The bodies are templated on the dimension so every loop has a
+// compile-time trip count and unrolls fully. Storage is column-major,
+// matching LAPACK, and info follows the LAPACK conventions of the routine
+// each helper replaces.
+constexpr int kMaxDirectDim = 4;
+
+template <typename T>
+inline T MaybeConj(const T& x) {
+  if constexpr (std::is_same_v<T, std::complex<float>> ||
+                std::is_same_v<T, std::complex<double>>) {
+    return std::conj(x);
+  } else {
+    return x;
+  }
+}
+
+// The |re| + |im| pivot magnitude (CABS1) used by getf2; coincides with the
+// absolute value for real types.
+template <typename T>
+inline typename real_type<T>::type PivotMagnitude(const T& x) {
+  if constexpr (std::is_same_v<T, std::complex<float>> ||
+                std::is_same_v<T, std::complex<double>>) {
+    return std::abs(x.real()) + std::abs(x.imag());
+  } else {
+    return std::abs(x);
+  }
+}
+
+// Unblocked partial-pivot LU of a square N x N matrix, as in getf2. A zero
+// pivot sets info to its 1-based column (first occurrence) and skips the
+// scaling, like LAPACK does.
+template <typename T, int N>
+void GetrfDirect(T* a, lapack_int* ipiv, lapack_int* info) {
+  *info = 0;
+  for (int j = 0; j < N; ++j) {
+    int p = j;
+    auto best = PivotMagnitude(a[j + j * N]);
+    for (int i = j + 1; i < N; ++i) {
+      auto mag = PivotMagnitude(a[i + j * N]);
+      if (mag > best) {
+        best = mag;
+        p = i;
+      }
+    }
+    ipiv[j] = p + 1;
+    if (a[p + j * N] == T(0)) {
+      if (*info == 0) {
+        *info = j + 1;
+      }
+      continue;
+    }
+    if (p != j) {
+      for (int k = 0; k < N; ++k) {
+        std::swap(a[j + k * N], a[p + k * N]);
+      }
+    }
+    const T pivot = a[j + j * N];
+    for (int i = j + 1; i < N; ++i) {
+      a[i + j * N] /= pivot;
+    }
+    for (int k = j + 1; k < N; ++k) {
+      const T ajk = a[j + k * N];
+      for (int i = j + 1; i < N; ++i) {
+        a[i + k * N] -= a[i + j * N] * ajk;
+      }
+    }
+  }
+}
+
+// Unblocked Cholesky of an N x N matrix, as in potf2. A non-positive (or
+// NaN) diagonal sets info to its 1-based index and returns, like LAPACK.
+template <typename T, int N>
+void PotrfDirect(bool lower, T* a, lapack_int* info) {
+  using Real = typename real_type<T>::type;
+  *info = 0;
+  for (int j = 0; j < N; ++j) {
+    Real d = std::real(a[j + j * N]);
+    for (int k = 0; k < j; ++k) {
+      d -= std::norm(lower ? a[j + k * N] : a[k + j * N]);
+    }
+    if (!(d > Real(0))) {
+      *info = j + 1;
+      return;
+    }
+    d = std::sqrt(d);
+    a[j + j * N] = d;
+    if (lower) {
+      for (int i = j + 1; i < N; ++i) {
+        T s = a[i + j * N];
+        for (int k = 0; k < j; ++k) {
+          s -= a[i + k * N] * MaybeConj(a[j + k * N]);
+        }
+        a[i + j * N] = s / d;
+      }
+    } else {
+      for (int i = j + 1; i < N; ++i) {
+        T s = a[j + i * N];
+        for (int k = 0; k < j; ++k) {
+          s -= MaybeConj(a[k + j * N]) * a[k + i * N];
+        }
+        a[j + i * N] = s / d;
+      }
+    }
+  }
+}
+
+// Triangular solve with an N x N factor: op(A) X = alpha B when left_side,
+// X op(A) = alpha B otherwise. The transposition cases (and the extra
+// transpose the right side introduces) are folded into a materialized local
+// copy of the operator, so a single substitution loop handles all sixteen
+// side/uplo/trans/diag combinations. `count` is the number of solve vectors
+// (columns of X on the left, rows on the right); vec_stride is the stride
+// between their consecutive elements and next_stride between the vectors.
+template <typename T, int N>
+void TrsmDirect(bool left_side, bool lower, int32_t trans_a, bool unit_diag,
+                int64_t count, int64_t vec_stride, int64_t next_stride,
+                T alpha, const T* a, T* x) {
+  const bool transpose = trans_a != 0;
+  const bool conjugate = trans_a == 2;
+  // Effective operator e such that each solve is e y = alpha b for a
+  // contiguous local vector y: the right-sided solve transposes once more.
+  const bool eff_trans = left_side ? transpose : !transpose;
+  const bool eff_lower = eff_trans ? !lower : lower;
+  T e[N][N];  // e[row][col]
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      T v = eff_trans ? a[j + i * N] : a[i + j * N];
+      e[i][j] = conjugate ? MaybeConj(v) : v;
+    }
+  }
+  for (int64_t v = 0; v < count; ++v) {
+    T* b = x + v * next_stride;
+    T y[N];
+    for (int i = 0; i < N; ++i) {
+      y[i] = alpha * b[i * vec_stride];
+    }
+    if (eff_lower) {
+      for (int i = 0; i < N; ++i) {
+        T s = y[i];
+        for (int k = 0; k < i; ++k) {
+          s -= e[i][k] * y[k];
+        }
+        y[i] = unit_diag ? s : s / e[i][i];
+      }
+    } else {
+      for (int i = N - 1; i >= 0; --i) {
+        T s = y[i];
+        for (int k = i + 1; k < N; ++k) {
+          s -= e[i][k] * y[k];
+        }
+        y[i] = unit_diag ? s : s / e[i][i];
+      }
+    }
+    for (int i = 0; i < N; ++i) {
+      b[i * vec_stride] = y[i];
+    }
+  }
+}
+
+// Right-hand-side columns processed per pass of the blocked solve below.
+constexpr int64_t kTrsmRhsBlock = 32;
+// The folded factor must fit comfortably in L2 for its reuse across blocks
+// to pay off; larger factors fall back to LAPACK.
+constexpr int64_t kTrsmMaxPanelBytes = int64_t{512} * 1024;
+// Right-hand-side counts below this do not amortize folding the factor.
+constexpr int64_t kTrsmMinBlockedRhs = 4 * kTrsmRhsBlock;
+
+// Cache-blocked solve of op(A) X = alpha B for a left-sided system with many
+// right-hand sides sharing one M x M factor. The transposition (and
+// conjugation) of the operator is folded once into `panel`, a column-major
+// M x M scratch buffer, which then stays resident in cache while the
+// right-hand sides stream through it in blocks of kTrsmRhsBlock columns.
+// Within a block, each substitution step is a contiguous unit-stride update
+// of a column against a column of the panel, which the compiler vectorizes.
+template <typename T>
+void TrsmBlockedLeft(bool lower, int32_t trans_a, bool unit_diag,
+                     const int64_t m, const int64_t n, const T alpha,
+                     const T* a, T* x, T* panel) {
+  const bool transpose = trans_a != 0;
+  const bool conjugate = trans_a == 2;
+  const bool eff_lower = transpose ? !lower : lower;
+  for (int64_t c = 0; c < m; ++c) {
+    for (int64_t r = 0; r < m; ++r) {
+      T v = transpose ? a[c + r * m] : a[r + c * m];
+      panel[r + c * m] = conjugate ? MaybeConj(v) : v;
+    }
+  }
+  for (int64_t j0 = 0; j0 < n; j0 += kTrsmRhsBlock) {
+    const int64_t j1 = std::min(n, j0 + kTrsmRhsBlock);
+    if (alpha != T(1)) {
+      for (int64_t j = j0; j < j1; ++j) {
+        T* xj = x + j * m;
+        for (int64_t r = 0; r < m; ++r) {
+          xj[r] *= alpha;
+        }
+      }
+    }
+    if (eff_lower) {
+      for (int64_t i = 0; i < m; ++i) {
+        const T* pi = panel + i * m;
+        for (int64_t j = j0; j < j1; ++j) {
+          T* xj = x + j * m;
+          const T xi = unit_diag ? xj[i] : xj[i] / pi[i];
+          xj[i] = xi;
+          for (int64_t r = i + 1; r < m; ++r) {
+            xj[r] -= pi[r] * xi;
+          }
+        }
+      }
+    } else {
+      for (int64_t i = m - 1; i >= 0; --i) {
+        const T* pi = panel + i * m;
+        for (int64_t j = j0; j < j1; ++j) {
+          T* xj = x + j * m;
+          const T xi = unit_diag ? xj[i] : xj[i] / pi[i];
+          xj[i] = xi;
+          for (int64_t r = 0; r < i; ++r) {
+            xj[r] -= pi[r] * xi;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
 //== Triangular System Solver ==//
 
 // lapack trsm
@@ -146,6 +579,51 @@ void Trsm<T>::Kernel(void* out, void** data, XlaCustomCallStatus*) {
   int64_t x_plus = static_cast<int64_t>(m) * static_cast<int64_t>(n);
   int64_t a_plus = static_cast<int64_t>(lda) * static_cast<int64_t>(lda);
 
+  // Tiny triangular factors are solved directly; see TrsmDirect.
+  if (lda >= 1 && lda <= kMaxDirectDim) {
+    const int64_t count = left_side ? n : m;
+    const int64_t vec_stride = left_side ? 1 : m;
+    const int64_t next_stride = left_side ? m : 1;
+    for (int i = 0; i < batch; ++i) {
+      switch (lda) {
+        case 1:
+          TrsmDirect<T, 1>(left_side, lower, trans_a, diag, count, vec_stride,
+                           next_stride, *alpha, a, x);
+          break;
+        case 2:
+          TrsmDirect<T, 2>(left_side, lower, trans_a, diag, count, vec_stride,
+                           next_stride, *alpha, a, x);
+          break;
+        case 3:
+          TrsmDirect<T, 3>(left_side, lower, trans_a, diag, count, vec_stride,
+                           next_stride, *alpha, a, x);
+          break;
+        case 4:
+          TrsmDirect<T, 4>(left_side, lower, trans_a, diag, count, vec_stride,
+                           next_stride, *alpha, a, x);
+          break;
+      }
+      x += x_plus;
+      a += a_plus;
+    }
+    return;
+  }
+
+  // Many right-hand sides against one moderate factor are solved blocked,
+  // with the factor kept cache-resident; see TrsmBlockedLeft.
+  if (left_side &&
+      static_cast<int64_t>(m) * m * sizeof(T) <= kTrsmMaxPanelBytes &&
+      n >= kTrsmMinBlockedRhs && n >= m) {
+    std::vector<T> panel(static_cast<int64_t>(m) * m);
+    for (int i = 0; i < batch; ++i) {
+      TrsmBlockedLeft<T>(lower, trans_a, diag, m, n, *alpha, a, x,
+                         panel.data());
+      x += x_plus;
+      a += a_plus;
+    }
+    return;
+  }
+
   for (int i = 0; i < batch; ++i) {
     fn(&cside, &cuplo, &ctransa, &cdiag, &m, &n, alpha, a, &lda, x, &ldb);
     x += x_plus;
@@ -181,12 +659,40 @@ void Getrf<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
                 static_cast<int64_t>(b) * static_cast<int64_t>(m) *
                     static_cast<int64_t>(n) * sizeof(T));
   }
-  for (int i = 0; i < b; ++i) {
-    fn(&m, &n, a_out, &m, ipiv, info);
-    a_out += static_cast<int64_t>(m) * static_cast<int64_t>(n);
-    ipiv += std::min(m, n);
-    ++info;
+  const int64_t a_step = static_cast<int64_t>(m) * static_cast<int64_t>(n);
+  const int64_t cost = a_step * std::min(m, n);
+  // Tiny square matrices are factored directly; see GetrfDirect.
+  if (m == n && n >= 1 && n <= kMaxDirectDim) {
+    BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        T* a = a_out + i * a_step;
+        lapack_int* piv = ipiv + i * n;
+        switch (n) {
+          case 1:
+            GetrfDirect<T, 1>(a, piv, info + i);
+            break;
+          case 2:
+            GetrfDirect<T, 2>(a, piv, info + i);
+            break;
+          case 3:
+            GetrfDirect<T, 3>(a, piv, info + i);
+            break;
+          case 4:
+            GetrfDirect<T, 4>(a, piv, info + i);
+            break;
+        }
+      }
+    });
+    return;
   }
+  // A single large factorization may use the configured BLAS thread budget;
+  // sharded batches are instead clamped inside BatchParallelFor.
+  ScopedBlasThreadBudget blas_budget(b == 1 ? GetBlasThreadBudget() : 0);
+  BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&m, &n, a_out + i * a_step, &m, ipiv + i * std::min(m, n), info + i);
+    }
+  });
 }
 
 template struct Getrf<float>;
@@ -194,6 +700,86 @@ template struct Getrf<double>;
 template struct Getrf<std::complex<float>>;
 template struct Getrf<std::complex<double>>;
 
+// FFI Kernel
+
+template <ffi::DataType dtype>
+ffi::Error LuDecomposition<dtype>::Kernel(
+    ffi::Buffer<dtype> x, ffi::ResultBuffer<dtype> x_out,
+    ffi::ResultBuffer<LapackIntDtype> ipiv,
+    ffi::ResultBuffer<LapackIntDtype> info) {
+  auto [batch_count, x_rows, x_cols] = SplitBatch2D(x.dimensions);
+  auto* x_out_data = x_out->data;
+  auto* ipiv_data = ipiv->data;
+  auto* info_data = info->data;
+
+  CopyIfDiffBuffer(x, x_out);
+
+  auto x_rows_v = CastNoOverflow<lapack_int>(x_rows);
+  auto x_cols_v = CastNoOverflow<lapack_int>(x_cols);
+  auto x_leading_dim_v = x_rows_v;
+
+  const int64_t x_out_step{x_rows * x_cols};
+  const int64_t ipiv_step{std::min(x_rows, x_cols)};
+  const int64_t cost = x_out_step * ipiv_step;
+  ScopedBlasThreadBudget blas_budget(batch_count == 1 ? GetBlasThreadBudget()
+                                                      : 0);
+  BatchParallelFor(batch_count, cost, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&x_rows_v, &x_cols_v, x_out_data + i * x_out_step, &x_leading_dim_v,
+         ipiv_data + i * ipiv_step, info_data + i);
+    }
+  });
+  return ffi::Error::Success();
+}
+
+template struct LuDecomposition<ffi::DataType::F32>;
+template struct LuDecomposition<ffi::DataType::F64>;
+template struct LuDecomposition<ffi::DataType::C64>;
+template struct LuDecomposition<ffi::DataType::C128>;
+
+// lapack getrs
+
+template <typename T>
+typename Getrs<T>::FnType* Getrs<T>::fn = nullptr;
+
+template <typename T>
+void Getrs<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
+  int b = *(reinterpret_cast<int32_t*>(data[0]));
+  int n = *(reinterpret_cast<int32_t*>(data[1]));
+  int nrhs = *(reinterpret_cast<int32_t*>(data[2]));
+  int32_t trans_int = *(reinterpret_cast<int32_t*>(data[3]));
+  // The LU factors and pivots are consumed in place; getrs never writes
+  // them, so the const_cast is only to satisfy the LAPACK prototype.
+  T* lu = const_cast<T*>(reinterpret_cast<const T*>(data[4]));
+  int* ipiv = const_cast<int*>(reinterpret_cast<const int*>(data[5]));
+  const T* b_in = reinterpret_cast<T*>(data[6]);
+
+  void** out = reinterpret_cast<void**>(out_tuple);
+  T* x_out = reinterpret_cast<T*>(out[0]);
+  int* info = reinterpret_cast<int*>(out[1]);
+
+  char trans = trans_int == 1 ? 'T' : trans_int == 2 ? 'C' : 'N';
+  if (x_out != b_in) {
+    std::memcpy(x_out, b_in,
+                static_cast<int64_t>(b) * static_cast<int64_t>(n) *
+                    static_cast<int64_t>(nrhs) * sizeof(T));
+  }
+  const int64_t lu_step = static_cast<int64_t>(n) * static_cast<int64_t>(n);
+  const int64_t x_step = static_cast<int64_t>(n) * static_cast<int64_t>(nrhs);
+  const int64_t cost = lu_step * nrhs;
+  BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&trans, &n, &nrhs, lu + i * lu_step, &n, ipiv + i * n,
+         x_out + i * x_step, &n, info + i);
+    }
+  });
+}
+
+template struct Getrs<float>;
+template struct Getrs<double>;
+template struct Getrs<std::complex<float>>;
+template struct Getrs<std::complex<double>>;
+
 //== QR Factorization ==//
 
 // lapack geqrf
@@ -318,11 +904,39 @@ void Potrf<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
                     static_cast<int64_t>(n) * sizeof(T));
   }
 
-  for (int i = 0; i < b; ++i) {
-    fn(&uplo, &n, a_out, &n, info);
-    a_out += static_cast<int64_t>(n) * static_cast<int64_t>(n);
-    ++info;
+  const int64_t a_step = static_cast<int64_t>(n) * static_cast<int64_t>(n);
+  const int64_t cost = a_step * n;
+  // Tiny matrices are factored directly; see PotrfDirect.
+  if (n >= 1 && n <= kMaxDirectDim) {
+    BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        T* a = a_out + i * a_step;
+        switch (n) {
+          case 1:
+            PotrfDirect<T, 1>(lower, a, info + i);
+            break;
+          case 2:
+            PotrfDirect<T, 2>(lower, a, info + i);
+            break;
+          case 3:
+            PotrfDirect<T, 3>(lower, a, info + i);
+            break;
+          case 4:
+            PotrfDirect<T, 4>(lower, a, info + i);
+            break;
+        }
+      }
+    });
+    return;
   }
+  // A single large factorization may use the configured BLAS thread budget;
+  // sharded batches are instead clamped inside BatchParallelFor.
+  ScopedBlasThreadBudget blas_budget(b == 1 ? GetBlasThreadBudget() : 0);
+  BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&uplo, &n, a_out + i * a_step, &n, info + i);
+    }
+  });
 }
 
 template struct Potrf<float>;
@@ -347,11 +961,15 @@ ffi::Error CholeskyFactorization<dtype>::Kernel(
   auto x_leading_dim_v = x_order_v;
 
   const int64_t x_out_step{x_rows * x_cols};
-  for (int64_t i = 0; i < batch_count; ++i) {
-    fn(&uplo_v, &x_order_v, x_out_data, &x_leading_dim_v, info_data);
-    x_out_data += x_out_step;
-    ++info_data;
-  }
+  const int64_t cost = x_out_step * x_cols;
+  ScopedBlasThreadBudget blas_budget(batch_count == 1 ? GetBlasThreadBudget()
+                                                      : 0);
+  BatchParallelFor(batch_count, cost, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&uplo_v, &x_order_v, x_out_data + i * x_out_step, &x_leading_dim_v,
+         info_data + i);
+    }
+  });
   return ffi::Error::Success();
 }
 
@@ -413,15 +1031,30 @@ void RealGesdd<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
   int tdu = job_opt_full_matrices ? m : std::min(m, n);
   int ldvt = job_opt_full_matrices ? n : std::min(m, n);
 
-  for (int i = 0; i < b; ++i) {
-    fn(&jobz, &m, &n, a_out, &lda, s, u, &ldu, vt, &ldvt, work, &lwork, iwork,
-       info);
-    a_out += static_cast<int64_t>(m) * n;
-    s += std::min(m, n);
-    u += static_cast<int64_t>(m) * tdu;
-    vt += static_cast<int64_t>(ldvt) * n;
-    ++info;
-  }
+  const int64_t a_step = static_cast<int64_t>(m) * n;
+  const int64_t s_step = std::min(m, n);
+  const int64_t u_step = static_cast<int64_t>(m) * tdu;
+  const int64_t vt_step = static_cast<int64_t>(ldvt) * n;
+  const int64_t cost = a_step * std::min(m, n);
+  BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+    // Concurrent shards cannot share the XLA-provided workspace; all but the
+    // single inline shard allocate their own.
+    T* work_local = work;
+    int* iwork_local = iwork;
+    std::vector<T> work_storage;
+    std::vector<int> iwork_storage;
+    if (begin != 0 || end != b) {
+      work_storage.resize(lwork);
+      iwork_storage.resize(8 * std::min(m, n));
+      work_local = work_storage.data();
+      iwork_local = iwork_storage.data();
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&jobz, &m, &n, a_out + i * a_step, &lda, s + i * s_step,
+         u + i * u_step, &ldu, vt + i * vt_step, &ldvt, work_local, &lwork,
+         iwork_local, info + i);
+    }
+  });
 }
 
 template <typename T>
@@ -487,15 +1120,35 @@ void ComplexGesdd<T>::Kernel(void* out_tuple, void** data,
   int tdu = job_opt_full_matrices ? m : std::min(m, n);
   int ldvt = job_opt_full_matrices ? n : std::min(m, n);
 
-  for (int i = 0; i < b; ++i) {
-    fn(&jobz, &m, &n, a_out, &lda, s, u, &ldu, vt, &ldvt, work, &lwork, rwork,
-       iwork, info);
-    a_out += static_cast<int64_t>(m) * n;
-    s += std::min(m, n);
-    u += static_cast<int64_t>(m) * tdu;
-    vt += static_cast<int64_t>(ldvt) * n;
-    ++info;
-  }
+  const int64_t a_step = static_cast<int64_t>(m) * n;
+  const int64_t s_step = std::min(m, n);
+  const int64_t u_step = static_cast<int64_t>(m) * tdu;
+  const int64_t vt_step = static_cast<int64_t>(ldvt) * n;
+  const int64_t cost = a_step * std::min(m, n);
+  BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+    // Concurrent shards cannot share the XLA-provided workspace; all but the
+    // single inline shard allocate their own.
+    T* work_local = work;
+    int* iwork_local = iwork;
+    typename T::value_type* rwork_local = rwork;
+    std::vector<T> work_storage;
+    std::vector<int> iwork_storage;
+    std::vector<typename T::value_type> rwork_storage;
+    if (begin != 0 || end != b) {
+      work_storage.resize(lwork);
+      iwork_storage.resize(8 * std::min(m, n));
+      rwork_storage.resize(
+          ComplexGesddRworkSize(m, n, job_opt_compute_uv));
+      work_local = work_storage.data();
+      iwork_local = iwork_storage.data();
+      rwork_local = rwork_storage.data();
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&jobz, &m, &n, a_out + i * a_step, &lda, s + i * s_step,
+         u + i * u_step, &ldu, vt + i * vt_step, &ldvt, work_local, &lwork,
+         rwork_local, iwork_local, info + i);
+    }
+  });
 }
 
 template <typename T>
@@ -556,13 +1209,23 @@ void RealSyevd<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
 
   lapack_int lwork = SyevdWorkSize(n);
   lapack_int liwork = SyevdIworkSize(n);
-  for (int i = 0; i < b; ++i) {
-    fn(&jobz, &uplo, &n, a_out, &n, w_out, work, &lwork, iwork, &liwork,
-       info_out);
-    a_out += static_cast<int64_t>(n) * n;
-    w_out += n;
-    ++info_out;
-  }
+  const int64_t a_step = static_cast<int64_t>(n) * n;
+  const int64_t cost = a_step * n;
+  BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+    // Concurrent shards cannot share the XLA-provided workspace; all but the
+    // single inline shard use the reusable per-thread scratch, so steady-state
+    // executions stay allocation-free even when the batch pool is enabled.
+    T* work_local = work;
+    int* iwork_local = iwork;
+    if (begin != 0 || end != b) {
+      work_local = WorkspaceBuffer<T>(lwork);
+      iwork_local = WorkspaceBuffer<int>(liwork);
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&jobz, &uplo, &n, a_out + i * a_step, &n, w_out + i * n, work_local,
+         &lwork, iwork_local, &liwork, info_out + i);
+    }
+  });
 }
 
 // Workspace sizes, taken from the LAPACK documentation.
@@ -606,13 +1269,25 @@ void ComplexHeevd<T>::Kernel(void* out_tuple, void** data,
   lapack_int lwork = HeevdWorkSize(n);
   lapack_int lrwork = HeevdRworkSize(n);
   lapack_int liwork = SyevdIworkSize(n);
-  for (int i = 0; i < b; ++i) {
-    fn(&jobz, &uplo, &n, a_out, &n, w_out, work, &lwork, rwork, &lrwork, iwork,
-       &liwork, info_out);
-    a_out += static_cast<int64_t>(n) * n;
-    w_out += n;
-    ++info_out;
-  }
+  const int64_t a_step = static_cast<int64_t>(n) * n;
+  const int64_t cost = a_step * n;
+  BatchParallelFor(b, cost, [&](int64_t begin, int64_t end) {
+    // Concurrent shards cannot share the XLA-provided workspace; all but the
+    // single inline shard use the reusable per-thread scratch, so steady-state
+    // executions stay allocation-free even when the batch pool is enabled.
+    T* work_local = work;
+    typename T::value_type* rwork_local = rwork;
+    int* iwork_local = iwork;
+    if (begin != 0 || end != b) {
+      work_local = WorkspaceBuffer<T>(lwork);
+      rwork_local = WorkspaceBuffer<typename T::value_type>(lrwork);
+      iwork_local = WorkspaceBuffer<int>(liwork);
+    }
+    for (int64_t i = begin; i < end; ++i) {
+      fn(&jobz, &uplo, &n, a_out + i * a_step, &n, w_out + i * n, work_local,
+         &lwork, rwork_local, &lrwork, iwork_local, &liwork, info_out + i);
+    }
+  });
 }
 
 template struct RealSyevd<float>;
@@ -622,10 +1297,12 @@ template struct ComplexHeevd<std::complex<double>>;
 
 // LAPACK uses a packed representation to represent a mixture of real
 // eigenvectors and complex conjugate pairs. This helper unpacks the
-// representation into regular complex matrices.
+// representation into regular complex matrices. The column loops are
+// element-wise interleaving, so the multiversioned wrappers below let the
+// vectorizer emit wider variants of them.
 template <typename T>
-static void UnpackEigenvectors(int n, const T* im_eigenvalues, const T* packed,
-                               std::complex<T>* unpacked) {
+inline void UnpackEigenvectorsImpl(int n, const T* im_eigenvalues,
+                                   const T* packed, std::complex<T>* unpacked) {
   T re, im;
   int j;
   j = 0;
@@ -647,6 +1324,18 @@ static void UnpackEigenvectors(int n, const T* im_eigenvalues, const T* packed,
   }
 }
 
+JAX_CPU_TARGET_CLONES static void UnpackEigenvectors(
+    int n, const float* im_eigenvalues, const float* packed,
+    std::complex<float>* unpacked) {
+  UnpackEigenvectorsImpl(n, im_eigenvalues, packed, unpacked);
+}
+
+JAX_CPU_TARGET_CLONES static void UnpackEigenvectors(
+    int n, const double* im_eigenvalues, const double* packed,
+    std::complex<double>* unpacked) {
+  UnpackEigenvectorsImpl(n, im_eigenvalues, packed, unpacked);
+}
+
 // lapack geev
 
 template <typename T>
@@ -673,29 +1362,18 @@ void RealGeev<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
   std::complex<T>* vr_out = reinterpret_cast<std::complex<T>*>(out[6]);
   int* info_out = reinterpret_cast<int*>(out[7]);
 
-  // TODO(phawkins): preallocate workspace using XLA.
   T work_query;
   int lwork = -1;
   fn(&jobvl, &jobvr, &n_int, a_work, &n_int, wr_out, wi_out, vl_work, &n_int,
      vr_work, &n_int, &work_query, &lwork, info_out);
   ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(&work_query, sizeof(work_query));
   lwork = static_cast<int>(work_query);
-  T* work = new T[lwork];
+  T* work = WorkspaceBuffer<T>(lwork);
 
-  auto is_finite = [](T* a_work, int64_t n) {
-    for (int64_t j = 0; j < n; ++j) {
-      for (int64_t k = 0; k < n; ++k) {
-        if (!std::isfinite(a_work[j * n + k])) {
-          return false;
-        }
-      }
-    }
-    return true;
-  };
   for (int i = 0; i < b; ++i) {
     size_t a_size = n * n * sizeof(T);
     std::memcpy(a_work, a_in, a_size);
-    if (is_finite(a_work, n)) {
+    if (AllFinite(a_work, n * n)) {
       fn(&jobvl, &jobvr, &n_int, a_work, &n_int, wr_out, wi_out, vl_work,
          &n_int, vr_work, &n_int, work, &lwork, info_out);
       ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(a_work, a_size);
@@ -718,7 +1396,6 @@ void RealGeev<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
     vr_out += n * n;
     ++info_out;
   }
-  delete[] work;
 }
 
 template <typename T>
@@ -745,31 +1422,20 @@ void ComplexGeev<T>::Kernel(void* out_tuple, void** data,
   T* vr_out = reinterpret_cast<T*>(out[4]);
   int* info_out = reinterpret_cast<int*>(out[5]);
 
-  // TODO(phawkins): preallocate workspace using XLA.
   T work_query;
   int lwork = -1;
   fn(&jobvl, &jobvr, &n_int, a_work, &n_int, w_out, vl_out, &n_int, vr_out,
      &n_int, &work_query, &lwork, r_work, info_out);
   ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(&work_query, sizeof(work_query));
   lwork = static_cast<int>(work_query.real());
-  T* work = new T[lwork];
-
-  auto is_finite = [](T* a_work, int64_t n) {
-    for (int64_t j = 0; j < n; ++j) {
-      for (int64_t k = 0; k < n; ++k) {
-        T v = a_work[j * n + k];
-        if (!std::isfinite(v.real()) || !std::isfinite(v.imag())) {
-          return false;
-        }
-      }
-    }
-    return true;
-  };
+  T* work = WorkspaceBuffer<T>(lwork);
 
   for (int i = 0; i < b; ++i) {
     size_t a_size = n * n * sizeof(T);
     std::memcpy(a_work, a_in, a_size);
-    if (is_finite(a_work, n)) {
+    if (AllFinite(
+            reinterpret_cast<const typename T::value_type*>(a_work),
+            2 * n * n)) {
       fn(&jobvl, &jobvr, &n_int, a_work, &n_int, w_out, vl_out, &n_int, vr_out,
          &n_int, work, &lwork, r_work, info_out);
       ABSL_ANNOTATE_MEMORY_IS_INITIALIZED(a_work, a_size);
@@ -786,7 +1452,6 @@ void ComplexGeev<T>::Kernel(void* out_tuple, void** data,
     vr_out += n * n;
     info_out += 1;
   }
-  delete[] work;
 }
 
 template struct RealGeev<float>;
@@ -823,7 +1488,7 @@ void RealGees<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
   int* sdim_out = reinterpret_cast<int*>(out[4]);
   int* info_out = reinterpret_cast<int*>(out[5]);
 
-  bool* b_work = (sort != 'N') ? (new bool[n]) : nullptr;
+  bool* b_work = (sort != 'N') ? WorkspaceBuffer<bool>(n) : nullptr;
 
   T work_query;
   int lwork = -1;
@@ -856,8 +1521,6 @@ void RealGees<T>::Kernel(void* out_tuple, void** data, XlaCustomCallStatus*) {
     ++sdim_out;
     ++info_out;
   }
-  delete[] work;
-  delete[] b_work;
 }
 
 template <typename T>
@@ -886,7 +1549,7 @@ void ComplexGees<T>::Kernel(void* out_tuple, void** data,
   int* sdim_out = reinterpret_cast<int*>(out[4]);
   int* info_out = reinterpret_cast<int*>(out[5]);
 
-  bool* b_work = (sort != 'N') ? (new bool[n]) : nullptr;
+  bool* b_work = (sort != 'N') ? WorkspaceBuffer<bool>(n) : nullptr;
 
   T work_query;
   int lwork = -1;
@@ -917,8 +1580,6 @@ void ComplexGees<T>::Kernel(void* out_tuple, void** data,
     ++info_out;
     ++sdim_out;
   }
-  delete[] work;
-  delete[] b_work;
 }
 
 template struct RealGees<float>;
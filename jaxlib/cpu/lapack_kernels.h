@@ -77,6 +77,37 @@ inline constexpr auto LapackIntDtype = ::xla::ffi::DataType::S32;
 static_assert(
     std::is_same_v<::xla::ffi::NativeType<LapackIntDtype>, lapack_int>);
 
+//== BLAS Thread Budget ==//
+
+// jaxlib calls whatever BLAS implementation scipy linked, and by default has
+// no say in how many threads it uses: a single large factorization runs on
+// however many cores that BLAS decided on at startup (often one). These
+// hooks configure a per-call thread budget, applied around single-matrix
+// factorizations by the kernels below. The thread-control entry points of
+// the common implementations (OpenBLAS, MKL) are resolved at runtime, so
+// control may be unavailable.
+bool BlasThreadControlAvailable();
+
+// Sets the thread budget that single large factorizations may use; 0 (the
+// default) leaves the BLAS configuration untouched. Returns false when the
+// linked BLAS exposes no runtime thread control.
+bool SetBlasThreadBudget(int num_threads);
+int GetBlasThreadBudget();
+
+// Applies `num_threads` to the BLAS for the current scope and restores the
+// previous setting on destruction. No-op when num_threads <= 0 or the linked
+// BLAS exposes no runtime thread control.
+class ScopedBlasThreadBudget {
+ public:
+  explicit ScopedBlasThreadBudget(int num_threads);
+  ~ScopedBlasThreadBudget();
+  ScopedBlasThreadBudget(const ScopedBlasThreadBudget&) = delete;
+  ScopedBlasThreadBudget& operator=(const ScopedBlasThreadBudget&) = delete;
+
+ private:
+  int previous_ = 0;
+};
+
 //== Triangular System Solver ==//
 
 // lapack trsm
@@ -104,6 +135,35 @@ struct Getrf {
   static void Kernel(void* out, void** data, XlaCustomCallStatus*);
 };
 
+template <::xla::ffi::DataType dtype>
+struct LuDecomposition {
+  using ValueType = ::xla::ffi::NativeType<dtype>;
+  using FnType = void(lapack_int* m, lapack_int* n, ValueType* a,
+                      lapack_int* lda, lapack_int* ipiv, lapack_int* info);
+
+  inline static FnType* fn = nullptr;
+
+  static ::xla::ffi::Error Kernel(
+      ::xla::ffi::Buffer<dtype> x, ::xla::ffi::ResultBuffer<dtype> x_out,
+      ::xla::ffi::ResultBuffer<LapackIntDtype> ipiv,
+      ::xla::ffi::ResultBuffer<LapackIntDtype> info);
+};
+
+// lapack getrs
+
+// Solves against an existing LU factorization (as produced by getrf). The
+// factors and pivots are read in place from their operand buffers, so one
+// factorization can back any number of solve calls without being copied.
+template <typename T>
+struct Getrs {
+  using FnType = void(char* trans, lapack_int* n, lapack_int* nrhs, T* a,
+                      lapack_int* lda, lapack_int* ipiv, T* b, lapack_int* ldb,
+                      lapack_int* info);
+
+  static FnType* fn;
+  static void Kernel(void* out, void** data, XlaCustomCallStatus*);
+};
+
 //== QR Factorization ==//
 
 // lapack geqrf
@@ -36,6 +36,11 @@ jax::Getrf<double>::FnType dgetrf_;
 jax::Getrf<std::complex<float>>::FnType cgetrf_;
 jax::Getrf<std::complex<double>>::FnType zgetrf_;
 
+jax::Getrs<float>::FnType sgetrs_;
+jax::Getrs<double>::FnType dgetrs_;
+jax::Getrs<std::complex<float>>::FnType cgetrs_;
+jax::Getrs<std::complex<double>>::FnType zgetrs_;
+
 jax::Geqrf<float>::FnType sgeqrf_;
 jax::Geqrf<double>::FnType dgeqrf_;
 jax::Geqrf<std::complex<float>>::FnType cgeqrf_;
@@ -103,6 +108,18 @@ static_assert(
     std::is_same_v<jax::CholeskyFactorization<ffi::DataType::C128>::FnType,
                    jax::Potrf<std::complex<double>>::FnType>,
     JAX_KERNEL_FNTYPE_MISMATCH_MSG);
+static_assert(std::is_same_v<jax::LuDecomposition<ffi::DataType::F32>::FnType,
+                             jax::Getrf<float>::FnType>,
+              JAX_KERNEL_FNTYPE_MISMATCH_MSG);
+static_assert(std::is_same_v<jax::LuDecomposition<ffi::DataType::F64>::FnType,
+                             jax::Getrf<double>::FnType>,
+              JAX_KERNEL_FNTYPE_MISMATCH_MSG);
+static_assert(std::is_same_v<jax::LuDecomposition<ffi::DataType::C64>::FnType,
+                             jax::Getrf<std::complex<float>>::FnType>,
+              JAX_KERNEL_FNTYPE_MISMATCH_MSG);
+static_assert(std::is_same_v<jax::LuDecomposition<ffi::DataType::C128>::FnType,
+                             jax::Getrf<std::complex<double>>::FnType>,
+              JAX_KERNEL_FNTYPE_MISMATCH_MSG);
 
 #undef JAX_KERNEL_FNTYPE_MISMATCH_MSG
 
@@ -117,6 +134,11 @@ static auto init = []() -> int {
   AssignKernelFn<Getrf<std::complex<float>>>(cgetrf_);
   AssignKernelFn<Getrf<std::complex<double>>>(zgetrf_);
 
+  AssignKernelFn<Getrs<float>>(sgetrs_);
+  AssignKernelFn<Getrs<double>>(dgetrs_);
+  AssignKernelFn<Getrs<std::complex<float>>>(cgetrs_);
+  AssignKernelFn<Getrs<std::complex<double>>>(zgetrs_);
+
   AssignKernelFn<Geqrf<float>>(sgeqrf_);
   AssignKernelFn<Geqrf<double>>(dgeqrf_);
   AssignKernelFn<Geqrf<std::complex<float>>>(cgeqrf_);
@@ -169,6 +191,11 @@ static auto init = []() -> int {
   AssignKernelFn<CholeskyFactorization<ffi::DataType::C64>>(cpotrf_);
   AssignKernelFn<CholeskyFactorization<ffi::DataType::C128>>(zpotrf_);
 
+  AssignKernelFn<LuDecomposition<ffi::DataType::F32>>(sgetrf_);
+  AssignKernelFn<LuDecomposition<ffi::DataType::F64>>(dgetrf_);
+  AssignKernelFn<LuDecomposition<ffi::DataType::C64>>(cgetrf_);
+  AssignKernelFn<LuDecomposition<ffi::DataType::C128>>(zgetrf_);
+
   return 0;
 }();
 
@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "jaxlib/cuda/versions_helpers.h"
 
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
 #include "nanobind/nanobind.h"
 #include "jaxlib/gpu/vendor.h"
 
@@ -23,6 +27,73 @@ namespace {
 
 namespace nb = nanobind;
 
+// Optional cross-process cache for the runtime version probes. Each probe
+// dlopens and queries one CUDA library, which adds up when thousands of
+// short-lived jobs import JAX on the same machine. Pointing
+// JAX_CUDA_VERSIONS_CACHE at a file (e.g. in /dev/shm) makes the first
+// process on a machine record its probe results and later processes read
+// them back. The file is keyed by the kernel boot id and the CUDA version
+// the wheel was built against, so it self-invalidates on reboot, driver
+// updates (which require a reboot to take effect), and jaxlib upgrades.
+// Everything below runs under the GIL, so in-process state needs no locking.
+
+bool version_read_from_cache = false;
+
+std::string CacheKeyHeader() {
+  std::ifstream boot("/proc/sys/kernel/random/boot_id");
+  std::string boot_id;
+  std::getline(boot, boot_id);
+  if (boot_id.empty()) {  // Not Linux; the cache is disabled.
+    return "";
+  }
+  return boot_id + ":" + std::to_string(CUDA_VERSION);
+}
+
+template <typename Fn>
+auto CachedVersion(const char* name, Fn&& probe) {
+  using Result = decltype(probe());
+  const char* path = std::getenv("JAX_CUDA_VERSIONS_CACHE");
+  if (path == nullptr) {
+    return probe();
+  }
+  static const std::string& header = *new std::string(CacheKeyHeader());
+  if (header.empty()) {
+    return probe();
+  }
+  {
+    std::ifstream in(path);
+    std::string line;
+    if (in && std::getline(in, line) && line == header) {
+      std::string entry;
+      long long value;
+      while (in >> entry >> value) {
+        if (entry == name) {
+          version_read_from_cache = true;
+          return static_cast<Result>(value);
+        }
+      }
+    }
+  }
+  Result value = probe();
+  // The first writer lays down the header and later writers append entries;
+  // a stale header invalidates the whole file. Probes that throw (e.g. cuDNN
+  // missing) cache nothing and are retried by every process.
+  bool valid;
+  {
+    std::ifstream check(path);
+    std::string line;
+    valid = check && std::getline(check, line) && line == header;
+  }
+  std::ofstream out(path, valid ? std::ios::app : std::ios::trunc);
+  if (out) {
+    if (!valid) {
+      out << header << "\n";
+    }
+    out << name << " " << static_cast<long long>(value) << "\n";
+  }
+  return value;
+}
+
 NB_MODULE(_versions, m) {
   // Nanobind's leak checking sometimes returns false positives for this file.
   // The problem appears related to forming a closure of a nanobind function.
@@ -37,16 +108,28 @@ NB_MODULE(_versions, m) {
   m.def("cusolver_build_version", []() { return CUSOLVER_VERSION; });
   m.def("cusparse_build_version", []() { return CUSPARSE_VERSION; });
 
-  m.def("cuda_runtime_get_version", &CudaRuntimeGetVersion);
-  m.def("cuda_driver_get_version", &CudaDriverGetVersion);
-  m.def("cudnn_get_version", &CudnnGetVersion);
-  m.def("cupti_get_version", &CuptiGetVersion);
-  m.def("cufft_get_version", &CufftGetVersion);
-  m.def("cusolver_get_version", &CusolverGetVersion);
-  m.def("cublas_get_version", &CublasGetVersion);
-  m.def("cusparse_get_version", &CusparseGetVersion);
+  m.def("cuda_runtime_get_version",
+        [] { return CachedVersion("cuda_runtime", &CudaRuntimeGetVersion); });
+  m.def("cuda_driver_get_version",
+        [] { return CachedVersion("cuda_driver", &CudaDriverGetVersion); });
+  m.def("cudnn_get_version",
+        [] { return CachedVersion("cudnn", &CudnnGetVersion); });
+  m.def("cupti_get_version",
+        [] { return CachedVersion("cupti", &CuptiGetVersion); });
+  m.def("cufft_get_version",
+        [] { return CachedVersion("cufft", &CufftGetVersion); });
+  m.def("cusolver_get_version",
+        [] { return CachedVersion("cusolver", &CusolverGetVersion); });
+  m.def("cublas_get_version",
+        [] { return CachedVersion("cublas", &CublasGetVersion); });
+  m.def("cusparse_get_version",
+        [] { return CachedVersion("cusparse", &CusparseGetVersion); });
+  // Device-dependent queries are never cached.
   m.def("cuda_compute_capability", &CudaComputeCapability);
   m.def("cuda_device_count", &CudaDeviceCount);
+  // True if any version query so far was answered from the
+  // JAX_CUDA_VERSIONS_CACHE file rather than by probing a library.
+  m.def("from_cache", [] { return version_read_from_cache; });
 }
 
 }  // namespace
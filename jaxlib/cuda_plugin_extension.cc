@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "nanobind/nanobind.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "third_party/gpus/cuda/include/cuda.h"
 #include "jaxlib/kernel_nanobind_helpers.h"
 #include "xla/ffi/api/c_api.h"
@@ -31,15 +32,15 @@ limitations under the License.
 #include "xla/python/py_client_gpu.h"
 #include "xla/tsl/python/lib/core/numpy.h"
 #include "xla/util.h"
+#include "tsl/platform/errors.h"
+#include "tsl/platform/statusor.h"
 
 namespace nb = nanobind;
 
 namespace xla {
 namespace {
-Status RegisterCustomCallTarget(const PJRT_Api* c_api,
-                                const char* fn_name_c_str, size_t fn_name_size,
-                                nb::capsule fn, int api_version,
-                                XLA_FFI_Handler_Traits traits) {
+absl::StatusOr<const PJRT_Gpu_Custom_Call*> FindGpuCustomCallExtension(
+    const PJRT_Api* c_api) {
   if (c_api->extension_start == nullptr) {
     return Unimplemented("The plugin does not have extension.");
   }
@@ -53,7 +54,15 @@ Status RegisterCustomCallTarget(const PJRT_Api* c_api,
   if (next == nullptr) {
     return Unimplemented("The plugin does not have a custom call extension.");
   }
+  return reinterpret_cast<const PJRT_Gpu_Custom_Call*>(next);
+}
 
+Status RegisterCustomCallTargetImpl(const PJRT_Api* c_api,
+                                    const PJRT_Gpu_Custom_Call* custom_call,
+                                    const char* fn_name_c_str,
+                                    size_t fn_name_size, nb::capsule fn,
+                                    int api_version,
+                                    XLA_FFI_Handler_Traits traits) {
   if (traits != 0) {
     return Unimplemented("The plugin does not support custom call traits.");
   }
@@ -66,9 +75,34 @@ Status RegisterCustomCallTarget(const PJRT_Api* c_api,
   args.api_version = api_version;
 #endif
   args.custom_call_function = static_cast<void*>(fn.data());
-  RETURN_STATUS_IF_PJRT_ERROR(
-      reinterpret_cast<const PJRT_Gpu_Custom_Call*>(next)->custom_call(&args),
-      c_api);
+  RETURN_STATUS_IF_PJRT_ERROR(custom_call->custom_call(&args), c_api);
+  return OkStatus();
+}
+
+Status RegisterCustomCallTarget(const PJRT_Api* c_api,
+                                const char* fn_name_c_str, size_t fn_name_size,
+                                nb::capsule fn, int api_version,
+                                XLA_FFI_Handler_Traits traits) {
+  TF_ASSIGN_OR_RETURN(const PJRT_Gpu_Custom_Call* custom_call,
+                      FindGpuCustomCallExtension(c_api));
+  return RegisterCustomCallTargetImpl(c_api, custom_call, fn_name_c_str,
+                                      fn_name_size, std::move(fn), api_version,
+                                      traits);
+}
+
+// Registers a whole table of custom call targets with a single Python
+// boundary crossing; the extension lookup is done once for the batch.
+Status RegisterCustomCallTargets(const PJRT_Api* c_api, nb::dict targets,
+                                 int api_version,
+                                 XLA_FFI_Handler_Traits traits) {
+  TF_ASSIGN_OR_RETURN(const PJRT_Gpu_Custom_Call* custom_call,
+                      FindGpuCustomCallExtension(c_api));
+  for (auto [name, fn] : targets) {
+    nb::str fn_name = nb::cast<nb::str>(name);
+    TF_RETURN_IF_ERROR(RegisterCustomCallTargetImpl(
+        c_api, custom_call, fn_name.c_str(), nb::len(fn_name),
+        nb::cast<nb::capsule>(fn), api_version, traits));
+  }
   return OkStatus();
 }
 
@@ -117,6 +151,16 @@ NB_MODULE(cuda_plugin_extension, m) {
       nb::arg("c_api"), nb::arg("fn_name"), nb::arg("fn"),
       nb::arg("xla_platform_name"), nb::arg("api_version") = 0,
       nb::arg("traits") = 0);
+  m.def(
+      "register_custom_call_targets",
+      [](nb::capsule c_api, nb::dict targets, int api_version,
+         XLA_FFI_Handler_Traits traits) {
+        xla::ThrowIfError(RegisterCustomCallTargets(
+            static_cast<const PJRT_Api*>(c_api.data()), std::move(targets),
+            api_version, traits));
+      },
+      nb::arg("c_api"), nb::arg("targets"), nb::arg("api_version") = 0,
+      nb::arg("traits") = 0);
   m.def("registrations", &Registrations);
   m.def(
       "get_device_ordinal",
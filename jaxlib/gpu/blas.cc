@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -23,6 +24,8 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_format.h"
 #include "jaxlib/gpu/blas_kernels.h"
+#include "jaxlib/gpu/gpu_kernel_helpers.h"
+#include "jaxlib/handle_pool.h"
 #include "jaxlib/gpu/vendor.h"
 #include "jaxlib/kernel_nanobind_helpers.h"
 #include "xla/tsl/python/lib/core/numpy.h"
@@ -79,6 +82,31 @@ NB_MODULE(_blas, m) {
   m.def("registrations", &Registrations);
   m.def("build_getrf_batched_descriptor", &BuildGetrfBatchedDescriptor);
   m.def("build_geqrf_batched_descriptor", &BuildGeqrfBatchedDescriptor);
+  m.def(
+      "prewarm",
+      [](std::uintptr_t stream, int count) {
+        JAX_THROW_IF_ERROR(BlasHandlePool::Prewarm(
+            reinterpret_cast<gpuStream_t>(stream), count));
+      },
+      nb::arg("stream") = 0, nb::arg("count") = 1);
+  m.def("handle_pool_stats", []() {
+    HandlePoolStats stats = BlasHandlePool::GetStats();
+    nb::dict d;
+    d["created"] = stats.created;
+    d["destroyed"] = stats.destroyed;
+    d["borrowed"] = stats.borrowed;
+    d["idle"] = stats.idle;
+    nb::dict per_stream;
+    for (const auto& [stream, idle] : stats.idle_per_stream) {
+      per_stream[nb::int_(stream)] = idle;
+    }
+    d["idle_per_stream"] = per_stream;
+    return d;
+  });
+  m.def(
+      "set_handle_pool_capacity",
+      [](std::int64_t max_idle) { BlasHandlePool::SetCapacity(max_idle); },
+      nb::arg("max_idle"));
 }
 
 }  // namespace
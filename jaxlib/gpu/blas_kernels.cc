@@ -26,25 +26,20 @@ limitations under the License.
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
+#include "jaxlib/gpu/make_batch_pointers.h"
 #include "jaxlib/handle_pool.h"
 #include "jaxlib/kernel_helpers.h"
 #include "xla/service/custom_call_status.h"
 
 namespace jax {
 
-using BlasHandlePool = HandlePool<gpublasHandle_t, gpuStream_t>;
-
 template <>
 /*static*/ absl::StatusOr<BlasHandlePool::Handle> BlasHandlePool::Borrow(
     gpuStream_t stream) {
   BlasHandlePool* pool = Instance();
-  absl::MutexLock lock(&pool->mu_);
   gpublasHandle_t handle;
-  if (pool->handles_[stream].empty()) {
+  if (!pool->TryAcquire(stream, &handle)) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpublasCreate(&handle)));
-  } else {
-    handle = pool->handles_[stream].back();
-    pool->handles_[stream].pop_back();
   }
   if (stream) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpublasSetStream(handle, stream)));
@@ -52,6 +47,11 @@ template <>
   return Handle(pool, handle, stream);
 }
 
+template <>
+/*static*/ void BlasHandlePool::DestroyHandle(gpublasHandle_t handle) {
+  gpublasDestroy(handle);
+}
+
 namespace JAX_GPU_NAMESPACE {
 
 namespace {
@@ -89,13 +89,12 @@ static absl::Status GetrfBatched_(gpuStream_t stream, void** buffers,
 
   int* ipiv = static_cast<int*>(buffers[2]);
   int* info = static_cast<int*>(buffers[3]);
-  auto a_ptrs_host = MakeBatchPointers(stream, buffers[1], buffers[4], d.batch,
-                                       SizeOfBlasType(d.type) * d.n * d.n);
-  JAX_RETURN_IF_ERROR(a_ptrs_host.status());
-  // TODO(phawkins): ideally we would not need to synchronize here, but to
-  // avoid it we need a way to keep the host-side buffer alive until the copy
-  // completes.
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuStreamSynchronize(stream)));
+  // The pointer array is computed on device from (base, stride, count), so
+  // there is no host-side staging buffer to keep alive and no synchronization
+  // before the cuBLAS call.
+  MakeBatchPointersAsync(stream, buffers[1], buffers[4], d.batch,
+                         SizeOfBlasType(d.type) * d.n * d.n);
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuGetLastError()));
   switch (d.type) {
     case BlasType::F32: {
       float** batch_ptrs = static_cast<float**>(buffers[4]);
@@ -152,17 +151,14 @@ static absl::Status GeqrfBatched_(gpuStream_t stream, void** buffers,
   }
 
   std::vector<int> info(d.batch);
-  auto a_ptrs_host = MakeBatchPointers(stream, buffers[1], buffers[3], d.batch,
-                                       SizeOfBlasType(d.type) * d.m * d.n);
-  JAX_RETURN_IF_ERROR(a_ptrs_host.status());
-  auto tau_ptrs_host =
-      MakeBatchPointers(stream, buffers[2], buffers[4], d.batch,
-                        SizeOfBlasType(d.type) * std::min(d.m, d.n));
-  JAX_RETURN_IF_ERROR(tau_ptrs_host.status());
-  // TODO(phawkins): ideally we would not need to synchronize here, but to
-  // avoid it we need a way to keep the host-side buffer alive until the copy
-  // completes.
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuStreamSynchronize(stream)));
+  MakeBatchPointersAsync(stream, buffers[1], buffers[3], d.batch,
+                         SizeOfBlasType(d.type) * d.m * d.n);
+  // The tau pointer array aims cuBLAS directly into the contiguous output
+  // buffer at stride min(m, n), so the taus land in one strided write and no
+  // per-batch-element gather is needed afterwards.
+  MakeBatchPointersAsync(stream, buffers[2], buffers[4], d.batch,
+                         SizeOfBlasType(d.type) * std::min(d.m, d.n));
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuGetLastError()));
   switch (d.type) {
     case BlasType::F32: {
       float** a_batch_ptrs = static_cast<float**>(buffers[3]);
@@ -18,10 +18,19 @@ limitations under the License.
 
 #include <cstddef>
 
+#include "absl/status/statusor.h"
 #include "jaxlib/gpu/vendor.h"
+#include "jaxlib/handle_pool.h"
 #include "xla/service/custom_call_status.h"
 
 namespace jax {
+
+using BlasHandlePool = HandlePool<gpublasHandle_t, gpuStream_t>;
+
+template <>
+absl::StatusOr<BlasHandlePool::Handle> BlasHandlePool::Borrow(
+    gpuStream_t stream);
+
 namespace JAX_GPU_NAMESPACE {
 
 // Set of types known to Cusolver.
@@ -45,6 +45,12 @@ __device__ void drotg(T* da, T* db, T* c, T* s) {
   return;
 }
 
+// Number of columns each thread advances per wavefront step. Thread k owns
+// rotation k and sweeps its row in panels of this width, so one grid-wide
+// sync is amortized over a whole panel instead of a single column and the
+// total step count drops from 2 * nSize to nSize + nSize / kPanelWidth.
+constexpr int kPanelWidth = 8;
+
 template <typename T>
 __global__ void CholeskyUpdateKernel(
     T* rMatrix, T* uVector,
@@ -55,23 +61,32 @@ __global__ void CholeskyUpdateKernel(
 
   T c, s;
 
-  for (int step = 0; step < 2 * nSize; ++step) {
+  // Row k processes the panel of columns [p * kPanelWidth, (p + 1) *
+  // kPanelWidth) at step k + p. Row k + 1 then touches the same panel one
+  // step later, strictly after row k has rotated it, which preserves the
+  // rotation ordering of the original one-column-per-step wavefront.
+  int numPanels = (nSize + kPanelWidth - 1) / kPanelWidth;
+  for (int step = 0; step < nSize + numPanels; ++step) {
     grid.sync();
 
-    int i = step - k;
-    if (i < k || i >= nSize || k >= nSize) {
+    int p = step - k;
+    if (k >= nSize || p < k / kPanelWidth || p >= numPanels) {
       continue;
     }
-    if (i == k) {
-      drotg(
-          rMatrix + k * nSize + k,
-          uVector + k,
-          &c,
-          &s);
+    int begin = max(p * kPanelWidth, k);
+    int end = min((p + 1) * kPanelWidth, nSize);
+    for (int i = begin; i < end; ++i) {
+      if (i == k) {
+        drotg(
+            rMatrix + k * nSize + k,
+            uVector + k,
+            &c,
+            &s);
+      }
+      T r_i = c * rMatrix[k * nSize + i] - s * uVector[i];
+      uVector[i] = s * rMatrix[k * nSize + i] + c * uVector[i];
+      rMatrix[k * nSize + i] = r_i;
     }
-    T r_i = c * rMatrix[k * nSize + i] - s * uVector[i];
-    uVector[i] = s * rMatrix[k * nSize + i] + c * uVector[i];
-    rMatrix[k * nSize + i] = r_i;
   }
 }
 }  // namespace
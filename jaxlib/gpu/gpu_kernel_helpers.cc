@@ -15,12 +15,21 @@ limitations under the License.
 
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
 
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 
 namespace jax {
 namespace JAX_GPU_NAMESPACE {
@@ -328,5 +337,101 @@ absl::StatusOr<std::unique_ptr<void*[]>> MakeBatchPointers(
   return std::move(host_ptrs);
 }
 
+namespace {
+
+// Key identifying a captured launch sequence: the opaque descriptor plus the
+// buffer assignment it was captured against. XLA frequently reuses the same
+// buffer assignment for repeated executions of a computation, which is what
+// makes replaying worthwhile; a new assignment simply captures a new graph.
+struct GraphCacheKey {
+  std::string opaque;
+  std::vector<void*> buffers;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const GraphCacheKey& key) {
+    return H::combine(std::move(h), key.opaque, key.buffers);
+  }
+  bool operator==(const GraphCacheKey& other) const {
+    return opaque == other.opaque && buffers == other.buffers;
+  }
+};
+
+bool GraphCaptureEnabled() {
+  static const bool enabled = []() {
+    const char* env = std::getenv("JAX_GPU_GRAPH_CUSTOM_CALLS");
+    return env != nullptr && std::strcmp(env, "0") != 0;
+  }();
+  return enabled;
+}
+
+}  // namespace
+
+absl::Status RunWithOptionalGraphCapture(
+    gpuStream_t stream, const char* opaque, std::size_t opaque_len,
+    void** buffers, int num_buffers,
+    absl::FunctionRef<absl::Status(gpuStream_t)> enqueue) {
+  if (!GraphCaptureEnabled()) {
+    return enqueue(stream);
+  }
+  // Never nest captures: if the caller's stream is already being captured
+  // (e.g. by a higher-level graph), just enqueue directly into it.
+  gpustreamCaptureStatus_t capture_status;
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(gpuStreamIsCapturing(stream, &capture_status)));
+  if (capture_status == GPU_STREAM_CAPTURE_STATUS_ACTIVE) {
+    return enqueue(stream);
+  }
+
+  // Capture happens on a private stream so the caller's stream never enters
+  // capture mode; the instantiated graph is then launched on the caller's
+  // stream. One capture stream and graph cache per device, kept alive for the
+  // process.
+  struct DeviceCache {
+    gpuStream_t capture_stream = nullptr;
+    absl::flat_hash_map<GraphCacheKey, gpuGraphExec_t> graphs;
+  };
+  static absl::Mutex mu(absl::kConstInit);
+  static auto* caches ABSL_GUARDED_BY(mu) =
+      new absl::flat_hash_map<gpuDevice_t, DeviceCache>();
+
+  gpuDevice_t device;
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuCtxGetDevice(&device)));
+
+  GraphCacheKey key;
+  key.opaque.assign(opaque, opaque_len);
+  key.buffers.assign(buffers, buffers + num_buffers);
+
+  // The lock also serializes capture on the shared capture stream and
+  // launches of the same instantiated graph, which must not overlap.
+  absl::MutexLock lock(&mu);
+  DeviceCache& cache = (*caches)[device];
+  auto it = cache.graphs.find(key);
+  if (it == cache.graphs.end()) {
+    if (cache.capture_stream == nullptr) {
+      JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+          gpuStreamCreate(&cache.capture_stream, GPU_STREAM_NON_BLOCKING)));
+    }
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuStreamBeginCapture(
+        cache.capture_stream, GPU_STREAM_CAPTURE_MODE_THREAD_LOCAL)));
+    absl::Status enqueue_status = enqueue(cache.capture_stream);
+    gpuGraph_t graph = nullptr;
+    absl::Status end_status =
+        JAX_AS_STATUS(gpuStreamEndCapture(cache.capture_stream, &graph));
+    if (!enqueue_status.ok() || !end_status.ok()) {
+      if (graph != nullptr) {
+        gpuGraphDestroy(graph);
+      }
+      return enqueue_status.ok() ? end_status : enqueue_status;
+    }
+    gpuGraphExec_t exec;
+    absl::Status instantiate_status =
+        JAX_AS_STATUS(gpuGraphInstantiateWithFlags(&exec, graph, /*flags=*/0));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuGraphDestroy(graph)));
+    JAX_RETURN_IF_ERROR(instantiate_status);
+    it = cache.graphs.emplace(std::move(key), exec).first;
+  }
+  return JAX_AS_STATUS(gpuGraphLaunch(it->second, stream));
+}
+
 }  // namespace JAX_GPU_NAMESPACE
 }  // namespace jax
@@ -16,9 +16,11 @@ limitations under the License.
 #ifndef JAXLIB_GPU_GPU_KERNEL_HELPERS_H_
 #define JAXLIB_GPU_GPU_KERNEL_HELPERS_H_
 
+#include <cstddef>
 #include <memory>
 
 #include "absl/base/optimization.h"
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "jaxlib/gpu/vendor.h"
@@ -77,6 +79,20 @@ absl::StatusOr<std::unique_ptr<void*[]>> MakeBatchPointers(gpuStream_t stream,
                                                            int batch,
                                                            int batch_elem_size);
 
+// Runs `enqueue` with `stream`, or, when JAX_GPU_GRAPH_CUSTOM_CALLS=1 is set,
+// executes it as a GPU graph: the first call for a given (opaque descriptor,
+// buffer pointers) combination captures the launches `enqueue` issues on a
+// private capture stream and instantiates a graph, and every call replays the
+// instantiated graph on `stream`. This amortizes launch overhead for custom
+// calls that issue long sequences of small launches, at the cost of caching
+// one graph per buffer assignment. Only use this for enqueue functions whose
+// launch sequence is a pure function of the descriptor and buffer pointers
+// and that neither synchronize the stream nor touch pageable host memory.
+absl::Status RunWithOptionalGraphCapture(
+    gpuStream_t stream, const char* opaque, std::size_t opaque_len,
+    void** buffers, int num_buffers,
+    absl::FunctionRef<absl::Status(gpuStream_t)> enqueue);
+
 }  // namespace JAX_GPU_NAMESPACE
 }  // namespace jax
 
@@ -0,0 +1,315 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks for the GPU custom-call kernels, runnable without building
+// the rest of JAX. Each benchmark drives the same entry point XLA calls,
+// including descriptor unpacking and handle-pool borrowing, so the numbers
+// reflect what a lowered program pays per call. Kernel time is measured with
+// gpuEvents recorded around the call on the benchmark's stream and reported
+// through manual timing; host-side overhead is invisible to wall-clock-based
+// timers once launches overlap.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "jaxlib/gpu/gpu_kernel_helpers.h"
+#include "jaxlib/gpu/lu_pivot_kernels.h"
+#include "jaxlib/gpu/prng_kernels.h"
+#include "jaxlib/gpu/solver_kernels.h"
+#include "jaxlib/gpu/sparse_kernels.h"
+#include "jaxlib/gpu/vendor.h"
+#include "jaxlib/kernel_helpers.h"
+#include "xla/service/custom_call_status.h"
+#include "xla/service/custom_call_status_internal.h"
+
+namespace jax {
+namespace JAX_GPU_NAMESPACE {
+namespace {
+
+// Owning device allocation; contents are left uninitialized unless filled.
+class DeviceBuffer {
+ public:
+  explicit DeviceBuffer(std::size_t bytes) {
+    if (gpuMalloc(&ptr_, bytes) != gpuSuccess) {
+      ptr_ = nullptr;
+    }
+  }
+  ~DeviceBuffer() {
+    if (ptr_ != nullptr) {
+      gpuFree(ptr_);
+    }
+  }
+  DeviceBuffer(const DeviceBuffer&) = delete;
+  DeviceBuffer& operator=(const DeviceBuffer&) = delete;
+
+  void* get() const { return ptr_; }
+
+  template <typename T>
+  void Fill(const std::vector<T>& host) {
+    gpuMemcpy(ptr_, host.data(), host.size() * sizeof(T),
+              gpuMemcpyHostToDevice);
+  }
+
+ private:
+  void* ptr_ = nullptr;
+};
+
+// Runs `call` once per benchmark iteration with gpuEvents bracketing it on
+// `stream` and reports the elapsed device time. `call` must enqueue all of
+// its work on `stream`.
+template <typename F>
+void TimeWithEvents(benchmark::State& state, gpuStream_t stream, F&& call) {
+  gpuEvent_t start, stop;
+  gpuEventCreate(&start, GPU_EVENT_DEFAULT);
+  gpuEventCreate(&stop, GPU_EVENT_DEFAULT);
+  for (auto _ : state) {
+    gpuEventRecord(start, stream);
+    call();
+    gpuEventRecord(stop, stream);
+    gpuEventSynchronize(stop);
+    float ms = 0;
+    gpuEventElapsedTime(&ms, start, stop);
+    state.SetIterationTime(ms / 1e3);
+  }
+  gpuEventDestroy(start);
+  gpuEventDestroy(stop);
+}
+
+// Fails the benchmark if the custom call reported an error.
+bool CheckCallOk(benchmark::State& state, XlaCustomCallStatus* status) {
+  auto message = xla::CustomCallStatusGetMessage(status);
+  if (message.has_value()) {
+    state.SkipWithError(std::string(*message).c_str());
+    return false;
+  }
+  return true;
+}
+
+gpuStream_t BenchmarkStream() {
+  static gpuStream_t stream = [] {
+    gpuStream_t s;
+    gpuStreamCreate(&s, GPU_STREAM_NON_BLOCKING);
+    return s;
+  }();
+  return stream;
+}
+
+void BM_ThreeFry2x32(benchmark::State& state) {
+  gpuStream_t stream = BenchmarkStream();
+  std::int64_t n = state.range(0);
+  std::string opaque = PackDescriptorAsString(ThreeFry2x32Descriptor{n});
+  DeviceBuffer key0(sizeof(std::uint32_t)), key1(sizeof(std::uint32_t));
+  DeviceBuffer data0(n * sizeof(std::uint32_t)),
+      data1(n * sizeof(std::uint32_t));
+  DeviceBuffer out0(n * sizeof(std::uint32_t)),
+      out1(n * sizeof(std::uint32_t));
+  void* buffers[] = {key0.get(),  key1.get(), data0.get(),
+                     data1.get(), out0.get(), out1.get()};
+  XlaCustomCallStatus status;
+  TimeWithEvents(state, stream, [&] {
+    ThreeFry2x32(stream, buffers, opaque.data(), opaque.size(), &status);
+  });
+  if (!CheckCallOk(state, &status)) return;
+  state.SetItemsProcessed(state.iterations() * 2 * n);
+}
+BENCHMARK(BM_ThreeFry2x32)
+    ->Arg(1 << 10)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24)
+    ->UseManualTime();
+
+void BM_Philox4x32(benchmark::State& state) {
+  gpuStream_t stream = BenchmarkStream();
+  std::int64_t n = state.range(0);
+  std::string opaque = PackDescriptorAsString(Philox4x32Descriptor{n});
+  DeviceBuffer key0(sizeof(std::uint32_t)), key1(sizeof(std::uint32_t));
+  DeviceBuffer data0(n * sizeof(std::uint32_t)),
+      data1(n * sizeof(std::uint32_t)), data2(n * sizeof(std::uint32_t)),
+      data3(n * sizeof(std::uint32_t));
+  DeviceBuffer out0(n * sizeof(std::uint32_t)), out1(n * sizeof(std::uint32_t)),
+      out2(n * sizeof(std::uint32_t)), out3(n * sizeof(std::uint32_t));
+  void* buffers[] = {key0.get(),  key1.get(),  data0.get(), data1.get(),
+                     data2.get(), data3.get(), out0.get(),  out1.get(),
+                     out2.get(),  out3.get()};
+  XlaCustomCallStatus status;
+  TimeWithEvents(state, stream, [&] {
+    Philox4x32(stream, buffers, opaque.data(), opaque.size(), &status);
+  });
+  if (!CheckCallOk(state, &status)) return;
+  state.SetItemsProcessed(state.iterations() * 4 * n);
+}
+BENCHMARK(BM_Philox4x32)
+    ->Arg(1 << 10)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24)
+    ->UseManualTime();
+
+void BM_ThreeFry2x32Dropout(benchmark::State& state) {
+  gpuStream_t stream = BenchmarkStream();
+  std::int64_t n = state.range(0);
+  std::string opaque =
+      PackDescriptorAsString(ThreeFry2x32DropoutDescriptor{n, /*rate=*/0.5f});
+  DeviceBuffer key0(sizeof(std::uint32_t)), key1(sizeof(std::uint32_t));
+  DeviceBuffer ctr0(n * sizeof(std::uint32_t)), ctr1(n * sizeof(std::uint32_t));
+  DeviceBuffer in(n * sizeof(float)), out(n * sizeof(float));
+  void* buffers[] = {key0.get(), key1.get(), ctr0.get(),
+                     ctr1.get(), in.get(),   out.get()};
+  XlaCustomCallStatus status;
+  TimeWithEvents(state, stream, [&] {
+    ThreeFry2x32Dropout(stream, buffers, opaque.data(), opaque.size(), &status);
+  });
+  if (!CheckCallOk(state, &status)) return;
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_ThreeFry2x32Dropout)
+    ->Arg(1 << 16)
+    ->Arg(1 << 20)
+    ->Arg(1 << 24)
+    ->UseManualTime();
+
+void BM_LuPivotsToPermutation(benchmark::State& state) {
+  gpuStream_t stream = BenchmarkStream();
+  std::int64_t batch = state.range(0);
+  std::int32_t pivot_size = static_cast<std::int32_t>(state.range(1));
+  std::int32_t permutation_size = pivot_size;
+  std::vector<std::int32_t> host_pivots(batch * pivot_size);
+  for (std::int64_t i = 0; i < batch; ++i) {
+    // Identity pivots are valid for any size and exercise the full loop.
+    for (std::int32_t j = 0; j < pivot_size; ++j) {
+      host_pivots[i * pivot_size + j] = j;
+    }
+  }
+  DeviceBuffer pivots(host_pivots.size() * sizeof(std::int32_t));
+  pivots.Fill(host_pivots);
+  DeviceBuffer permutation(batch * permutation_size * sizeof(std::int32_t));
+  TimeWithEvents(state, stream, [&] {
+    LaunchLuPivotsToPermutationKernel(
+        stream, batch, pivot_size, permutation_size,
+        static_cast<const std::int32_t*>(pivots.get()),
+        static_cast<std::int32_t*>(permutation.get()));
+  });
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_LuPivotsToPermutation)
+    ->Args({1, 512})
+    ->Args({256, 32})
+    ->Args({4096, 8})
+    ->UseManualTime();
+
+void BM_Getrf(benchmark::State& state) {
+  gpuStream_t stream = BenchmarkStream();
+  int batch = static_cast<int>(state.range(0));
+  int n = static_cast<int>(state.range(1));
+  auto handle = SolverHandlePool::Borrow(stream);
+  if (!handle.ok()) {
+    state.SkipWithError(std::string(handle.status().message()).c_str());
+    return;
+  }
+  int lwork = 0;
+  gpusolverDnSgetrf_bufferSize(handle->get(), n, n, /*A=*/nullptr, n, &lwork);
+  std::string opaque = PackDescriptorAsString(
+      GetrfDescriptor{SolverType::F32, batch, n, n, lwork});
+  std::size_t a_bytes =
+      static_cast<std::size_t>(batch) * n * n * sizeof(float);
+  // A diagonally dominant matrix keeps getrf off its pivoting slow paths.
+  std::vector<float> host_a(static_cast<std::size_t>(batch) * n * n, 0.01f);
+  for (int b = 0; b < batch; ++b) {
+    for (int i = 0; i < n; ++i) {
+      host_a[static_cast<std::size_t>(b) * n * n + i * n + i] = n;
+    }
+  }
+  DeviceBuffer a_in(a_bytes), a_out(a_bytes);
+  a_in.Fill(host_a);
+  DeviceBuffer ipiv(static_cast<std::size_t>(batch) * n * sizeof(int));
+  DeviceBuffer info(batch * sizeof(int));
+  DeviceBuffer workspace(static_cast<std::size_t>(lwork) * sizeof(float));
+  void* buffers[] = {a_in.get(), a_out.get(), ipiv.get(), info.get(),
+                     workspace.get()};
+  XlaCustomCallStatus status;
+  TimeWithEvents(state, stream, [&] {
+    Getrf(stream, buffers, opaque.data(), opaque.size(), &status);
+  });
+  if (!CheckCallOk(state, &status)) return;
+  state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_Getrf)
+    ->Args({1, 256})
+    ->Args({1, 1024})
+    ->Args({16, 128})
+    ->UseManualTime();
+
+#if JAX_GPU_HAVE_SPARSE
+
+void BM_CsrMatvec(benchmark::State& state) {
+  gpuStream_t stream = BenchmarkStream();
+  int rows = static_cast<int>(state.range(0));
+  int cols = rows;
+  int nnz_per_row = static_cast<int>(state.range(1));
+  int nnz = rows * nnz_per_row;
+  CsrMatvecDescriptor descriptor;
+  descriptor.A = SparseMatDescriptor{GPU_R_32F, GPUSPARSE_INDEX_32I, rows, cols,
+                                     nnz};
+  descriptor.x = DenseVecDescriptor{GPU_R_32F, cols};
+  descriptor.y = DenseVecDescriptor{GPU_R_32F, rows};
+  descriptor.op = GPUSPARSE_OPERATION_NON_TRANSPOSE;
+  std::string opaque = PackDescriptorAsString(descriptor);
+  std::vector<float> host_values(nnz, 1.0f);
+  std::vector<int> host_col_ind(nnz);
+  std::vector<int> host_row_offsets(rows + 1);
+  for (int i = 0; i < rows; ++i) {
+    host_row_offsets[i] = i * nnz_per_row;
+    for (int j = 0; j < nnz_per_row; ++j) {
+      // Spread the nonzeros evenly across the row's columns.
+      host_col_ind[i * nnz_per_row + j] = j * (cols / nnz_per_row);
+    }
+  }
+  host_row_offsets[rows] = nnz;
+  DeviceBuffer values(nnz * sizeof(float));
+  values.Fill(host_values);
+  DeviceBuffer col_ind(nnz * sizeof(int));
+  col_ind.Fill(host_col_ind);
+  DeviceBuffer row_offsets((rows + 1) * sizeof(int));
+  row_offsets.Fill(host_row_offsets);
+  DeviceBuffer x(cols * sizeof(float)), y(rows * sizeof(float));
+  // The lowering sizes this via SpMV_bufferSize; over-allocate instead of
+  // replicating that query here.
+  DeviceBuffer workspace(std::size_t{16} << 20);
+  void* buffers[] = {values.get(), col_ind.get(), row_offsets.get(),
+                     x.get(),      y.get(),       workspace.get()};
+  XlaCustomCallStatus status;
+  TimeWithEvents(state, stream, [&] {
+    CsrMatvec(stream, buffers, opaque.data(), opaque.size(), &status);
+  });
+  if (!CheckCallOk(state, &status)) return;
+  state.SetItemsProcessed(state.iterations() * nnz);
+}
+BENCHMARK(BM_CsrMatvec)
+    ->Args({1 << 14, 8})
+    ->Args({1 << 16, 32})
+    ->Args({1 << 18, 64})
+    ->UseManualTime();
+
+#endif  // JAX_GPU_HAVE_SPARSE
+
+}  // namespace
+}  // namespace JAX_GPU_NAMESPACE
+}  // namespace jax
+
+BENCHMARK_MAIN();
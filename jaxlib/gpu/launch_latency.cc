@@ -0,0 +1,93 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "jaxlib/gpu/launch_latency.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/numeric/bits.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace jax {
+
+namespace {
+
+struct AtomicHistogram {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> total_ns{0};
+  std::atomic<uint64_t> buckets[kLaunchLatencyBuckets] = {};
+};
+
+absl::Mutex registry_mutex;
+absl::flat_hash_map<std::string, std::unique_ptr<AtomicHistogram>>&
+Registry() {
+  static auto& registry =
+      *new absl::flat_hash_map<std::string, std::unique_ptr<AtomicHistogram>>;
+  return registry;
+}
+
+}  // namespace
+
+void RecordLaunchLatency(absl::string_view kernel_name, uint64_t ns) {
+  AtomicHistogram* histogram = nullptr;
+  {
+    absl::ReaderMutexLock lock(&registry_mutex);
+    auto it = Registry().find(kernel_name);
+    if (it != Registry().end()) {
+      histogram = it->second.get();
+    }
+  }
+  if (histogram == nullptr) {
+    absl::MutexLock lock(&registry_mutex);
+    std::unique_ptr<AtomicHistogram>& slot = Registry()[kernel_name];
+    if (!slot) {
+      slot = std::make_unique<AtomicHistogram>();
+    }
+    histogram = slot.get();
+  }
+  int bucket = absl::bit_width(ns | 1) - 1;
+  if (bucket >= kLaunchLatencyBuckets) {
+    bucket = kLaunchLatencyBuckets - 1;
+  }
+  histogram->count.fetch_add(1, std::memory_order_relaxed);
+  histogram->total_ns.fetch_add(ns, std::memory_order_relaxed);
+  histogram->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<std::pair<std::string, LaunchLatencyHistogram>>
+SnapshotLaunchLatencies() {
+  std::vector<std::pair<std::string, LaunchLatencyHistogram>> snapshot;
+  absl::ReaderMutexLock lock(&registry_mutex);
+  snapshot.reserve(Registry().size());
+  for (const auto& [name, histogram] : Registry()) {
+    LaunchLatencyHistogram out;
+    out.count = histogram->count.load(std::memory_order_relaxed);
+    out.total_ns = histogram->total_ns.load(std::memory_order_relaxed);
+    for (int i = 0; i < kLaunchLatencyBuckets; ++i) {
+      out.buckets[i] = histogram->buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.emplace_back(name, out);
+  }
+  return snapshot;
+}
+
+}  // namespace jax
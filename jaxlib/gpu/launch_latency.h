@@ -0,0 +1,51 @@
+/* Copyright 2024 The JAX Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef JAXLIB_GPU_LAUNCH_LATENCY_H_
+#define JAXLIB_GPU_LAUNCH_LATENCY_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace jax {
+
+// Number of power-of-two latency buckets; bucket i counts samples in
+// [2^i, 2^(i+1)) nanoseconds, with the last bucket absorbing the tail.
+inline constexpr int kLaunchLatencyBuckets = 32;
+
+// Snapshot of one kernel's launch-latency histogram. Counters are cumulative
+// since process start; scrapers compute rates from deltas between snapshots.
+struct LaunchLatencyHistogram {
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t buckets[kLaunchLatencyBuckets] = {};
+};
+
+// Records one wall-time sample for the given kernel name. Thread-safe; after
+// the first sample for a name this is a reader-lock lookup plus three relaxed
+// atomic increments, cheap enough to leave enabled in production.
+void RecordLaunchLatency(absl::string_view kernel_name, uint64_t ns);
+
+// Returns a snapshot of all histograms recorded so far, keyed by kernel name.
+std::vector<std::pair<std::string, LaunchLatencyHistogram>>
+SnapshotLaunchLatencies();
+
+}  // namespace jax
+
+#endif  // JAXLIB_GPU_LAUNCH_LATENCY_H_
@@ -59,6 +59,49 @@ __global__ void LuPivotsToPermutationKernel(
   }
 }
 
+// Largest permutation (in int32 entries) staged in shared memory by the
+// block-cooperative kernel; 48 KiB, the portable static shared-memory limit.
+constexpr std::int32_t kMaxSharedPermutationSize = 12288;
+
+// Block-cooperative variant: one block per batch element. The identity
+// initialization and the write-back are parallel and coalesced; only the
+// inherently sequential swap walk runs on a single thread, and it runs over
+// shared memory instead of global. This matters most for batch-1 large-n
+// decode after getrf, where the per-thread kernel degenerates to a single
+// active thread doing O(n) global-memory round trips.
+__global__ void LuPivotsToPermutationBlockKernel(
+    const std::int32_t* pivots, std::int32_t* permutation_out,
+    const std::int64_t batch_size, const std::int32_t pivot_size,
+    const std::int32_t permutation_size) {
+  extern __shared__ std::int32_t scratch[];
+  for (std::int64_t idx = blockIdx.x; idx < batch_size; idx += gridDim.x) {
+    const std::int32_t* batch_pivots = pivots + idx * pivot_size;
+    std::int32_t* batch_out = permutation_out + idx * permutation_size;
+
+    for (std::int32_t i = threadIdx.x; i < permutation_size; i += blockDim.x) {
+      scratch[i] = i;
+    }
+    __syncthreads();
+
+    if (threadIdx.x == 0) {
+      for (std::int32_t i = 0; i < pivot_size; ++i) {
+        if ((batch_pivots[i] < 0) || (batch_pivots[i] >= permutation_size)) {
+          continue;
+        }
+        std::int32_t swap_temporary = scratch[i];
+        scratch[i] = scratch[batch_pivots[i]];
+        scratch[batch_pivots[i]] = swap_temporary;
+      }
+    }
+    __syncthreads();
+
+    for (std::int32_t i = threadIdx.x; i < permutation_size; i += blockDim.x) {
+      batch_out[i] = scratch[i];
+    }
+    __syncthreads();
+  }
+}
+
 }  // namespace
 
 void LaunchLuPivotsToPermutationKernel(gpuStream_t stream,
@@ -67,6 +110,17 @@ void LaunchLuPivotsToPermutationKernel(gpuStream_t stream,
                                        std::int32_t permutation_size,
                                        const std::int32_t* pivots,
                                        std::int32_t* permutation) {
+  if (permutation_size <= kMaxSharedPermutationSize) {
+    const int block_dim = 256;
+    const std::int64_t grid_dim = std::min<std::int64_t>(1024, batch_size);
+    LuPivotsToPermutationBlockKernel<<<
+        grid_dim, block_dim,
+        /*dynamic_shared_mem_bytes=*/permutation_size * sizeof(std::int32_t),
+        stream>>>(pivots, permutation, batch_size, pivot_size,
+                  permutation_size);
+    return;
+  }
+
   const int block_dim = 128;
   const std::int64_t grid_dim =
       std::min<std::int64_t>(1024, (batch_size + block_dim - 1) / block_dim);
@@ -26,9 +26,18 @@ namespace nb = nanobind;
 std::string BuildThreeFry2x32Descriptor(std::int64_t n) {
   return PackDescriptorAsString(ThreeFry2x32Descriptor{n});
 }
+std::string BuildThreeFry2x32DropoutDescriptor(std::int64_t n, float rate) {
+  return PackDescriptorAsString(ThreeFry2x32DropoutDescriptor{n, rate});
+}
+std::string BuildPhilox4x32Descriptor(std::int64_t n) {
+  return PackDescriptorAsString(Philox4x32Descriptor{n});
+}
 nb::dict Registrations() {
   nb::dict dict;
   dict[JAX_GPU_PREFIX "_threefry2x32"] = EncapsulateFunction(ThreeFry2x32);
+  dict[JAX_GPU_PREFIX "_threefry2x32_dropout"] =
+      EncapsulateFunction(ThreeFry2x32Dropout);
+  dict[JAX_GPU_PREFIX "_philox4x32"] = EncapsulateFunction(Philox4x32);
   return dict;
 }
 
@@ -38,6 +47,14 @@ NB_MODULE(_prng, m) {
     std::string result = BuildThreeFry2x32Descriptor(n);
     return nb::bytes(result.data(), result.size());
   });
+  m.def("threefry2x32_dropout_descriptor", [](std::int64_t n, float rate) {
+    std::string result = BuildThreeFry2x32DropoutDescriptor(n, rate);
+    return nb::bytes(result.data(), result.size());
+  });
+  m.def("philox4x32_descriptor", [](std::int64_t n) {
+    std::string result = BuildPhilox4x32Descriptor(n);
+    return nb::bytes(result.data(), result.size());
+  });
 }
 
 }  // namespace
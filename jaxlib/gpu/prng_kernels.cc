@@ -34,6 +34,24 @@ absl::Status ThreeFry2x32_(gpuStream_t stream, void** buffers,
   return absl::OkStatus();
 }
 
+absl::Status ThreeFry2x32Dropout_(gpuStream_t stream, void** buffers,
+                                  const char* opaque, std::size_t opaque_len) {
+  auto s = UnpackDescriptor<ThreeFry2x32DropoutDescriptor>(opaque, opaque_len);
+  JAX_RETURN_IF_ERROR(s.status());
+  LaunchThreeFry2x32DropoutKernel(stream, buffers, **s);
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuGetLastError()));
+  return absl::OkStatus();
+}
+
+absl::Status Philox4x32_(gpuStream_t stream, void** buffers,
+                         const char* opaque, std::size_t opaque_len) {
+  auto s = UnpackDescriptor<Philox4x32Descriptor>(opaque, opaque_len);
+  JAX_RETURN_IF_ERROR(s.status());
+  LaunchPhilox4x32Kernel(stream, buffers, **s);
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuGetLastError()));
+  return absl::OkStatus();
+}
+
 }  // namespace
 
 void ThreeFry2x32(gpuStream_t stream, void** buffers, const char* opaque,
@@ -45,5 +63,23 @@ void ThreeFry2x32(gpuStream_t stream, void** buffers, const char* opaque,
   }
 }
 
+void ThreeFry2x32Dropout(gpuStream_t stream, void** buffers, const char* opaque,
+                         size_t opaque_len, XlaCustomCallStatus* status) {
+  auto s = ThreeFry2x32Dropout_(stream, buffers, opaque, opaque_len);
+  if (!s.ok()) {
+    std::string_view message = s.message();
+    XlaCustomCallStatusSetFailure(status, message.data(), message.length());
+  }
+}
+
+void Philox4x32(gpuStream_t stream, void** buffers, const char* opaque,
+                size_t opaque_len, XlaCustomCallStatus* status) {
+  auto s = Philox4x32_(stream, buffers, opaque, opaque_len);
+  if (!s.ok()) {
+    std::string_view message = s.message();
+    XlaCustomCallStatusSetFailure(status, message.data(), message.length());
+  }
+}
+
 }  // namespace JAX_GPU_NAMESPACE
 }  // namespace jax
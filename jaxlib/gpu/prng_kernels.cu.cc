@@ -25,6 +25,73 @@ namespace jax {
 namespace JAX_GPU_NAMESPACE {
 namespace {
 
+// Encrypts one 2x32-bit block. The round schedule is fully unrolled so the
+// rotation distances become immediates.
+__device__ __forceinline__ void ThreeFry2x32Block(std::uint32_t k0,
+                                                  std::uint32_t k1,
+                                                  std::uint32_t* x) {
+  // Rotation distances specified by the Threefry2x32 algorithm.
+  constexpr std::uint32_t rotations[8] = {13, 15, 26, 6, 17, 29, 16, 24};
+  std::uint32_t ks[3];
+
+  // 0x1BD11BDA is a parity constant specified by the ThreeFry2x32 algorithm.
+  ks[0] = k0;
+  ks[1] = k1;
+  ks[2] = 0x1BD11BDA ^ k0 ^ k1;
+
+  auto rotate_left = [](std::uint32_t v, std::uint32_t distance) {
+    return (v << distance) | (v >> (32 - distance));
+  };
+
+  // Performs a single round of the Threefry2x32 algorithm, with a rotation
+  // amount 'rotation'.
+  auto round = [&](std::uint32_t* v, std::uint32_t rotation) {
+    v[0] += v[1];
+    v[1] = rotate_left(v[1], rotation);
+    v[1] ^= v[0];
+  };
+
+  // There are no known statistical flaws with 13 rounds of Threefry2x32.
+  // We are conservative and use 20 rounds.
+  x[0] = x[0] + ks[0];
+  x[1] = x[1] + ks[1];
+#pragma unroll
+  for (int i = 0; i < 4; ++i) {
+    round(x, rotations[i]);
+  }
+
+  x[0] = x[0] + ks[1];
+  x[1] = x[1] + ks[2] + 1u;
+#pragma unroll
+  for (int i = 4; i < 8; ++i) {
+    round(x, rotations[i]);
+  }
+
+  x[0] = x[0] + ks[2];
+  x[1] = x[1] + ks[0] + 2u;
+#pragma unroll
+  for (int i = 0; i < 4; ++i) {
+    round(x, rotations[i]);
+  }
+
+  x[0] = x[0] + ks[0];
+  x[1] = x[1] + ks[1] + 3u;
+#pragma unroll
+  for (int i = 4; i < 8; ++i) {
+    round(x, rotations[i]);
+  }
+
+  x[0] = x[0] + ks[1];
+  x[1] = x[1] + ks[2] + 4u;
+#pragma unroll
+  for (int i = 0; i < 4; ++i) {
+    round(x, rotations[i]);
+  }
+
+  x[0] = x[0] + ks[2];
+  x[1] = x[1] + ks[0] + 5u;
+}
+
 __global__ void ThreeFry2x32Kernel(const std::uint32_t* key0,
                                    const std::uint32_t* key1,
                                    const std::uint32_t* data0,
@@ -38,68 +105,121 @@ __global__ void ThreeFry2x32Kernel(const std::uint32_t* key0,
 
   for (std::int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < n;
        idx += blockDim.x * gridDim.x) {
-    // Rotation distances specified by the Threefry2x32 algorithm.
-    std::uint32_t rotations[8] = {13, 15, 26, 6, 17, 29, 16, 24};
-    std::uint32_t x[2];
-    std::uint32_t ks[3];
-
-    // 0x1BD11BDA is a parity constant specified by the ThreeFry2x32 algorithm.
-    ks[2] = 0x1BD11BDA;
-
-    ks[0] = key0[idx];
-    x[0] = data0[idx];
-    ks[2] = ks[2] ^ key0[idx];
-
-    ks[1] = key1[idx];
-    x[1] = data1[idx];
-    ks[2] = ks[2] ^ key1[idx];
-
-    auto rotate_left = [](std::uint32_t v, std::uint32_t distance) {
-      return (v << distance) | (v >> (32 - distance));
-    };
-
-    // Performs a single round of the Threefry2x32 algorithm, with a rotation
-    // amount 'rotation'.
-    auto round = [&](std::uint32_t* v, std::uint32_t rotation) {
-      v[0] += v[1];
-      v[1] = rotate_left(v[1], rotation);
-      v[1] ^= v[0];
-    };
-
-    // There are no known statistical flaws with 13 rounds of Threefry2x32.
-    // We are conservative and use 20 rounds.
-    x[0] = x[0] + ks[0];
-    x[1] = x[1] + ks[1];
-    for (int i = 0; i < 4; ++i) {
-      round(x, rotations[i]);
-    }
+    std::uint32_t x[2] = {data0[idx], data1[idx]};
+    ThreeFry2x32Block(key0[idx], key1[idx], x);
+    out0[idx] = x[0];
+    out1[idx] = x[1];
+  }
+}
 
-    x[0] = x[0] + ks[1];
-    x[1] = x[1] + ks[2] + 1u;
-    for (int i = 4; i < 8; ++i) {
-      round(x, rotations[i]);
-    }
+// Vectorized variant: each thread loads four counter pairs with 128-bit loads
+// and writes them back with 128-bit stores, quadrupling the bytes in flight
+// per memory instruction. `n4` is the number of uint4 elements (n / 4); the
+// scalar kernel handles any remainder.
+__global__ void ThreeFry2x32Vec4Kernel(const uint4* key0, const uint4* key1,
+                                       const uint4* data0, const uint4* data1,
+                                       uint4* out0, uint4* out1,
+                                       std::int64_t n4) {
+  for (std::int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < n4;
+       idx += blockDim.x * gridDim.x) {
+    uint4 k0 = key0[idx];
+    uint4 k1 = key1[idx];
+    uint4 d0 = data0[idx];
+    uint4 d1 = data1[idx];
+    std::uint32_t x[4][2] = {
+        {d0.x, d1.x}, {d0.y, d1.y}, {d0.z, d1.z}, {d0.w, d1.w}};
+    ThreeFry2x32Block(k0.x, k1.x, x[0]);
+    ThreeFry2x32Block(k0.y, k1.y, x[1]);
+    ThreeFry2x32Block(k0.z, k1.z, x[2]);
+    ThreeFry2x32Block(k0.w, k1.w, x[3]);
+    out0[idx] = uint4{x[0][0], x[1][0], x[2][0], x[3][0]};
+    out1[idx] = uint4{x[0][1], x[1][1], x[2][1], x[3][1]};
+  }
+}
 
-    x[0] = x[0] + ks[2];
-    x[1] = x[1] + ks[0] + 2u;
-    for (int i = 0; i < 4; ++i) {
-      round(x, rotations[i]);
-    }
+bool IsAligned16(const void* ptr) {
+  return reinterpret_cast<std::uintptr_t>(ptr) % 16 == 0;
+}
 
-    x[0] = x[0] + ks[0];
-    x[1] = x[1] + ks[1] + 3u;
-    for (int i = 4; i < 8; ++i) {
-      round(x, rotations[i]);
+// Generates random bits and applies the dropout mask in one pass over the
+// activations. Each counter pair yields two 32-bit words, enough for two
+// uniform samples, so one cipher invocation covers two elements.
+__global__ void ThreeFry2x32DropoutKernel(const std::uint32_t* key0,
+                                          const std::uint32_t* key1,
+                                          const std::uint32_t* data0,
+                                          const std::uint32_t* data1,
+                                          const float* in, float* out,
+                                          std::int64_t n, float rate,
+                                          float scale) {
+  const std::int64_t n2 = (n + 1) / 2;
+  for (std::int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < n2;
+       idx += blockDim.x * gridDim.x) {
+    std::uint32_t x[2] = {data0[idx], data1[idx]};
+    ThreeFry2x32Block(key0[idx], key1[idx], x);
+    // Map the high 24 bits to a uniform float in [0, 1).
+    float u0 = (x[0] >> 8) * (1.0f / 16777216.0f);
+    float u1 = (x[1] >> 8) * (1.0f / 16777216.0f);
+    std::int64_t i0 = 2 * idx;
+    std::int64_t i1 = i0 + 1;
+    out[i0] = u0 < rate ? 0.0f : in[i0] * scale;
+    if (i1 < n) {
+      out[i1] = u1 < rate ? 0.0f : in[i1] * scale;
     }
+  }
+}
 
-    x[0] = x[0] + ks[1];
-    x[1] = x[1] + ks[2] + 4u;
-    for (int i = 0; i < 4; ++i) {
-      round(x, rotations[i]);
-    }
+// Encrypts one 4x32-bit block under a 2x32-bit key with Philox4x32-10.
+// Multiplies replace ThreeFry's rotate-xor rounds; ten rounds are the
+// standard recommendation from the Random123 paper.
+__device__ __forceinline__ void Philox4x32Block(std::uint32_t k0,
+                                                std::uint32_t k1,
+                                                std::uint32_t* x) {
+  // Multiplier and key-schedule ("Weyl sequence") constants specified by the
+  // Philox4x32 algorithm.
+  constexpr std::uint32_t kPhiloxM0 = 0xD2511F53;
+  constexpr std::uint32_t kPhiloxM1 = 0xCD9E8D57;
+  constexpr std::uint32_t kPhiloxW0 = 0x9E3779B9;
+  constexpr std::uint32_t kPhiloxW1 = 0xBB67AE85;
+
+#pragma unroll
+  for (int round = 0; round < 10; ++round) {
+    std::uint32_t lo0 = kPhiloxM0 * x[0];
+    std::uint32_t hi0 = __umulhi(kPhiloxM0, x[0]);
+    std::uint32_t lo1 = kPhiloxM1 * x[2];
+    std::uint32_t hi1 = __umulhi(kPhiloxM1, x[2]);
+    std::uint32_t y1 = x[1];
+    std::uint32_t y3 = x[3];
+    x[0] = hi1 ^ y1 ^ k0;
+    x[1] = lo1;
+    x[2] = hi0 ^ y3 ^ k1;
+    x[3] = lo0;
+    k0 += kPhiloxW0;
+    k1 += kPhiloxW1;
+  }
+}
 
-    out0[idx] = x[0] + ks[2];
-    out1[idx] = x[1] + ks[0] + 5u;
+__global__ void Philox4x32Kernel(const std::uint32_t* key0,
+                                 const std::uint32_t* key1,
+                                 const std::uint32_t* data0,
+                                 const std::uint32_t* data1,
+                                 const std::uint32_t* data2,
+                                 const std::uint32_t* data3,
+                                 std::uint32_t* out0, std::uint32_t* out1,
+                                 std::uint32_t* out2, std::uint32_t* out3,
+                                 std::int64_t n, const std::int64_t* n_ptr) {
+  if (n < 0) {
+    // n is stored in device memory.
+    n = *n_ptr;
+  }
+
+  for (std::int64_t idx = blockIdx.x * blockDim.x + threadIdx.x; idx < n;
+       idx += blockDim.x * gridDim.x) {
+    std::uint32_t x[4] = {data0[idx], data1[idx], data2[idx], data3[idx]};
+    Philox4x32Block(key0[idx], key1[idx], x);
+    out0[idx] = x[0];
+    out1[idx] = x[1];
+    out2[idx] = x[2];
+    out3[idx] = x[3];
   }
 }
 
@@ -126,6 +246,38 @@ void LaunchThreeFry2x32Kernel(gpuStream_t stream, void** buffers,
   out[0] = reinterpret_cast<std::uint32_t*>(buffers[output_idx]);
   out[1] = reinterpret_cast<std::uint32_t*>(buffers[output_idx + 1]);
   const int block_dim = 128;
+
+  // When the size is known on the host and all six buffers are 16-byte
+  // aligned, take the 128-bit vectorized path; a scalar launch mops up the
+  // last n % 4 elements. XLA allocates buffers at 16-byte (or larger)
+  // granularity, so the alignment check virtually always passes; it guards
+  // against other callers handing us offset views.
+  const std::int64_t n4 = n / 4;
+  if (n4 >= block_dim && IsAligned16(keys[0]) && IsAligned16(keys[1]) &&
+      IsAligned16(data[0]) && IsAligned16(data[1]) && IsAligned16(out[0]) &&
+      IsAligned16(out[1])) {
+    const std::int64_t vec_grid_dim =
+        std::min<std::int64_t>(1024, (n4 + block_dim - 1) / block_dim);
+    ThreeFry2x32Vec4Kernel<<<vec_grid_dim, block_dim,
+                             /*dynamic_shared_mem_bytes=*/0, stream>>>(
+        reinterpret_cast<const uint4*>(keys[0]),
+        reinterpret_cast<const uint4*>(keys[1]),
+        reinterpret_cast<const uint4*>(data[0]),
+        reinterpret_cast<const uint4*>(data[1]),
+        reinterpret_cast<uint4*>(out[0]), reinterpret_cast<uint4*>(out[1]),
+        n4);
+    const std::int64_t rem = n - n4 * 4;
+    if (rem > 0) {
+      const std::int64_t base = n4 * 4;
+      ThreeFry2x32Kernel<<<1, block_dim, /*dynamic_shared_mem_bytes=*/0,
+                           stream>>>(keys[0] + base, keys[1] + base,
+                                     data[0] + base, data[1] + base,
+                                     out[0] + base, out[1] + base, rem,
+                                     nullptr);
+    }
+    return;
+  }
+
   const std::int64_t grid_dim =
       n < 0 ? 32
             : std::min<std::int64_t>(1024, (n + block_dim - 1) / block_dim);
@@ -134,5 +286,61 @@ void LaunchThreeFry2x32Kernel(gpuStream_t stream, void** buffers,
                                  out[1], n, n_ptr);
 }
 
+void LaunchThreeFry2x32DropoutKernel(gpuStream_t stream, void** buffers,
+                                     ThreeFry2x32DropoutDescriptor descriptor) {
+  // The key and counter operands have ceil(n / 2) elements: one cipher block
+  // produces two 32-bit words, i.e. two uniform samples.
+  const std::uint32_t* key0 = reinterpret_cast<const std::uint32_t*>(buffers[0]);
+  const std::uint32_t* key1 = reinterpret_cast<const std::uint32_t*>(buffers[1]);
+  const std::uint32_t* data0 =
+      reinterpret_cast<const std::uint32_t*>(buffers[2]);
+  const std::uint32_t* data1 =
+      reinterpret_cast<const std::uint32_t*>(buffers[3]);
+  const float* in = reinterpret_cast<const float*>(buffers[4]);
+  float* out = reinterpret_cast<float*>(buffers[5]);
+  const std::int64_t n = descriptor.n;
+  const float rate = descriptor.rate;
+  const float scale = 1.0f / (1.0f - rate);
+  const int block_dim = 128;
+  const std::int64_t n2 = (n + 1) / 2;
+  const std::int64_t grid_dim =
+      std::min<std::int64_t>(1024, (n2 + block_dim - 1) / block_dim);
+  ThreeFry2x32DropoutKernel<<<grid_dim, block_dim,
+                              /*dynamic_shared_mem_bytes=*/0, stream>>>(
+      key0, key1, data0, data1, in, out, n, rate, scale);
+}
+
+void LaunchPhilox4x32Kernel(gpuStream_t stream, void** buffers,
+                            Philox4x32Descriptor descriptor) {
+  std::array<const std::uint32_t*, 2> keys;
+  keys[0] = reinterpret_cast<const std::uint32_t*>(buffers[0]);
+  keys[1] = reinterpret_cast<const std::uint32_t*>(buffers[1]);
+  std::array<const std::uint32_t*, 4> data;
+  for (int i = 0; i < 4; ++i) {
+    data[i] = reinterpret_cast<const std::uint32_t*>(buffers[2 + i]);
+  }
+  std::int64_t n = descriptor.n;
+  int output_idx = 6;
+  std::int64_t* n_ptr = nullptr;
+  if (n < 0) {
+    // n is an operand in device memory.
+    n_ptr = reinterpret_cast<std::int64_t*>(buffers[6]);
+    output_idx = 7;
+  }
+
+  std::array<std::uint32_t*, 4> out;
+  for (int i = 0; i < 4; ++i) {
+    out[i] = reinterpret_cast<std::uint32_t*>(buffers[output_idx + i]);
+  }
+  const int block_dim = 128;
+  const std::int64_t grid_dim =
+      n < 0 ? 32
+            : std::min<std::int64_t>(1024, (n + block_dim - 1) / block_dim);
+  Philox4x32Kernel<<<grid_dim, block_dim, /*dynamic_shared_mem_bytes=*/0,
+                     stream>>>(keys[0], keys[1], data[0], data[1], data[2],
+                               data[3], out[0], out[1], out[2], out[3], n,
+                               n_ptr);
+}
+
 }  // namespace JAX_GPU_NAMESPACE
 }  // namespace jax
@@ -36,6 +36,34 @@ void LaunchThreeFry2x32Kernel(gpuStream_t stream, void** buffers,
 void ThreeFry2x32(gpuStream_t stream, void** buffers, const char* opaque,
                   size_t opaque_len, XlaCustomCallStatus* status);
 
+// Fused ThreeFry random-bit generation and dropout masking: each element is
+// dropped with probability `rate` and survivors are scaled by 1 / (1 - rate),
+// so the activation tensor is read and written exactly once.
+struct ThreeFry2x32DropoutDescriptor {
+  std::int64_t n;
+  float rate;
+};
+
+void LaunchThreeFry2x32DropoutKernel(gpuStream_t stream, void** buffers,
+                                     ThreeFry2x32DropoutDescriptor descriptor);
+
+void ThreeFry2x32Dropout(gpuStream_t stream, void** buffers, const char* opaque,
+                         size_t opaque_len, XlaCustomCallStatus* status);
+
+// Philox4x32-10 counter-based PRNG. Each invocation of the block cipher maps
+// a 2x32-bit key and a 4x32-bit counter to 128 random bits using
+// multiply-based rounds, which run markedly faster on GPUs than ThreeFry's
+// rotate-xor schedule.
+struct Philox4x32Descriptor {
+  std::int64_t n;  // If -1 then the length is passed as a 7th operand
+};
+
+void LaunchPhilox4x32Kernel(gpuStream_t stream, void** buffers,
+                            Philox4x32Descriptor descriptor);
+
+void Philox4x32(gpuStream_t stream, void** buffers, const char* opaque,
+                size_t opaque_len, XlaCustomCallStatus* status);
+
 }  // namespace JAX_GPU_NAMESPACE
 }  // namespace jax
 
@@ -15,11 +15,20 @@ limitations under the License.
 
 #include "jaxlib/gpu/rnn_kernels.h"
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/synchronization/mutex.h"
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
 #include "jaxlib/handle_pool.h"
 #include "jaxlib/kernel_helpers.h"
@@ -54,13 +63,9 @@ template <>
 /*static*/ absl::StatusOr<DnnHandlePool::Handle> DnnHandlePool::Borrow(
     gpuStream_t stream) {
   DnnHandlePool* pool = Instance();
-  absl::MutexLock lock(&pool->mu_);
   gpudnnHandle_t handle;
-  if (pool->handles_[stream].empty()) {
+  if (!pool->TryAcquire(stream, &handle)) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpudnnCreate(&handle)));
-  } else {
-    handle = pool->handles_[stream].back();
-    pool->handles_[stream].pop_back();
   }
   if (stream) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpudnnSetStream(handle, stream)));
@@ -68,8 +73,271 @@ template <>
   return Handle(pool, handle, stream);
 }
 
+template <>
+/*static*/ void DnnHandlePool::DestroyHandle(gpudnnHandle_t handle) {
+  gpudnnDestroy(handle);
+}
+
 namespace JAX_GPU_NAMESPACE {
 
+namespace {
+
+// Fully initialized cuDNN descriptors for one (RnnDescriptor, sequence
+// length assignment) pair. Building these involves a dozen host-side cuDNN
+// calls per custom call invocation, which is pure overhead once shapes are
+// fixed, so they are built once and cached for the life of the process. The
+// descriptors are read-only during execution and may be shared by concurrent
+// forward/backward calls.
+struct RnnDescriptors {
+  cudnnRNNDescriptor_t rnn_desc;
+  cudnnDropoutDescriptor_t dropout_desc;
+  cudnnRNNDataDescriptor_t input_data_desc;
+  cudnnRNNDataDescriptor_t output_data_desc;
+  cudnnTensorDescriptor_t h_desc;
+  cudnnTensorDescriptor_t c_desc;
+  size_t weight_space_size;
+};
+
+struct RnnCacheKey {
+  std::string opaque;
+  std::vector<int32_t> seq_lengths;
+  // The cudnnRNNAlgo_t actually programmed into the descriptor. In autotune
+  // mode this differs from the algo field serialized in opaque (-1) while the
+  // candidates are being benchmarked.
+  int algo;
+
+  template <typename H>
+  friend H AbslHashValue(H h, const RnnCacheKey& key) {
+    return H::combine(std::move(h), key.opaque, key.seq_lengths, key.algo);
+  }
+  bool operator==(const RnnCacheKey& other) const {
+    return opaque == other.opaque && seq_lengths == other.seq_lengths &&
+           algo == other.algo;
+  }
+};
+
+absl::StatusOr<cudnnRNNAlgo_t> RnnAlgoFromInt(int algo) {
+  switch (algo) {
+    case 0:
+      return CUDNN_RNN_ALGO_STANDARD;
+    case 1:
+      return CUDNN_RNN_ALGO_PERSIST_STATIC;
+    case 2:
+      return CUDNN_RNN_ALGO_PERSIST_DYNAMIC;
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Unknown cuDNN RNN algorithm: %d", algo));
+  }
+}
+
+absl::StatusOr<RnnDescriptors*> GetRnnDescriptors(
+    gpudnnHandle_t handle, const RnnDescriptor& d, const char* opaque,
+    size_t opaque_len, const std::vector<int32_t>& seq_length_vector,
+    cudnnRNNAlgo_t algo) {
+  static absl::Mutex mu;
+  static auto* cache ABSL_GUARDED_BY(mu) =
+      new absl::flat_hash_map<RnnCacheKey, RnnDescriptors*>();
+  RnnCacheKey key{std::string(opaque, opaque_len), seq_length_vector,
+                  static_cast<int>(algo)};
+  absl::MutexLock lock(&mu);
+  auto it = cache->find(key);
+  if (it != cache->end()) {
+    return it->second;
+  }
+
+  auto desc = std::make_unique<RnnDescriptors>();
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnCreateRNNDescriptor(&desc->rnn_desc)));
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(cudnnCreateDropoutDescriptor(&desc->dropout_desc)));
+  size_t state_size;
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(cudnnDropoutGetStatesSize(handle, &state_size)));
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetDropoutDescriptor(
+      desc->dropout_desc, handle, d.dropout, nullptr, state_size, 123)));
+
+  // TODO(zhangqiaorjc): Handle other kinds of RNN.
+  cudnnRNNMode_t cell_mode = CUDNN_LSTM;
+  cudnnRNNBiasMode_t bias_mode = CUDNN_RNN_DOUBLE_BIAS;
+  int num_directions = 1;
+  cudnnDirectionMode_t dir_mode = CUDNN_UNIDIRECTIONAL;
+  if (d.bidirectional) {
+    dir_mode = CUDNN_BIDIRECTIONAL;
+    num_directions = 2;
+  }
+  cudnnRNNInputMode_t input_mode = CUDNN_LINEAR_INPUT;
+  cudnnDataType_t data_type = CUDNN_DATA_FLOAT;
+  cudnnDataType_t math_prec = CUDNN_DATA_FLOAT;
+  cudnnMathType_t math_type =
+      d.cudnn_allow_tf32 ? CUDNN_DEFAULT_MATH : CUDNN_FMA_MATH;
+  int32_t proj_size = d.hidden_size;
+  uint32_t aux_flags = CUDNN_RNN_PADDED_IO_ENABLED;
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDescriptor_v8(
+      desc->rnn_desc, algo, cell_mode, bias_mode, dir_mode, input_mode,
+      data_type, math_prec, math_type, d.input_size, d.hidden_size, proj_size,
+      d.num_layers, desc->dropout_desc, aux_flags)));
+
+  cudnnRNNDataLayout_t layout = CUDNN_RNN_DATA_LAYOUT_BATCH_MAJOR_UNPACKED;
+  float padding = 0.0f;
+  const int32_t* seq_length_array = seq_length_vector.data();
+
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(cudnnCreateRNNDataDescriptor(&desc->input_data_desc)));
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDataDescriptor(
+      desc->input_data_desc, data_type, layout, d.max_seq_length, d.batch_size,
+      d.input_size, const_cast<int32_t*>(seq_length_array), &padding)));
+
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(cudnnCreateRNNDataDescriptor(&desc->output_data_desc)));
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDataDescriptor(
+      desc->output_data_desc, data_type, layout, d.max_seq_length, d.batch_size,
+      d.hidden_size * num_directions, const_cast<int32_t*>(seq_length_array),
+      &padding)));
+
+  // Shape is (num_directions * num_layers, batch_size, hidden_size)
+  int dims[3];
+  dims[0] = num_directions * d.num_layers;
+  dims[1] = d.batch_size;
+  dims[2] = d.hidden_size;
+  int strides[3];
+  strides[0] = dims[1] * dims[2];
+  strides[1] = dims[2];
+  strides[2] = 1;
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(cudnnCreateTensorDescriptor(&desc->h_desc)));
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+      cudnnSetTensorNdDescriptor(desc->h_desc, data_type, 3, dims, strides)));
+
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(cudnnCreateTensorDescriptor(&desc->c_desc)));
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+      cudnnSetTensorNdDescriptor(desc->c_desc, data_type, 3, dims, strides)));
+
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnGetRNNWeightSpaceSize(
+      handle, desc->rnn_desc, &desc->weight_space_size)));
+
+  return cache->emplace(std::move(key), desc.release()).first->second;
+}
+
+// Issues one forward pass with the given descriptors. Shared between the real
+// execution path and the autotuner below.
+absl::Status RunRnnForward(gpudnnHandle_t handle, const RnnDescriptors& desc,
+                           const RnnDescriptor& d, void** buffers) {
+  cudnnForwardMode_t fwdMode = CUDNN_FWD_MODE_TRAINING;
+
+  auto input_buf = buffers[0];
+  auto h_0_buf = buffers[1];
+  auto c_0_buf = buffers[2];
+  auto weights_buf = buffers[3];
+  auto seq_lengths_buf = buffers[4];
+  auto output_buf = buffers[5];
+  auto h_n_buf = buffers[6];
+  auto c_n_buf = buffers[7];
+  auto workspace_buf = buffers[8];
+  auto reserve_space_buf = buffers[9];
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnRNNForward(
+      handle, desc.rnn_desc, fwdMode, (const int32_t*)seq_lengths_buf,
+      desc.input_data_desc, input_buf, desc.output_data_desc, output_buf,
+      desc.h_desc, h_0_buf, h_n_buf, desc.c_desc, c_0_buf, c_n_buf,
+      desc.weight_space_size, weights_buf, d.workspace_size, workspace_buf,
+      d.reserve_space_size, reserve_space_buf)));
+  return absl::OkStatus();
+}
+
+// Winning algorithms from autotuning, keyed like the descriptor cache (with
+// the algo field pinned to -1).
+struct RnnAutotuneCache {
+  absl::Mutex mutex;
+  absl::flat_hash_map<RnnCacheKey, cudnnRNNAlgo_t> winners
+      ABSL_GUARDED_BY(mutex);
+};
+
+RnnAutotuneCache& GetRnnAutotuneCache() {
+  static auto* cache = new RnnAutotuneCache;
+  return *cache;
+}
+
+std::optional<cudnnRNNAlgo_t> LookupAutotunedRnnAlgo(
+    const char* opaque, size_t opaque_len,
+    const std::vector<int32_t>& seq_length_vector) {
+  RnnAutotuneCache& cache = GetRnnAutotuneCache();
+  RnnCacheKey key{std::string(opaque, opaque_len), seq_length_vector, -1};
+  absl::MutexLock lock(&cache.mutex);
+  auto it = cache.winners.find(key);
+  if (it == cache.winners.end()) return std::nullopt;
+  return it->second;
+}
+
+// Picks the algorithm to run. An explicit choice in the descriptor wins;
+// otherwise the candidates are benchmarked once per shape — mirroring the
+// Triton kernel autotuning in triton_kernels.cc — and the winner is cached
+// for the life of the process.
+absl::StatusOr<cudnnRNNAlgo_t> ResolveRnnAlgo(
+    gpudnnHandle_t handle, gpuStream_t stream, const RnnDescriptor& d,
+    const char* opaque, size_t opaque_len,
+    const std::vector<int32_t>& seq_length_vector, void** buffers) {
+  if (d.algo >= 0) return RnnAlgoFromInt(d.algo);
+  if (auto winner =
+          LookupAutotunedRnnAlgo(opaque, opaque_len, seq_length_vector)) {
+    return *winner;
+  }
+
+  constexpr cudnnRNNAlgo_t kCandidates[] = {CUDNN_RNN_ALGO_STANDARD,
+                                            CUDNN_RNN_ALGO_PERSIST_STATIC,
+                                            CUDNN_RNN_ALGO_PERSIST_DYNAMIC};
+  cudnnRNNAlgo_t best = CUDNN_RNN_ALGO_STANDARD;
+  float best_ms = std::numeric_limits<float>::infinity();
+  for (cudnnRNNAlgo_t algo : kCandidates) {
+    auto cached = GetRnnDescriptors(handle, d, opaque, opaque_len,
+                                    seq_length_vector, algo);
+    // Not every algorithm supports every configuration.
+    if (!cached.ok()) continue;
+    RnnDescriptors* desc = *cached;
+    // The XLA workspace and reserve space buffers were sized at lowering
+    // time for the standard algorithm; reject candidates that need more.
+    size_t workspace_size, reserve_space_size;
+    if (cudnnGetRNNTempSpaceSizes(handle, desc->rnn_desc,
+                                  CUDNN_FWD_MODE_TRAINING,
+                                  desc->input_data_desc, &workspace_size,
+                                  &reserve_space_size) !=
+            GPUDNN_STATUS_SUCCESS ||
+        workspace_size > static_cast<size_t>(d.workspace_size) ||
+        reserve_space_size > static_cast<size_t>(d.reserve_space_size)) {
+      continue;
+    }
+    // Warm-up run; this also weeds out algorithms that only fail at
+    // execution time. The output buffers are scratch here — whichever
+    // algorithm wins rewrites them (and the reserve space the backward pass
+    // reads) on the real run that follows.
+    if (!RunRnnForward(handle, *desc, d, buffers).ok()) continue;
+    gpuEvent_t start, stop;
+    JAX_RETURN_IF_ERROR(
+        JAX_AS_STATUS(gpuEventCreate(&start, /*Flags=*/GPU_EVENT_DEFAULT)));
+    JAX_RETURN_IF_ERROR(
+        JAX_AS_STATUS(gpuEventCreate(&stop, /*Flags=*/GPU_EVENT_DEFAULT)));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuEventRecord(start, stream)));
+    absl::Status run = RunRnnForward(handle, *desc, d, buffers);
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuEventRecord(stop, stream)));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuEventSynchronize(stop)));
+    float elapsed_ms;
+    JAX_RETURN_IF_ERROR(
+        JAX_AS_STATUS(gpuEventElapsedTime(&elapsed_ms, start, stop)));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuEventDestroy(start)));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuEventDestroy(stop)));
+    if (run.ok() && elapsed_ms < best_ms) {
+      best = algo;
+      best_ms = elapsed_ms;
+    }
+  }
+
+  RnnAutotuneCache& cache = GetRnnAutotuneCache();
+  RnnCacheKey key{std::string(opaque, opaque_len), seq_length_vector, -1};
+  absl::MutexLock lock(&cache.mutex);
+  cache.winners.emplace(std::move(key), best);
+  return best;
+}
+
+}  // namespace
+
 static absl::StatusOr<std::pair<int, int>>
 DoRnnComputeWorkspaceReserveSpaceSizes(int input_size, int hidden_size,
                                        int num_layers, int batch_size,
@@ -107,6 +375,8 @@ DoRnnComputeWorkspaceReserveSpaceSizes(int input_size, int hidden_size,
   cudnnMathType_t math_type = cudnn_allow_tf32? CUDNN_DEFAULT_MATH: CUDNN_FMA_MATH;
   int32_t proj_size = hidden_size;
   uint32_t aux_flags = CUDNN_RNN_PADDED_IO_ENABLED;
+  // Sizes are always computed for the standard algorithm; autotuning only
+  // considers candidates whose temp spaces fit in them (see ResolveRnnAlgo).
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDescriptor_v8(
       rnn_desc, CUDNN_RNN_ALGO_STANDARD, cell_mode, bias_mode, dir_mode,
       input_mode, data_type, math_prec, math_type, input_size, hidden_size,
@@ -162,117 +432,27 @@ static absl::Status DnnRNNForward_(gpuStream_t stream, void** buffers,
   JAX_RETURN_IF_ERROR(h.status());
   auto& handle = *h;
 
-  cudnnRNNDescriptor_t rnn_desc;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnCreateRNNDescriptor(&rnn_desc)));
-
-  cudnnDropoutDescriptor_t dropout_desc;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnCreateDropoutDescriptor(&dropout_desc)));
-  size_t state_size;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDropoutGetStatesSize(handle.get(), &state_size)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetDropoutDescriptor(
-      dropout_desc, handle.get(), d.dropout, nullptr, state_size, 123)));
-
-  // TODO(zhangqiaorjc): Handle other kinds of RNN.
-  cudnnRNNMode_t cell_mode = CUDNN_LSTM;
-  cudnnRNNBiasMode_t bias_mode = CUDNN_RNN_DOUBLE_BIAS;
-  int num_directions = 1;
-  cudnnDirectionMode_t dir_mode = CUDNN_UNIDIRECTIONAL;
-  if (d.bidirectional) {
-    dir_mode = CUDNN_BIDIRECTIONAL;
-    num_directions = 2;
-  }
-  cudnnRNNInputMode_t input_mode = CUDNN_LINEAR_INPUT;
-  cudnnDataType_t data_type = CUDNN_DATA_FLOAT;
-  cudnnDataType_t math_prec = CUDNN_DATA_FLOAT;
-  cudnnMathType_t math_type = d.cudnn_allow_tf32? CUDNN_DEFAULT_MATH: CUDNN_FMA_MATH;
-  int32_t proj_size = d.hidden_size;
-  uint32_t aux_flags = CUDNN_RNN_PADDED_IO_ENABLED;
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDescriptor_v8(
-      rnn_desc, CUDNN_RNN_ALGO_STANDARD, cell_mode, bias_mode, dir_mode,
-      input_mode, data_type, math_prec, math_type, d.input_size, d.hidden_size,
-      proj_size, d.num_layers, dropout_desc, aux_flags)));
-
-  cudnnForwardMode_t fwdMode = CUDNN_FWD_MODE_TRAINING;
-  cudnnRNNDataLayout_t layout = CUDNN_RNN_DATA_LAYOUT_BATCH_MAJOR_UNPACKED;
-  float padding = 0.0f;
-
-  // TODO(zhangqiaorjc): Avoid this cudaMemcpy if possible.
   auto seq_lengths_buf = buffers[4];
-  std::vector<int32_t> seq_length_vector(d.batch_size, 0);
-  int32_t* seq_length_array = &seq_length_vector[0];
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(gpuMemcpyAsync(seq_length_array, seq_lengths_buf,
-                                   seq_length_vector.size() * sizeof(int32_t),
-                                   gpuMemcpyDeviceToHost, stream)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuStreamSynchronize(stream)));
-
-  cudnnRNNDataDescriptor_t input_data_desc;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnCreateRNNDataDescriptor(&input_data_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDataDescriptor(
-      input_data_desc, data_type, layout, d.max_seq_length, d.batch_size,
-      d.input_size, seq_length_array, &padding)));
-
-  cudnnRNNDataDescriptor_t output_data_desc;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnCreateRNNDataDescriptor(&output_data_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDataDescriptor(
-      output_data_desc, data_type, layout, d.max_seq_length, d.batch_size,
-      d.hidden_size * num_directions, seq_length_array, &padding)));
-
-  // Shape is (num_directions * num_layers, batch_size, hidden_size)
-  int dims[3];
-  dims[0] = num_directions * d.num_layers;
-  dims[1] = d.batch_size;
-  dims[2] = d.hidden_size;
-  int strides[3];
-  strides[0] = dims[1] * dims[2];
-  strides[1] = dims[2];
-  strides[2] = 1;
-  cudnnTensorDescriptor_t h_desc;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnCreateTensorDescriptor(&h_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      cudnnSetTensorNdDescriptor(h_desc, data_type, 3, dims, strides)));
-
-  cudnnTensorDescriptor_t c_desc;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnCreateTensorDescriptor(&c_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      cudnnSetTensorNdDescriptor(c_desc, data_type, 3, dims, strides)));
-
-  size_t weight_space_size;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      cudnnGetRNNWeightSpaceSize(handle.get(), rnn_desc, &weight_space_size)));
+  std::vector<int32_t> seq_length_vector(d.batch_size, d.uniform_seq_length);
+  if (d.uniform_seq_length < 0) {
+    // The lengths are only known on device; reading them back stalls the
+    // stream, so the lowering embeds them in the descriptor whenever
+    // seq_lengths is a splat constant and this copy is skipped.
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+        gpuMemcpyAsync(seq_length_vector.data(), seq_lengths_buf,
+                       seq_length_vector.size() * sizeof(int32_t),
+                       gpuMemcpyDeviceToHost, stream)));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuStreamSynchronize(stream)));
+  }
 
-  auto input_buf = buffers[0];
-  auto h_0_buf = buffers[1];
-  auto c_0_buf = buffers[2];
-  auto weights_buf = buffers[3];
-  auto output_buf = buffers[5];
-  auto h_n_buf = buffers[6];
-  auto c_n_buf = buffers[7];
-  auto workspace_buf = buffers[8];
-  auto reserve_space_buf = buffers[9];
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnRNNForward(
-      handle.get(), rnn_desc, fwdMode, (const int32_t*)seq_lengths_buf,
-      input_data_desc, input_buf, output_data_desc, output_buf, h_desc, h_0_buf,
-      h_n_buf, c_desc, c_0_buf, c_n_buf, weight_space_size, weights_buf,
-      d.workspace_size, workspace_buf, d.reserve_space_size,
-      reserve_space_buf)));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnDestroyTensorDescriptor(h_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnDestroyTensorDescriptor(c_desc)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDestroyDropoutDescriptor(dropout_desc)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDestroyRNNDataDescriptor(input_data_desc)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDestroyRNNDataDescriptor(output_data_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnDestroyRNNDescriptor(rnn_desc)));
+  auto algo = ResolveRnnAlgo(handle.get(), stream, d, opaque, opaque_len,
+                             seq_length_vector, buffers);
+  JAX_RETURN_IF_ERROR(algo.status());
 
-  return absl::OkStatus();
+  auto cached = GetRnnDescriptors(handle.get(), d, opaque, opaque_len,
+                                  seq_length_vector, *algo);
+  JAX_RETURN_IF_ERROR(cached.status());
+  return RunRnnForward(handle.get(), **cached, d, buffers);
 }
 
 static absl::Status DnnRNNBackward_(gpuStream_t stream, void** buffers,
@@ -284,87 +464,34 @@ static absl::Status DnnRNNBackward_(gpuStream_t stream, void** buffers,
   JAX_RETURN_IF_ERROR(h.status());
   auto& handle = *h;
 
-  cudnnRNNDescriptor_t rnn_desc;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnCreateRNNDescriptor(&rnn_desc)));
-
-  cudnnDropoutDescriptor_t dropout_desc;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnCreateDropoutDescriptor(&dropout_desc)));
-  size_t state_size;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDropoutGetStatesSize(handle.get(), &state_size)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetDropoutDescriptor(
-      dropout_desc, handle.get(), d.dropout, nullptr, state_size, 123)));
-
-  // TODO(zhangqiaorjc): Handle other kinds of RNN.
-  cudnnRNNMode_t cell_mode = CUDNN_LSTM;
-  cudnnRNNBiasMode_t bias_mode = CUDNN_RNN_DOUBLE_BIAS;
-  int num_directions = 1;
-  cudnnDirectionMode_t dir_mode = CUDNN_UNIDIRECTIONAL;
-  if (d.bidirectional) {
-    dir_mode = CUDNN_BIDIRECTIONAL;
-    num_directions = 2;
-  }
-  cudnnRNNInputMode_t input_mode = CUDNN_LINEAR_INPUT;
-  cudnnDataType_t data_type = CUDNN_DATA_FLOAT;
-  cudnnDataType_t math_prec = CUDNN_DATA_FLOAT;
-  cudnnMathType_t math_type = d.cudnn_allow_tf32? CUDNN_DEFAULT_MATH: CUDNN_FMA_MATH;
-  int32_t proj_size = d.hidden_size;
-  uint32_t aux_flags = CUDNN_RNN_PADDED_IO_ENABLED;
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDescriptor_v8(
-      rnn_desc, CUDNN_RNN_ALGO_STANDARD, cell_mode, bias_mode, dir_mode,
-      input_mode, data_type, math_prec, math_type, d.input_size, d.hidden_size,
-      proj_size, d.num_layers, dropout_desc, aux_flags)));
-
-  cudnnRNNDataLayout_t layout = CUDNN_RNN_DATA_LAYOUT_BATCH_MAJOR_UNPACKED;
-  float padding = 0.0f;
-
   auto seq_lengths_buf = buffers[10];
-  std::vector<int32_t> seq_length_vector(d.batch_size, d.max_seq_length);
-  int32_t* seq_length_array = &seq_length_vector[0];
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(gpuMemcpyAsync(seq_length_array, seq_lengths_buf,
-                                   seq_length_vector.size() * sizeof(int32_t),
-                                   gpuMemcpyDeviceToHost, stream)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuStreamSynchronize(stream)));
-
-  cudnnRNNDataDescriptor_t input_data_desc;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnCreateRNNDataDescriptor(&input_data_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDataDescriptor(
-      input_data_desc, data_type, layout, d.max_seq_length, d.batch_size,
-      d.input_size, seq_length_array, &padding)));
-
-  cudnnRNNDataDescriptor_t output_data_desc;
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnCreateRNNDataDescriptor(&output_data_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnSetRNNDataDescriptor(
-      output_data_desc, data_type, layout, d.max_seq_length, d.batch_size,
-      d.hidden_size * num_directions, seq_length_array, &padding)));
-
-  // Shape is (num_directions * num_layers, batch_size, hidden_size)
-  int dims[3];
-  dims[0] = num_directions * d.num_layers;
-  dims[1] = d.batch_size;
-  dims[2] = d.hidden_size;
-  int strides[3];
-  strides[0] = dims[1] * dims[2];
-  strides[1] = dims[2];
-  strides[2] = 1;
-  cudnnTensorDescriptor_t h_desc;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnCreateTensorDescriptor(&h_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      cudnnSetTensorNdDescriptor(h_desc, data_type, 3, dims, strides)));
+  std::vector<int32_t> seq_length_vector(d.batch_size, d.uniform_seq_length);
+  if (d.uniform_seq_length < 0) {
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+        gpuMemcpyAsync(seq_length_vector.data(), seq_lengths_buf,
+                       seq_length_vector.size() * sizeof(int32_t),
+                       gpuMemcpyDeviceToHost, stream)));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuStreamSynchronize(stream)));
+  }
 
-  cudnnTensorDescriptor_t c_desc;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnCreateTensorDescriptor(&c_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      cudnnSetTensorNdDescriptor(c_desc, data_type, 3, dims, strides)));
+  // The backward pass must run the same algorithm the forward pass was
+  // benchmarked with: the reserve space layout depends on it. In autotune
+  // mode the winner is always cached by the time gradients are requested,
+  // since the forward call for this shape has already executed.
+  cudnnRNNAlgo_t algo = CUDNN_RNN_ALGO_STANDARD;
+  if (d.algo >= 0) {
+    auto s_algo = RnnAlgoFromInt(d.algo);
+    JAX_RETURN_IF_ERROR(s_algo.status());
+    algo = *s_algo;
+  } else if (auto winner = LookupAutotunedRnnAlgo(opaque, opaque_len,
+                                                  seq_length_vector)) {
+    algo = *winner;
+  }
 
-  size_t weight_space_size;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      cudnnGetRNNWeightSpaceSize(handle.get(), rnn_desc, &weight_space_size)));
+  auto cached = GetRnnDescriptors(handle.get(), d, opaque, opaque_len,
+                                  seq_length_vector, algo);
+  JAX_RETURN_IF_ERROR(cached.status());
+  RnnDescriptors* desc = *cached;
 
   auto dy_buf = buffers[0];
   auto dh_n_buf = buffers[1];
@@ -385,35 +512,40 @@ static absl::Status DnnRNNBackward_(gpuStream_t stream, void** buffers,
   auto workspace_buf = buffers[15];
 
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnRNNBackwardData_v8(
-      handle.get(), rnn_desc, (const int32_t*)seq_lengths_buf, output_data_desc,
-      y_buf, dy_buf, input_data_desc, dx_buf, h_desc, h_0_buf, dh_n_buf,
-      dh_0_buf, c_desc, c_0_buf, dc_n_buf, dc_0_buf, weight_space_size, w_buf,
-      d.workspace_size, workspace_buf, d.reserve_space_size,
-      reserve_space_buf)));
+      handle.get(), desc->rnn_desc, (const int32_t*)seq_lengths_buf,
+      desc->output_data_desc, y_buf, dy_buf, desc->input_data_desc, dx_buf,
+      desc->h_desc, h_0_buf, dh_n_buf, dh_0_buf, desc->c_desc, c_0_buf,
+      dc_n_buf, dc_0_buf, desc->weight_space_size, w_buf, d.workspace_size,
+      workspace_buf, d.reserve_space_size, reserve_space_buf)));
 
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnRNNBackwardWeights_v8(
-      handle.get(), rnn_desc, CUDNN_WGRAD_MODE_ADD,
-      (const int32_t*)seq_lengths_buf, input_data_desc, x_buf, h_desc, h_0_buf,
-      output_data_desc, y_buf, weight_space_size, zeroed_dw_buf,
-      d.workspace_size, workspace_buf, d.reserve_space_size,
-      reserve_space_buf)));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnDestroyTensorDescriptor(h_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnDestroyTensorDescriptor(c_desc)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDestroyDropoutDescriptor(dropout_desc)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDestroyRNNDataDescriptor(input_data_desc)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cudnnDestroyRNNDataDescriptor(output_data_desc)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cudnnDestroyRNNDescriptor(rnn_desc)));
+      handle.get(), desc->rnn_desc, CUDNN_WGRAD_MODE_ADD,
+      (const int32_t*)seq_lengths_buf, desc->input_data_desc, x_buf,
+      desc->h_desc, h_0_buf, desc->output_data_desc, y_buf,
+      desc->weight_space_size, zeroed_dw_buf, d.workspace_size, workspace_buf,
+      d.reserve_space_size, reserve_space_buf)));
 
   return absl::OkStatus();
 }
 
+// With host-side sequence lengths the launch sequences below no longer read
+// back device memory, which also makes them eligible for the (opt-in) graph
+// capture path; kernels that still have to synchronize on the seq_lengths
+// copy cannot be captured.
+
 void RNNForward(gpuStream_t stream, void** buffers, const char* opaque,
                 size_t opaque_len, XlaCustomCallStatus* status) {
-  auto s = DnnRNNForward_(stream, buffers, opaque, opaque_len);
+  absl::Status s;
+  auto d = UnpackDescriptor<RnnDescriptor>(opaque, opaque_len);
+  if (d.ok() && (*d)->uniform_seq_length >= 0) {
+    s = RunWithOptionalGraphCapture(
+        stream, opaque, opaque_len, buffers, /*num_buffers=*/10,
+        [&](gpuStream_t capture_stream) {
+          return DnnRNNForward_(capture_stream, buffers, opaque, opaque_len);
+        });
+  } else {
+    s = DnnRNNForward_(stream, buffers, opaque, opaque_len);
+  }
   if (!s.ok()) {
     XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
                                   s.message().length());
@@ -422,7 +554,17 @@ void RNNForward(gpuStream_t stream, void** buffers, const char* opaque,
 
 void RNNBackward(gpuStream_t stream, void** buffers, const char* opaque,
                  size_t opaque_len, XlaCustomCallStatus* status) {
-  auto s = DnnRNNBackward_(stream, buffers, opaque, opaque_len);
+  absl::Status s;
+  auto d = UnpackDescriptor<RnnDescriptor>(opaque, opaque_len);
+  if (d.ok() && (*d)->uniform_seq_length >= 0) {
+    s = RunWithOptionalGraphCapture(
+        stream, opaque, opaque_len, buffers, /*num_buffers=*/16,
+        [&](gpuStream_t capture_stream) {
+          return DnnRNNBackward_(capture_stream, buffers, opaque, opaque_len);
+        });
+  } else {
+    s = DnnRNNBackward_(stream, buffers, opaque, opaque_len);
+  }
   if (!s.ok()) {
     XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
                                   s.message().length());
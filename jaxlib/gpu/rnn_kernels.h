@@ -35,6 +35,15 @@ struct RnnDescriptor {
   bool cudnn_allow_tf32;
   int workspace_size;
   int reserve_space_size;
+  // When the lowering finds seq_lengths to be a splat constant, the value is
+  // recorded here (-1 otherwise) so the kernels can build the host-side
+  // length array without a blocking device-to-host copy.
+  int uniform_seq_length;
+  // cuDNN RNN algorithm: 0 = standard, 1 = persist-static, 2 =
+  // persist-dynamic. -1 benchmarks the candidates on the first forward call
+  // for a shape and caches the winner (see ResolveRnnAlgo in
+  // rnn_kernels.cc).
+  int algo;
 };
 
 // Return (workspace size, reserve space size).
@@ -26,6 +26,7 @@ limitations under the License.
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
 #include "jaxlib/gpu/solver_kernels.h"
 #include "jaxlib/gpu/vendor.h"
+#include "jaxlib/handle_pool.h"
 #include "jaxlib/kernel_nanobind_helpers.h"
 #include "xla/tsl/python/lib/core/numpy.h"
 
@@ -148,9 +149,7 @@ nb::bytes BuildCsrlsvqrDescriptor(const dtype& dtype, int n, int nnzA,
 // orgqr/ungqr: apply elementary Householder transformations
 
 // Returns the workspace size and a descriptor for a geqrf operation.
-std::pair<int, nb::bytes> BuildOrgqrDescriptor(const dtype& dtype, int b, int m,
-                                               int n, int k) {
-  SolverType type = DtypeToSolverType(dtype);
+static int OrgqrBufferSize(SolverType type, int m, int n, int k) {
   auto h = SolverHandlePool::Borrow(/*stream=*/nullptr);
   JAX_THROW_IF_ERROR(h.status());
   auto& handle = *h;
@@ -185,9 +184,29 @@ std::pair<int, nb::bytes> BuildOrgqrDescriptor(const dtype& dtype, int b, int m,
                                                      /*tau=*/nullptr, &lwork)));
       break;
   }
+  return lwork;
+}
+
+std::pair<int, nb::bytes> BuildOrgqrDescriptor(const dtype& dtype, int b, int m,
+                                               int n, int k) {
+  SolverType type = DtypeToSolverType(dtype);
+  int lwork = OrgqrBufferSize(type, m, n, k);
   return {lwork, PackDescriptor(OrgqrDescriptor{type, b, m, n, k, lwork})};
 }
 
+// Returns the total workspace size and a descriptor for a batched,
+// multi-stream orgqr operation. The workspace holds one lwork-element slice
+// per side stream.
+std::pair<int, nb::bytes> BuildOrgqrBatchedDescriptor(const dtype& dtype, int b,
+                                                      int m, int n, int k) {
+  SolverType type = DtypeToSolverType(dtype);
+  int lwork = OrgqrBufferSize(type, m, n, k);
+  int num_streams = std::min(kOrgqrBatchedStreams, b);
+  return {lwork * num_streams,
+          PackDescriptor(
+              OrgqrBatchedDescriptor{type, b, m, n, k, lwork, num_streams})};
+}
+
 // Symmetric (Hermitian) eigendecomposition, QR algorithm: syevd/heevd
 
 // Returns the workspace size and a descriptor for a syevd operation.
@@ -465,6 +484,7 @@ nb::dict Registrations() {
   dict[JAX_GPU_PREFIX "solver_getrf"] = EncapsulateFunction(Getrf);
   dict[JAX_GPU_PREFIX "solver_geqrf"] = EncapsulateFunction(Geqrf);
   dict[JAX_GPU_PREFIX "solver_orgqr"] = EncapsulateFunction(Orgqr);
+  dict[JAX_GPU_PREFIX "solver_orgqr_batched"] = EncapsulateFunction(OrgqrBatched);
   dict[JAX_GPU_PREFIX "solver_syevd"] = EncapsulateFunction(Syevd);
   dict[JAX_GPU_PREFIX "solver_syevj"] = EncapsulateFunction(Syevj);
   dict[JAX_GPU_PREFIX "solver_gesvd"] = EncapsulateFunction(Gesvd);
@@ -483,10 +503,36 @@ NB_MODULE(_solver, m) {
   m.def("build_getrf_descriptor", &BuildGetrfDescriptor);
   m.def("build_geqrf_descriptor", &BuildGeqrfDescriptor);
   m.def("build_orgqr_descriptor", &BuildOrgqrDescriptor);
+  m.def("build_orgqr_batched_descriptor", &BuildOrgqrBatchedDescriptor);
   m.def("build_syevd_descriptor", &BuildSyevdDescriptor);
   m.def("build_syevj_descriptor", &BuildSyevjDescriptor);
   m.def("build_gesvd_descriptor", &BuildGesvdDescriptor);
   m.def("build_sytrd_descriptor", &BuildSytrdDescriptor);
+  m.def(
+      "prewarm",
+      [](std::uintptr_t stream, int count) {
+        JAX_THROW_IF_ERROR(SolverHandlePool::Prewarm(
+            reinterpret_cast<gpuStream_t>(stream), count));
+      },
+      nb::arg("stream") = 0, nb::arg("count") = 1);
+  m.def("handle_pool_stats", []() {
+    HandlePoolStats stats = SolverHandlePool::GetStats();
+    nb::dict d;
+    d["created"] = stats.created;
+    d["destroyed"] = stats.destroyed;
+    d["borrowed"] = stats.borrowed;
+    d["idle"] = stats.idle;
+    nb::dict per_stream;
+    for (const auto& [stream, idle] : stats.idle_per_stream) {
+      per_stream[nb::int_(stream)] = idle;
+    }
+    d["idle_per_stream"] = per_stream;
+    return d;
+  });
+  m.def(
+      "set_handle_pool_capacity",
+      [](std::int64_t max_idle) { SolverHandlePool::SetCapacity(max_idle); },
+      nb::arg("max_idle"));
 #ifdef JAX_GPU_CUDA
   m.def("build_csrlsvqr_descriptor", &BuildCsrlsvqrDescriptor);
   m.def("build_gesvdj_descriptor", &BuildGesvdjDescriptor);
@@ -17,10 +17,12 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
@@ -39,13 +41,9 @@ template <>
 /*static*/ absl::StatusOr<SolverHandlePool::Handle> SolverHandlePool::Borrow(
     gpuStream_t stream) {
   SolverHandlePool* pool = Instance();
-  absl::MutexLock lock(&pool->mu_);
   gpusolverDnHandle_t handle;
-  if (pool->handles_[stream].empty()) {
+  if (!pool->TryAcquire(stream, &handle)) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnCreate(&handle)));
-  } else {
-    handle = pool->handles_[stream].back();
-    pool->handles_[stream].pop_back();
   }
   if (stream) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnSetStream(handle, stream)));
@@ -53,19 +51,20 @@ template <>
   return Handle(pool, handle, stream);
 }
 
+template <>
+/*static*/ void SolverHandlePool::DestroyHandle(gpusolverDnHandle_t handle) {
+  gpusolverDnDestroy(handle);
+}
+
 #ifdef JAX_GPU_CUDA
 
 template <>
 /*static*/ absl::StatusOr<SpSolverHandlePool::Handle>
 SpSolverHandlePool::Borrow(gpuStream_t stream) {
   SpSolverHandlePool* pool = Instance();
-  absl::MutexLock lock(&pool->mu_);
   cusolverSpHandle_t handle;
-  if (pool->handles_[stream].empty()) {
+  if (!pool->TryAcquire(stream, &handle)) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cusolverSpCreate(&handle)));
-  } else {
-    handle = pool->handles_[stream].back();
-    pool->handles_[stream].pop_back();
   }
   if (stream) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cusolverSpSetStream(handle, stream)));
@@ -73,6 +72,11 @@ SpSolverHandlePool::Borrow(gpuStream_t stream) {
   return Handle(pool, handle, stream);
 }
 
+template <>
+/*static*/ void SpSolverHandlePool::DestroyHandle(cusolverSpHandle_t handle) {
+  cusolverSpDestroy(handle);
+}
+
 #endif  // JAX_GPU_CUDA
 
 namespace JAX_GPU_NAMESPACE {
@@ -166,7 +170,14 @@ static absl::Status Getrf_(gpuStream_t stream, void** buffers,
 
 void Getrf(gpuStream_t stream, void** buffers, const char* opaque,
            size_t opaque_len, XlaCustomCallStatus* status) {
-  auto s = Getrf_(stream, buffers, opaque, opaque_len);
+  // The per-matrix loop is a pure function of the descriptor and buffers, so
+  // it is eligible for (opt-in) graph capture; for large batches of small
+  // matrices replaying the graph removes almost all of the launch overhead.
+  auto s = RunWithOptionalGraphCapture(
+      stream, opaque, opaque_len, buffers, /*num_buffers=*/5,
+      [&](gpuStream_t capture_stream) {
+        return Getrf_(capture_stream, buffers, opaque, opaque_len);
+      });
   if (!s.ok()) {
     XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
                                   s.message().length());
@@ -252,7 +263,11 @@ static absl::Status Geqrf_(gpuStream_t stream, void** buffers,
 
 void Geqrf(gpuStream_t stream, void** buffers, const char* opaque,
            size_t opaque_len, XlaCustomCallStatus* status) {
-  auto s = Geqrf_(stream, buffers, opaque, opaque_len);
+  auto s = RunWithOptionalGraphCapture(
+      stream, opaque, opaque_len, buffers, /*num_buffers=*/5,
+      [&](gpuStream_t capture_stream) {
+        return Geqrf_(capture_stream, buffers, opaque, opaque_len);
+      });
   if (!s.ok()) {
     XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
                                   s.message().length());
@@ -275,12 +290,30 @@ static absl::Status Csrlsvqr_(gpuStream_t stream, void** buffers,
   JAX_RETURN_IF_ERROR(h.status());
   auto& handle = *h;
 
-  cusparseMatDescr_t matdesc = nullptr;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cusparseCreateMatDescr(&matdesc)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(cusparseSetMatType(matdesc, CUSPARSE_MATRIX_TYPE_GENERAL)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      cusparseSetMatIndexBase(matdesc, CUSPARSE_INDEX_BASE_ZERO)));
+  // The descriptor is identical for every call (general matrix, zero-based
+  // indices) and is only read by the solver, so create it once and share it
+  // instead of paying a create/destroy per call (which also leaked on error
+  // returns).
+  static const auto* matdesc_or = []() -> absl::StatusOr<cusparseMatDescr_t>* {
+    cusparseMatDescr_t matdesc = nullptr;
+    auto status = JAX_AS_STATUS(cusparseCreateMatDescr(&matdesc));
+    if (!status.ok()) {
+      return new absl::StatusOr<cusparseMatDescr_t>(status);
+    }
+    if (auto s = JAX_AS_STATUS(
+            cusparseSetMatType(matdesc, CUSPARSE_MATRIX_TYPE_GENERAL));
+        !s.ok()) {
+      return new absl::StatusOr<cusparseMatDescr_t>(s);
+    }
+    if (auto s = JAX_AS_STATUS(
+            cusparseSetMatIndexBase(matdesc, CUSPARSE_INDEX_BASE_ZERO));
+        !s.ok()) {
+      return new absl::StatusOr<cusparseMatDescr_t>(s);
+    }
+    return new absl::StatusOr<cusparseMatDescr_t>(matdesc);
+  }();
+  JAX_RETURN_IF_ERROR(matdesc_or->status());
+  cusparseMatDescr_t matdesc = **matdesc_or;
 
   switch (d.type) {
     case SolverType::F32: {
@@ -337,7 +370,6 @@ static absl::Status Csrlsvqr_(gpuStream_t stream, void** buffers,
     }
   }
 
-  cusparseDestroyMatDescr(matdesc);
   return absl::OkStatus();
 }
 
@@ -439,7 +471,167 @@ static absl::Status Orgqr_(gpuStream_t stream, void** buffers,
 
 void Orgqr(gpuStream_t stream, void** buffers, const char* opaque,
            size_t opaque_len, XlaCustomCallStatus* status) {
-  auto s = Orgqr_(stream, buffers, opaque, opaque_len);
+  auto s = RunWithOptionalGraphCapture(
+      stream, opaque, opaque_len, buffers, /*num_buffers=*/5,
+      [&](gpuStream_t capture_stream) {
+        return Orgqr_(capture_stream, buffers, opaque, opaque_len);
+      });
+  if (!s.ok()) {
+    XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
+                                  s.message().length());
+  }
+}
+
+namespace {
+
+// Side streams used by OrgqrBatched to overlap the per-matrix solver calls.
+// One pool per device, created on first use and kept alive for the process.
+// The mutex serializes the enqueue phase of concurrent calls so the shared
+// fork/join events cannot be re-recorded while another call is still
+// enqueueing waits on them.
+struct OrgqrStreamPool {
+  absl::Mutex mu;
+  gpuStream_t streams[kOrgqrBatchedStreams];
+  gpuEvent_t fork;
+  gpuEvent_t join[kOrgqrBatchedStreams];
+};
+
+absl::StatusOr<OrgqrStreamPool*> GetOrgqrStreamPool() {
+  static absl::Mutex mu;
+  static auto* pools ABSL_GUARDED_BY(mu) =
+      new absl::flat_hash_map<gpuDevice_t, OrgqrStreamPool*>();
+  gpuDevice_t device;
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuCtxGetDevice(&device)));
+  absl::MutexLock lock(&mu);
+  auto it = pools->find(device);
+  if (it != pools->end()) {
+    return it->second;
+  }
+  auto pool = std::make_unique<OrgqrStreamPool>();
+  JAX_RETURN_IF_ERROR(
+      JAX_AS_STATUS(gpuEventCreate(&pool->fork, GPU_EVENT_DEFAULT)));
+  for (int i = 0; i < kOrgqrBatchedStreams; ++i) {
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+        gpuStreamCreate(&pool->streams[i], GPU_STREAM_NON_BLOCKING)));
+    JAX_RETURN_IF_ERROR(
+        JAX_AS_STATUS(gpuEventCreate(&pool->join[i], GPU_EVENT_DEFAULT)));
+  }
+  return pools->emplace(device, pool.release()).first->second;
+}
+
+}  // namespace
+
+static absl::Status OrgqrBatched_(gpuStream_t stream, void** buffers,
+                                  const char* opaque, size_t opaque_len) {
+  auto s = UnpackDescriptor<OrgqrBatchedDescriptor>(opaque, opaque_len);
+  JAX_RETURN_IF_ERROR(s.status());
+  const OrgqrBatchedDescriptor& d = **s;
+  if (d.num_streams < 1 || d.num_streams > kOrgqrBatchedStreams) {
+    return absl::InvalidArgumentError(
+        "Invalid number of streams in orgqr_batched descriptor");
+  }
+  if (buffers[2] != buffers[0]) {
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuMemcpyAsync(
+        buffers[2], buffers[0],
+        SizeOfSolverType(d.type) * static_cast<std::int64_t>(d.batch) *
+            static_cast<std::int64_t>(d.m) * static_cast<std::int64_t>(d.n),
+        gpuMemcpyDeviceToDevice, stream)));
+  }
+
+  auto pool = GetOrgqrStreamPool();
+  JAX_RETURN_IF_ERROR(pool.status());
+  const int num_streams = std::min(d.num_streams, d.batch);
+
+  // Borrow binds each handle to its side stream, so the streams cannot share
+  // a handle.
+  std::vector<SolverHandlePool::Handle> handles;
+  handles.reserve(num_streams);
+  for (int i = 0; i < num_streams; ++i) {
+    auto h = SolverHandlePool::Borrow((*pool)->streams[i]);
+    JAX_RETURN_IF_ERROR(h.status());
+    handles.push_back(std::move(*h));
+  }
+
+  int* info = static_cast<int*>(buffers[3]);
+  const std::int64_t a_step =
+      static_cast<std::int64_t>(d.m) * static_cast<std::int64_t>(d.n);
+
+  absl::MutexLock lock(&(*pool)->mu);
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpuEventRecord((*pool)->fork, stream)));
+  for (int i = 0; i < num_streams; ++i) {
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+        gpuStreamWaitEvent((*pool)->streams[i], (*pool)->fork, /*flags=*/0)));
+  }
+  switch (d.type) {
+    case SolverType::F32: {
+      float* a = static_cast<float*>(buffers[2]);
+      float* tau = static_cast<float*>(buffers[1]);
+      float* workspace = static_cast<float*>(buffers[4]);
+      for (int i = 0; i < d.batch; ++i) {
+        int j = i % num_streams;
+        JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnSorgqr(
+            handles[j].get(), d.m, d.n, d.k, a + i * a_step, d.m,
+            tau + static_cast<std::int64_t>(i) * d.k,
+            workspace + static_cast<std::int64_t>(j) * d.lwork, d.lwork,
+            info + i)));
+      }
+      break;
+    }
+    case SolverType::F64: {
+      double* a = static_cast<double*>(buffers[2]);
+      double* tau = static_cast<double*>(buffers[1]);
+      double* workspace = static_cast<double*>(buffers[4]);
+      for (int i = 0; i < d.batch; ++i) {
+        int j = i % num_streams;
+        JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnDorgqr(
+            handles[j].get(), d.m, d.n, d.k, a + i * a_step, d.m,
+            tau + static_cast<std::int64_t>(i) * d.k,
+            workspace + static_cast<std::int64_t>(j) * d.lwork, d.lwork,
+            info + i)));
+      }
+      break;
+    }
+    case SolverType::C64: {
+      gpuComplex* a = static_cast<gpuComplex*>(buffers[2]);
+      gpuComplex* tau = static_cast<gpuComplex*>(buffers[1]);
+      gpuComplex* workspace = static_cast<gpuComplex*>(buffers[4]);
+      for (int i = 0; i < d.batch; ++i) {
+        int j = i % num_streams;
+        JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnCungqr(
+            handles[j].get(), d.m, d.n, d.k, a + i * a_step, d.m,
+            tau + static_cast<std::int64_t>(i) * d.k,
+            workspace + static_cast<std::int64_t>(j) * d.lwork, d.lwork,
+            info + i)));
+      }
+      break;
+    }
+    case SolverType::C128: {
+      gpuDoubleComplex* a = static_cast<gpuDoubleComplex*>(buffers[2]);
+      gpuDoubleComplex* tau = static_cast<gpuDoubleComplex*>(buffers[1]);
+      gpuDoubleComplex* workspace = static_cast<gpuDoubleComplex*>(buffers[4]);
+      for (int i = 0; i < d.batch; ++i) {
+        int j = i % num_streams;
+        JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnZungqr(
+            handles[j].get(), d.m, d.n, d.k, a + i * a_step, d.m,
+            tau + static_cast<std::int64_t>(i) * d.k,
+            workspace + static_cast<std::int64_t>(j) * d.lwork, d.lwork,
+            info + i)));
+      }
+      break;
+    }
+  }
+  for (int i = 0; i < num_streams; ++i) {
+    JAX_RETURN_IF_ERROR(
+        JAX_AS_STATUS(gpuEventRecord((*pool)->join[i], (*pool)->streams[i])));
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+        gpuStreamWaitEvent(stream, (*pool)->join[i], /*flags=*/0)));
+  }
+  return absl::OkStatus();
+}
+
+void OrgqrBatched(gpuStream_t stream, void** buffers, const char* opaque,
+                  size_t opaque_len, XlaCustomCallStatus* status) {
+  auto s = OrgqrBatched_(stream, buffers, opaque, opaque_len);
   if (!s.ok()) {
     XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
                                   s.message().length());
@@ -541,6 +733,29 @@ void Syevd(gpuStream_t stream, void** buffers, const char* opaque,
   }
 }
 
+// cusolver writes per-call residual/sweep statistics into the Jacobi
+// parameter objects, so one object must not be shared by concurrent
+// invocations. Cache one per solver handle instead: a pooled handle is lent
+// to a single stream at a time, so its parameter object is never used
+// concurrently. All callers run with the default tolerance and sweep count,
+// leaving the handle as the whole key; pooled handles live for the process
+// lifetime, so entries are never evicted.
+static absl::StatusOr<gpuSyevjInfo_t> GetCachedSyevjInfo(
+    gpusolverDnHandle_t handle) {
+  static absl::Mutex mu;
+  static auto& cache =
+      *new absl::flat_hash_map<gpusolverDnHandle_t, gpuSyevjInfo_t>();
+  absl::MutexLock lock(&mu);
+  auto it = cache.find(handle);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  gpuSyevjInfo_t params;
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnCreateSyevjInfo(&params)));
+  cache.emplace(handle, params);
+  return params;
+}
+
 // Symmetric (Hermitian) eigendecomposition, Jacobi algorithm: syevj/heevj
 // Supports batches of matrices up to size 32.
 
@@ -559,10 +774,8 @@ absl::Status Syevj_(gpuStream_t stream, void** buffers, const char* opaque,
             static_cast<std::int64_t>(d.n) * static_cast<std::int64_t>(d.n),
         gpuMemcpyDeviceToDevice, stream)));
   }
-  gpuSyevjInfo_t params;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusolverDnCreateSyevjInfo(&params)));
-  std::unique_ptr<gpuSyevjInfo, void (*)(gpuSyevjInfo_t)> params_cleanup(
-      params, [](gpuSyevjInfo_t p) { gpusolverDnDestroySyevjInfo(p); });
+  JAX_ASSIGN_OR_RETURN(gpuSyevjInfo_t params,
+                       GetCachedSyevjInfo(handle.get()));
 
   gpusolverEigMode_t jobz = GPUSOLVER_EIG_MODE_VECTOR;
   int* info = static_cast<int*>(buffers[3]);
@@ -758,6 +971,23 @@ void Gesvd(gpuStream_t stream, void** buffers, const char* opaque,
 
 #ifdef JAX_GPU_CUDA
 
+// Per-handle gesvdjInfo cache; see GetCachedSyevjInfo for the rationale.
+static absl::StatusOr<gesvdjInfo_t> GetCachedGesvdjInfo(
+    gpusolverDnHandle_t handle) {
+  static absl::Mutex mu;
+  static auto& cache =
+      *new absl::flat_hash_map<gpusolverDnHandle_t, gesvdjInfo_t>();
+  absl::MutexLock lock(&mu);
+  auto it = cache.find(handle);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  gesvdjInfo_t params;
+  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cusolverDnCreateGesvdjInfo(&params)));
+  cache.emplace(handle, params);
+  return params;
+}
+
 // Singular value decomposition using Jacobi algorithm: gesvdj
 
 static absl::Status Gesvdj_(gpuStream_t stream, void** buffers,
@@ -777,10 +1007,8 @@ static absl::Status Gesvdj_(gpuStream_t stream, void** buffers,
   }
   int* info = static_cast<int*>(buffers[5]);
   void* work = buffers[6];
-  gesvdjInfo_t params;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(cusolverDnCreateGesvdjInfo(&params)));
-  std::unique_ptr<gesvdjInfo, void (*)(gesvdjInfo*)> params_cleanup(
-      params, [](gesvdjInfo* p) { cusolverDnDestroyGesvdjInfo(p); });
+  JAX_ASSIGN_OR_RETURN(gesvdjInfo_t params,
+                       GetCachedGesvdjInfo(handle.get()));
   if (d.batch <= 1 || d.m > 32 || d.n > 32 || d.econ) {
     int k = std::min(d.m, d.n);
     switch (d.type) {
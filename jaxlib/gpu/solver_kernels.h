@@ -98,6 +98,22 @@ struct OrgqrDescriptor {
 void Orgqr(gpuStream_t stream, void** buffers, const char* opaque,
            size_t opaque_len, XlaCustomCallStatus* status);
 
+// Multi-stream variant of orgqr/ungqr for batches of small matrices. The
+// solver libraries have no batched API for forming Q, so the per-matrix calls
+// are fanned out over a pool of side streams instead. The workspace buffer
+// holds num_streams slices of lwork elements, one per side stream.
+
+// Number of side streams (and workspace slices) used by the batched path.
+inline constexpr int kOrgqrBatchedStreams = 4;
+
+struct OrgqrBatchedDescriptor {
+  SolverType type;
+  int batch, m, n, k, lwork, num_streams;
+};
+
+void OrgqrBatched(gpuStream_t stream, void** buffers, const char* opaque,
+                  size_t opaque_len, XlaCustomCallStatus* status);
+
 // Symmetric (Hermitian) eigendecomposition, QR algorithm: syevd/heevd
 
 struct SyevdDescriptor {
@@ -15,11 +15,13 @@ limitations under the License.
 
 #include <algorithm>
 #include <cstdint>
+#include <optional>
 #include <stdexcept>
 #include <utility>
 #include <vector>
 
 #include "nanobind/nanobind.h"
+#include "nanobind/stl/optional.h"
 #include "nanobind/stl/pair.h"
 #include "absl/base/casts.h"
 #include "absl/base/thread_annotations.h"
@@ -29,6 +31,7 @@ limitations under the License.
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
 #include "jaxlib/gpu/sparse_kernels.h"
 #include "jaxlib/gpu/vendor.h"
+#include "jaxlib/handle_pool.h"
 #include "jaxlib/kernel_nanobind_helpers.h"
 #include "xla/tsl/python/lib/core/numpy.h"
 
@@ -263,21 +266,23 @@ void CsrFromDense(gpuStream_t stream, void** buffers, const char* opaque,
 std::pair<size_t, nb::bytes> BuildCsrMatvecDescriptor(
     const dtype& data_dtype, const dtype& x_dtype,
     const dtype& compute_dtype, const dtype& index_dtype, int rows,
-    int cols, int nnz, bool transpose) {
+    int cols, int nnz, bool transpose, int batch_count) {
+  // With batch_count > 1 the kernel multiplies a stack of same-pattern
+  // matrices against a stack of vectors (y_i = A_i x_i) in a single
+  // strided-batch SpMM launch, treating the vectors as single-column
+  // matrices; cusparse has no batched SpMV. nnz is per batch element.
   auto h = SparseHandlePool::Borrow(/*stream=*/nullptr);
   JAX_THROW_IF_ERROR(h.status());
   auto& handle = *h;
   SparseMatDescriptor A =
       BuildSparseMatDescriptor(data_dtype, index_dtype, rows, cols, nnz,
-                               /*batch_count=*/1, /*batch_stride=*/0);
+                               batch_count, /*batch_stride=*/nnz);
   DenseVecDescriptor x =
       BuildDenseVecDescriptor(x_dtype, transpose ? rows : cols);
   DenseVecDescriptor y =
       BuildDenseVecDescriptor(compute_dtype, transpose ? cols : rows);
 
   gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnVecDescr_t vec_x = 0;
-  gpusparseDnVecDescr_t vec_y = 0;
   gpusparseOperation_t op = transpose ? GPUSPARSE_OPERATION_TRANSPOSE
                                       : GPUSPARSE_OPERATION_NON_TRANSPOSE;
 
@@ -287,20 +292,43 @@ std::pair<size_t, nb::bytes> BuildCsrMatvecDescriptor(
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCsr(
       &mat_a, A.rows, A.cols, A.nnz, empty, empty, empty, A.index_type,
       A.index_type, GPUSPARSE_INDEX_BASE_ZERO, A.value_type)));
-  JAX_THROW_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_x, x.size, empty, x.type)));
-  JAX_THROW_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_y, y.size, empty, y.type)));
   size_t buffer_size;
   SparseConst alpha = ConstOne(y.type);
   SparseConst beta = ConstZero(y.type);
-  JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseSpMV_bufferSize(
-      handle.get(), op, &alpha, mat_a, vec_x, &beta, vec_y, y.type,
-      GPUSPARSE_SPMV_CSR_ALG, &buffer_size)));
+  if (batch_count > 1) {
+    gpusparseDnMatDescr_t mat_x = 0;
+    gpusparseDnMatDescr_t mat_y = 0;
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCsrSetStridedBatch(
+        mat_a, /*batchCount=*/batch_count, /*offsetsBatchStride=*/rows + 1,
+        /*columnsValuesBatchStride=*/nnz)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
+        &mat_x, x.size, 1, /*ld=*/1, empty, x.type, GPUSPARSE_ORDER_ROW)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDnMatSetStridedBatch(
+        mat_x, /*batchCount=*/batch_count, /*batchStride=*/x.size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
+        &mat_y, y.size, 1, /*ld=*/1, empty, y.type, GPUSPARSE_ORDER_ROW)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDnMatSetStridedBatch(
+        mat_y, /*batchCount=*/batch_count, /*batchStride=*/y.size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseSpMM_bufferSize(
+        handle.get(), op, GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, mat_a,
+        mat_x, &beta, mat_y, y.type, GPUSPARSE_SPMM_CSR_ALG, &buffer_size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_x)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_y)));
+  } else {
+    gpusparseDnVecDescr_t vec_x = 0;
+    gpusparseDnVecDescr_t vec_y = 0;
+    JAX_THROW_IF_ERROR(
+        JAX_AS_STATUS(gpusparseCreateDnVec(&vec_x, x.size, empty, x.type)));
+    JAX_THROW_IF_ERROR(
+        JAX_AS_STATUS(gpusparseCreateDnVec(&vec_y, y.size, empty, y.type)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseSpMV_bufferSize(
+        handle.get(), op, &alpha, mat_a, vec_x, &beta, vec_y, y.type,
+        GPUSPARSE_SPMV_CSR_ALG, &buffer_size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_x)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_y)));
+  }
 
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_x)));
-  JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_y)));
 
   return {buffer_size, PackDescriptor(CsrMatvecDescriptor{A, x, y, op})};
 }
@@ -308,10 +336,18 @@ std::pair<size_t, nb::bytes> BuildCsrMatvecDescriptor(
 // CsrMatmat: Product of CSR matrix and dense matrix.
 
 // Returns the descriptor for a CsrMatmat operation.
+//
+// accum_dtype selects the SpMM accumulator (compute) type independently of
+// the storage dtypes; leaving it unset accumulates in the output dtype as
+// before. fp32 accumulation over fp16/bf16 operands engages the tensor-core
+// SpMM kernels on hardware that supports them. alg, when set, is the raw
+// vendor cusparseSpMM/hipsparseSpMM algorithm enum value; unset picks the
+// platform default.
 std::pair<size_t, nb::bytes> BuildCsrMatmatDescriptor(
     const dtype& data_dtype, const dtype& b_dtype,
     const dtype& compute_dtype, const dtype& index_dtype, int rows,
-    int cols, int BCcols, int nnz, bool transpose) {
+    int cols, int BCcols, int nnz, bool transpose,
+    std::optional<dtype> accum_dtype, std::optional<int> alg) {
   auto h = SparseHandlePool::Borrow(/*stream=*/nullptr);
   JAX_THROW_IF_ERROR(h.status());
   auto& handle = *h;
@@ -326,6 +362,10 @@ std::pair<size_t, nb::bytes> BuildCsrMatmatDescriptor(
                               /*batch_count=*/1, /*batch_stride=*/0);
   gpusparseOperation_t op_A = transpose ? GPUSPARSE_OPERATION_TRANSPOSE
                                         : GPUSPARSE_OPERATION_NON_TRANSPOSE;
+  gpuDataType compute_type =
+      accum_dtype ? DtypeToCudaDataType(*accum_dtype) : C.type;
+  gpusparseSpMMAlg_t spmm_alg =
+      alg ? static_cast<gpusparseSpMMAlg_t>(*alg) : GPUSPARSE_SPMM_CSR_ALG;
 
   gpusparseSpMatDescr_t mat_a = 0;
   gpusparseDnMatDescr_t mat_b = 0;
@@ -344,17 +384,18 @@ std::pair<size_t, nb::bytes> BuildCsrMatmatDescriptor(
       JAX_AS_STATUS(gpusparseCreateDnMat(&mat_c, C.rows, C.cols, /*ld=*/C.cols,
                                          empty, C.type, GPUSPARSE_ORDER_ROW)));
   size_t buffer_size;
-  SparseConst alpha = ConstOne(C.type);
-  SparseConst beta = ConstZero(C.type);
+  SparseConst alpha = ConstOne(compute_type);
+  SparseConst beta = ConstZero(compute_type);
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseSpMM_bufferSize(
       handle.get(), op_A, GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, mat_a,
-      mat_b, &beta, mat_c, C.type, GPUSPARSE_SPMM_CSR_ALG, &buffer_size)));
+      mat_b, &beta, mat_c, compute_type, spmm_alg, &buffer_size)));
 
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_b)));
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_c)));
 
-  return {buffer_size, PackDescriptor(CsrMatmatDescriptor{A, B, C, op_A})};
+  return {buffer_size, PackDescriptor(CsrMatmatDescriptor{
+                           A, B, C, op_A, compute_type, spmm_alg})};
 }
 
 // CooToDense: Convert COO matrix to dense matrix
@@ -436,21 +477,21 @@ std::pair<size_t, nb::bytes> BuildCooFromDenseDescriptor(
 std::pair<size_t, nb::bytes> BuildCooMatvecDescriptor(
     const dtype& data_dtype, const dtype& x_dtype,
     const dtype& compute_dtype, const dtype& index_dtype, int rows,
-    int cols, int nnz, bool transpose) {
+    int cols, int nnz, bool transpose, int batch_count) {
+  // See BuildCsrMatvecDescriptor: batch_count > 1 selects the strided-batch
+  // SpMM formulation (y_i = A_i x_i) with nnz counted per batch element.
   auto h = SparseHandlePool::Borrow(/*stream=*/nullptr);
   JAX_THROW_IF_ERROR(h.status());
   auto& handle = *h;
   SparseMatDescriptor A =
       BuildSparseMatDescriptor(data_dtype, index_dtype, rows, cols, nnz,
-                               /*batch_count=*/1, /*batch_stride=*/0);
+                               batch_count, /*batch_stride=*/nnz);
   DenseVecDescriptor x =
       BuildDenseVecDescriptor(x_dtype, transpose ? rows : cols);
   DenseVecDescriptor y =
       BuildDenseVecDescriptor(compute_dtype, transpose ? cols : rows);
 
   gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnVecDescr_t vec_x = 0;
-  gpusparseDnVecDescr_t vec_y = 0;
   gpusparseOperation_t op = transpose ? GPUSPARSE_OPERATION_TRANSPOSE
                                       : GPUSPARSE_OPERATION_NON_TRANSPOSE;
 
@@ -460,20 +501,42 @@ std::pair<size_t, nb::bytes> BuildCooMatvecDescriptor(
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCoo(
       &mat_a, A.rows, A.cols, A.nnz, empty, empty, empty, A.index_type,
       GPUSPARSE_INDEX_BASE_ZERO, A.value_type)));
-  JAX_THROW_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_x, x.size, empty, x.type)));
-  JAX_THROW_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_y, y.size, empty, y.type)));
   size_t buffer_size;
   SparseConst alpha = ConstOne(y.type);
   SparseConst beta = ConstZero(y.type);
-  JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseSpMV_bufferSize(
-      handle.get(), op, &alpha, mat_a, vec_x, &beta, vec_y, y.type,
-      GPUSPARSE_SPMV_COO_ALG, &buffer_size)));
+  if (batch_count > 1) {
+    gpusparseDnMatDescr_t mat_x = 0;
+    gpusparseDnMatDescr_t mat_y = 0;
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCooSetStridedBatch(
+        mat_a, /*batchCount=*/batch_count, /*batchStride=*/nnz)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
+        &mat_x, x.size, 1, /*ld=*/1, empty, x.type, GPUSPARSE_ORDER_ROW)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDnMatSetStridedBatch(
+        mat_x, /*batchCount=*/batch_count, /*batchStride=*/x.size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
+        &mat_y, y.size, 1, /*ld=*/1, empty, y.type, GPUSPARSE_ORDER_ROW)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDnMatSetStridedBatch(
+        mat_y, /*batchCount=*/batch_count, /*batchStride=*/y.size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseSpMM_bufferSize(
+        handle.get(), op, GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, mat_a,
+        mat_x, &beta, mat_y, y.type, GPUSPARSE_SPMM_COO_ALG, &buffer_size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_x)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_y)));
+  } else {
+    gpusparseDnVecDescr_t vec_x = 0;
+    gpusparseDnVecDescr_t vec_y = 0;
+    JAX_THROW_IF_ERROR(
+        JAX_AS_STATUS(gpusparseCreateDnVec(&vec_x, x.size, empty, x.type)));
+    JAX_THROW_IF_ERROR(
+        JAX_AS_STATUS(gpusparseCreateDnVec(&vec_y, y.size, empty, y.type)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseSpMV_bufferSize(
+        handle.get(), op, &alpha, mat_a, vec_x, &beta, vec_y, y.type,
+        GPUSPARSE_SPMV_COO_ALG, &buffer_size)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_x)));
+    JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_y)));
+  }
 
   JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_x)));
-  JAX_THROW_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_y)));
 
   return {buffer_size, PackDescriptor(CooMatvecDescriptor{A, x, y, op})};
 }
@@ -574,6 +637,31 @@ size_t Gtsv2BufferSizeF64(int m, int n, int ldb) {
   return Gtsv2BufferSize(gpusparseDgtsv2_bufferSizeExt, m, n, ldb);
 }
 
+// Workspace size for the single-launch gtsv2StridedBatch path the kernel
+// takes when each system has one right-hand side and batch > 1.
+template <typename F>
+size_t Gtsv2StridedBatchBufferSize(F f, int m, int batch) {
+  auto h = SparseHandlePool::Borrow(/*stream=*/nullptr);
+  JAX_THROW_IF_ERROR(h.status());
+  auto& handle = *h;
+  size_t size;
+  JAX_THROW_IF_ERROR(
+      JAX_AS_STATUS(f(handle.get(), m, /*dl=*/nullptr, /*d=*/nullptr,
+                      /*du=*/nullptr, /*x=*/nullptr, batch,
+                      /*batchStride=*/m, &size)));
+  return size;
+}
+
+size_t Gtsv2BatchedBufferSizeF32(int m, int batch) {
+  return Gtsv2StridedBatchBufferSize(gpusparseSgtsv2StridedBatch_bufferSizeExt,
+                                     m, batch);
+}
+
+size_t Gtsv2BatchedBufferSizeF64(int m, int batch) {
+  return Gtsv2StridedBatchBufferSize(gpusparseDgtsv2StridedBatch_bufferSizeExt,
+                                     m, batch);
+}
+
 nb::dict Registrations() {
   nb::dict dict;
 #if JAX_GPU_HAVE_SPARSE
@@ -610,7 +698,34 @@ NB_MODULE(_sparse, m) {
 #endif
   m.def("gtsv2_f32_buffer_size", &Gtsv2BufferSizeF32);
   m.def("gtsv2_f64_buffer_size", &Gtsv2BufferSizeF64);
+  m.def("gtsv2_batched_f32_buffer_size", &Gtsv2BatchedBufferSizeF32);
+  m.def("gtsv2_batched_f64_buffer_size", &Gtsv2BatchedBufferSizeF64);
   m.def("build_gtsv2_descriptor", &BuildGtsv2Descriptor);
+  m.def(
+      "prewarm",
+      [](std::uintptr_t stream, int count) {
+        JAX_THROW_IF_ERROR(SparseHandlePool::Prewarm(
+            reinterpret_cast<gpuStream_t>(stream), count));
+      },
+      nb::arg("stream") = 0, nb::arg("count") = 1);
+  m.def("handle_pool_stats", []() {
+    HandlePoolStats stats = SparseHandlePool::GetStats();
+    nb::dict d;
+    d["created"] = stats.created;
+    d["destroyed"] = stats.destroyed;
+    d["borrowed"] = stats.borrowed;
+    d["idle"] = stats.idle;
+    nb::dict per_stream;
+    for (const auto& [stream, idle] : stats.idle_per_stream) {
+      per_stream[nb::int_(stream)] = idle;
+    }
+    d["idle_per_stream"] = per_stream;
+    return d;
+  });
+  m.def(
+      "set_handle_pool_capacity",
+      [](std::int64_t max_idle) { SparseHandlePool::SetCapacity(max_idle); },
+      nb::arg("max_idle"));
 }
 
 }  // namespace
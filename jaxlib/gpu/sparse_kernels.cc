@@ -16,11 +16,18 @@ limitations under the License.
 #include "jaxlib/gpu/sparse_kernels.h"
 
 #include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstdlib>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
@@ -36,13 +43,9 @@ template <>
 /*static*/ absl::StatusOr<SparseHandlePool::Handle> SparseHandlePool::Borrow(
     gpuStream_t stream) {
   SparseHandlePool* pool = Instance();
-  absl::MutexLock lock(&pool->mu_);
   gpusparseHandle_t handle;
-  if (pool->handles_[stream].empty()) {
+  if (!pool->TryAcquire(stream, &handle)) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreate(&handle)));
-  } else {
-    handle = pool->handles_[stream].back();
-    pool->handles_[stream].pop_back();
   }
   if (stream) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseSetStream(handle, stream)));
@@ -50,6 +53,11 @@ template <>
   return Handle(pool, handle, stream);
 }
 
+template <>
+/*static*/ void SparseHandlePool::DestroyHandle(gpusparseHandle_t handle) {
+  gpusparseDestroy(handle);
+}
+
 namespace JAX_GPU_NAMESPACE {
 
 SparseConst ConstZero(gpuDataType type) {
@@ -143,6 +151,199 @@ SparseConst ConstOne(gpuDataType type) {
 }
 
 #if JAX_GPU_HAVE_SPARSE
+
+namespace {
+
+// cusparse binds the device pointers into its matrix/vector descriptors at
+// creation time, so repeated SpMV/SpMM calls over the same sparsity pattern
+// (and the same XLA buffer assignment, which is stable across steps) rebuild
+// identical descriptors every step. Cache them keyed on the packed jax-side
+// descriptor bytes plus the bound pointers. Descriptors are read-only during
+// the compute calls and may be shared by concurrent invocations (the
+// dense-to-sparse analysis records the nnz count inside its SpMat
+// descriptor, but invocations that could race on that would already be
+// racing on the underlying buffers). The caches
+// are cleared (descriptors destroyed) if they grow past a bound, which only
+// happens when buffer assignments churn and hits would be rare anyway.
+inline constexpr size_t kSparseDescriptorCacheMaxSize = 1024;
+
+struct SparseDescriptorCacheKey {
+  std::string descriptor;    // Packed jax-side descriptor contents.
+  std::array<void*, 3> ptrs; // Device pointers bound into the descriptor.
+
+  template <typename H>
+  friend H AbslHashValue(H h, const SparseDescriptorCacheKey& key) {
+    return H::combine(std::move(h), key.descriptor, key.ptrs);
+  }
+  bool operator==(const SparseDescriptorCacheKey& other) const {
+    return descriptor == other.descriptor && ptrs == other.ptrs;
+  }
+};
+
+// One mutex-guarded map per cusparse descriptor type. `create` is invoked on
+// a miss and must fill in the descriptor; `destroy` reclaims evicted entries.
+template <typename DescrT, typename CreateFn, typename DestroyFn>
+absl::StatusOr<DescrT> GetCachedSparseDescriptor(
+    absl::Mutex& mu, absl::flat_hash_map<SparseDescriptorCacheKey, DescrT>& cache,
+    SparseDescriptorCacheKey key, CreateFn create, DestroyFn destroy) {
+  absl::MutexLock lock(&mu);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  if (cache.size() >= kSparseDescriptorCacheMaxSize) {
+    for (auto& entry : cache) {
+      destroy(entry.second);
+    }
+    cache.clear();
+  }
+  DescrT descr = 0;
+  JAX_RETURN_IF_ERROR(create(&descr));
+  cache.emplace(std::move(key), descr);
+  return descr;
+}
+
+template <typename T>
+std::string PackKeyBytes(const T& descriptor, bool flag = false) {
+  std::string s(reinterpret_cast<const char*>(&descriptor), sizeof(T));
+  s.push_back(flag ? 1 : 0);
+  return s;
+}
+
+absl::StatusOr<gpusparseSpMatDescr_t> GetCachedCsrMat(
+    const SparseMatDescriptor& d, void* row_offsets, void* col_ind,
+    void* values, bool strided_batch) {
+  static absl::Mutex mu;
+  static auto& cache = *new absl::flat_hash_map<SparseDescriptorCacheKey,
+                                                gpusparseSpMatDescr_t>();
+  return GetCachedSparseDescriptor(
+      mu, cache,
+      SparseDescriptorCacheKey{PackKeyBytes(d, strided_batch),
+                               {row_offsets, col_ind, values}},
+      [&](gpusparseSpMatDescr_t* descr) -> absl::Status {
+        JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCsr(
+            descr, d.rows, d.cols, d.nnz, row_offsets, col_ind, values,
+            d.index_type, d.index_type, GPUSPARSE_INDEX_BASE_ZERO,
+            d.value_type)));
+        if (strided_batch) {
+          // The row-offsets arrays are stacked with one (rows + 1)-sized
+          // segment per batch element; columns and values share d.batch_stride.
+          JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCsrSetStridedBatch(
+              *descr, /*batchCount=*/d.batch_count,
+              /*offsetsBatchStride=*/d.rows + 1,
+              /*columnsValuesBatchStride=*/d.batch_stride)));
+        }
+        return absl::OkStatus();
+      },
+      [](gpusparseSpMatDescr_t descr) { gpusparseDestroySpMat(descr); });
+}
+
+absl::StatusOr<gpusparseSpMatDescr_t> GetCachedCooMat(
+    const SparseMatDescriptor& d, void* row_ind, void* col_ind, void* values,
+    bool strided_batch) {
+  static absl::Mutex mu;
+  static auto& cache = *new absl::flat_hash_map<SparseDescriptorCacheKey,
+                                                gpusparseSpMatDescr_t>();
+  return GetCachedSparseDescriptor(
+      mu, cache,
+      SparseDescriptorCacheKey{PackKeyBytes(d, strided_batch),
+                               {row_ind, col_ind, values}},
+      [&](gpusparseSpMatDescr_t* descr) -> absl::Status {
+        JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCoo(
+            descr, d.rows, d.cols, d.nnz, row_ind, col_ind, values,
+            d.index_type, GPUSPARSE_INDEX_BASE_ZERO, d.value_type)));
+        if (strided_batch) {
+          JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCooSetStridedBatch(
+              *descr, /*batchCount=*/d.batch_count,
+              /*batchStride=*/d.batch_stride)));
+        }
+        return absl::OkStatus();
+      },
+      [](gpusparseSpMatDescr_t descr) { gpusparseDestroySpMat(descr); });
+}
+
+absl::StatusOr<gpusparseDnVecDescr_t> GetCachedDnVec(
+    const DenseVecDescriptor& d, void* buf) {
+  static absl::Mutex mu;
+  static auto& cache = *new absl::flat_hash_map<SparseDescriptorCacheKey,
+                                                gpusparseDnVecDescr_t>();
+  return GetCachedSparseDescriptor(
+      mu, cache,
+      SparseDescriptorCacheKey{PackKeyBytes(d), {buf, nullptr, nullptr}},
+      [&](gpusparseDnVecDescr_t* descr) -> absl::Status {
+        return JAX_AS_STATUS(gpusparseCreateDnVec(descr, d.size, buf, d.type));
+      },
+      [](gpusparseDnVecDescr_t descr) { gpusparseDestroyDnVec(descr); });
+}
+
+absl::StatusOr<gpusparseDnMatDescr_t> GetCachedDnMat(
+    const DenseMatDescriptor& d, void* buf, bool strided_batch) {
+  static absl::Mutex mu;
+  static auto& cache = *new absl::flat_hash_map<SparseDescriptorCacheKey,
+                                                gpusparseDnMatDescr_t>();
+  return GetCachedSparseDescriptor(
+      mu, cache,
+      SparseDescriptorCacheKey{PackKeyBytes(d, strided_batch),
+                               {buf, nullptr, nullptr}},
+      [&](gpusparseDnMatDescr_t* descr) -> absl::Status {
+        JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
+            gpusparseCreateDnMat(descr, d.rows, d.cols,
+                                 /*ld=*/d.cols, buf, d.type,
+                                 GPUSPARSE_ORDER_ROW)));
+        if (strided_batch) {
+          JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDnMatSetStridedBatch(
+              *descr, /*batchCount=*/d.batch_count,
+              /*batchStride=*/d.batch_stride)));
+        }
+        return absl::OkStatus();
+      },
+      [](gpusparseDnMatDescr_t descr) { gpusparseDestroyDnMat(descr); });
+}
+
+// Opt-in inspection/execution split for SpMM, enabled by setting
+// JAX_GPU_SPMM_PREPROCESS (to anything but "0"). The one-time analysis pass
+// lets cusparse pick a tuned schedule for the sparsity pattern; it is run
+// once per cached descriptor triple and pays for itself when the same CSR
+// matrix is multiplied every iteration. Skipping the pass is always safe —
+// SpMM simply runs with its default schedule — so a stale entry after a
+// descriptor-cache eviction only costs the optimization, not correctness.
+bool SpMMPreprocessEnabled() {
+  static bool enabled = [] {
+    const char* value = std::getenv("JAX_GPU_SPMM_PREPROCESS");
+    return value != nullptr && std::string_view(value) != "0";
+  }();
+  return enabled;
+}
+
+absl::Status MaybePreprocessSpMM(gpusparseHandle_t handle,
+                                 gpusparseOperation_t op_a,
+                                 const SparseConst& alpha,
+                                 gpusparseSpMatDescr_t mat_a,
+                                 gpusparseDnMatDescr_t mat_b,
+                                 const SparseConst& beta,
+                                 gpusparseDnMatDescr_t mat_c, gpuDataType type,
+                                 gpusparseSpMMAlg_t alg,
+                                 void* buf) {
+  if (!SpMMPreprocessEnabled()) {
+    return absl::OkStatus();
+  }
+  static absl::Mutex mu;
+  static auto& preprocessed = *new absl::flat_hash_set<
+      std::tuple<gpusparseSpMatDescr_t, gpusparseDnMatDescr_t,
+                 gpusparseDnMatDescr_t, int>>();
+  absl::MutexLock lock(&mu);
+  if (!preprocessed
+           .insert({mat_a, mat_b, mat_c, static_cast<int>(op_a)})
+           .second) {
+    return absl::OkStatus();
+  }
+  return JAX_AS_STATUS(gpusparseSpMM_preprocess(
+      handle, op_a, /*opB=*/GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha, mat_a,
+      mat_b, &beta, mat_c, type, alg, buf));
+}
+
+}  // namespace
+
 // CsrToDense: Convert CSR matrix to dense matrix
 
 static absl::Status CsrToDense_(gpuStream_t stream, void** buffers,
@@ -154,24 +355,17 @@ static absl::Status CsrToDense_(gpuStream_t stream, void** buffers,
   JAX_RETURN_IF_ERROR(h.status());
   auto& handle = *h;
 
-  gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnMatDescr_t mat_b = 0;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseCreateCsr(&mat_a, d.rows, d.cols, d.nnz,
-                         /*csrRowOffsets=*/buffers[2],
-                         /*csrColInd=*/buffers[1],
-                         /*csrValues=*/buffers[0], d.index_type, d.index_type,
-                         GPUSPARSE_INDEX_BASE_ZERO, d.value_type)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_b, d.rows, d.cols,
-      /*ld=*/d.cols, buffers[3], d.value_type, GPUSPARSE_ORDER_ROW)));
+  auto mat_a = GetCachedCsrMat(d, /*row_offsets=*/buffers[2],
+                               /*col_ind=*/buffers[1], /*values=*/buffers[0],
+                               /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  DenseMatDescriptor dense{d.value_type, d.rows, d.cols};
+  auto mat_b = GetCachedDnMat(dense, buffers[3], /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_b.status());
 
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseSparseToDense(handle.get(), mat_a, mat_b,
+      gpusparseSparseToDense(handle.get(), *mat_a, *mat_b,
                              GPUSPARSE_SPARSETODENSE_ALG_DEFAULT, buffers[4])));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_b)));
   return absl::OkStatus();
 }
 
@@ -195,25 +389,22 @@ static absl::Status CsrFromDense_(gpuStream_t stream, void** buffers,
   JAX_RETURN_IF_ERROR(h.status());
   auto& handle = *h;
 
-  gpusparseDnMatDescr_t mat_a = 0;
-  gpusparseSpMatDescr_t mat_b = 0;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_a, d.rows, d.cols,
-      /*ld=*/d.cols, buffers[0], d.value_type, GPUSPARSE_ORDER_ROW)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseCreateCsr(&mat_b, d.rows, d.cols, d.nnz,
-                         /*csrRowOffsets=*/buffers[3],
-                         /*csrColInd=*/buffers[2],
-                         /*csrValues=*/buffers[1], d.index_type, d.index_type,
-                         GPUSPARSE_INDEX_BASE_ZERO, d.value_type)));
+  DenseMatDescriptor dense{d.value_type, d.rows, d.cols};
+  auto mat_a = GetCachedDnMat(dense, buffers[0], /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  auto mat_b = GetCachedCsrMat(d, /*row_offsets=*/buffers[3],
+                               /*col_ind=*/buffers[2], /*values=*/buffers[1],
+                               /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_b.status());
+  // The analysis pass itself must run every call: it scans the dense values
+  // to find the sparsity pattern, which changes with the data even when the
+  // shape (and hence the cached descriptors) does not.
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDenseToSparse_analysis(
-      handle.get(), mat_a, mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
+      handle.get(), *mat_a, *mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
       buffers[4])));
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDenseToSparse_convert(
-      handle.get(), mat_a, mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
+      handle.get(), *mat_a, *mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
       buffers[4])));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_b)));
   return absl::OkStatus();
 }
 
@@ -251,26 +442,38 @@ static absl::Status CsrMatvec_(gpuStream_t stream, void** buffers,
   SparseConst alpha = ConstOne(d.y.type);
   SparseConst beta = ConstZero(d.y.type);
 
-  gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnVecDescr_t vec_x = 0;
-  gpusparseDnVecDescr_t vec_y = 0;
+  if (d.A.batch_count > 1) {
+    // cusparse has no batched SpMV; issue the whole batch as one strided-batch
+    // SpMM with the vectors viewed as single-column matrices. One launch
+    // sequence replaces batch_count per-element custom calls.
+    auto mat_a = GetCachedCsrMat(d.A, csr_row_offsets, csr_col_ind, csr_values,
+                                 /*strided_batch=*/true);
+    JAX_RETURN_IF_ERROR(mat_a.status());
+    DenseMatDescriptor x_mat{d.x.type, d.x.size, 1, d.A.batch_count, d.x.size};
+    auto mat_x = GetCachedDnMat(x_mat, xbuf, /*strided_batch=*/true);
+    JAX_RETURN_IF_ERROR(mat_x.status());
+    DenseMatDescriptor y_mat{d.y.type, d.y.size, 1, d.A.batch_count, d.y.size};
+    auto mat_y = GetCachedDnMat(y_mat, ybuf, /*strided_batch=*/true);
+    JAX_RETURN_IF_ERROR(mat_y.status());
+
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseSpMM(
+        handle.get(), d.op, /*opB=*/GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
+        *mat_a, *mat_x, &beta, *mat_y, d.y.type, GPUSPARSE_SPMM_CSR_ALG,
+        buf)));
+    return absl::OkStatus();
+  }
 
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCsr(
-      &mat_a, d.A.rows, d.A.cols, d.A.nnz, csr_row_offsets, csr_col_ind,
-      csr_values, d.A.index_type, d.A.index_type, GPUSPARSE_INDEX_BASE_ZERO,
-      d.A.value_type)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_x, d.x.size, xbuf, d.x.type)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_y, d.y.size, ybuf, d.y.type)));
+  auto mat_a = GetCachedCsrMat(d.A, csr_row_offsets, csr_col_ind, csr_values,
+                               /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  auto vec_x = GetCachedDnVec(d.x, xbuf);
+  JAX_RETURN_IF_ERROR(vec_x.status());
+  auto vec_y = GetCachedDnVec(d.y, ybuf);
+  JAX_RETURN_IF_ERROR(vec_y.status());
 
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseSpMV(handle.get(), d.op, &alpha, mat_a, vec_x, &beta, vec_y,
+      gpusparseSpMV(handle.get(), d.op, &alpha, *mat_a, *vec_x, &beta, *vec_y,
                     d.y.type, GPUSPARSE_SPMV_CSR_ALG, buf)));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_x)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_y)));
   return absl::OkStatus();
 }
 
@@ -305,30 +508,24 @@ static absl::Status CsrMatmat_(gpuStream_t stream, void** buffers,
   // are sufficient for basic matvec operations.
   // Note that, contrary to cusparse docs, alpha and beta must be host pointers
   // or else the operation will segfault.
-  SparseConst alpha = ConstOne(d.C.type);
-  SparseConst beta = ConstZero(d.C.type);
-
-  gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnMatDescr_t mat_b = 0;
-  gpusparseDnMatDescr_t mat_c = 0;
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCsr(
-      &mat_a, d.A.rows, d.A.cols, d.A.nnz, csr_row_offsets, csr_col_ind,
-      csr_values, d.A.index_type, d.A.index_type, GPUSPARSE_INDEX_BASE_ZERO,
-      d.A.value_type)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_b, d.B.rows, d.B.cols,
-      /*ld=*/d.B.cols, Bbuf, d.B.type, GPUSPARSE_ORDER_ROW)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_c, d.C.rows, d.C.cols,
-      /*ld=*/d.C.cols, Cbuf, d.C.type, GPUSPARSE_ORDER_ROW)));
+  // alpha/beta take the accumulator type, not the storage type.
+  SparseConst alpha = ConstOne(d.compute_type);
+  SparseConst beta = ConstZero(d.compute_type);
+
+  auto mat_a = GetCachedCsrMat(d.A, csr_row_offsets, csr_col_ind, csr_values,
+                               /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  auto mat_b = GetCachedDnMat(d.B, Bbuf, /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_b.status());
+  auto mat_c = GetCachedDnMat(d.C, Cbuf, /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_c.status());
+
+  JAX_RETURN_IF_ERROR(MaybePreprocessSpMM(handle.get(), d.op_A, alpha, *mat_a,
+                                          *mat_b, beta, *mat_c, d.compute_type,
+                                          d.alg, buf));
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseSpMM(
       handle.get(), d.op_A, /*opB=*/GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
-      mat_a, mat_b, &beta, mat_c, d.C.type, GPUSPARSE_SPMM_CSR_ALG, buf)));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_b)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_c)));
+      *mat_a, *mat_b, &beta, *mat_c, d.compute_type, d.alg, buf)));
   return absl::OkStatus();
 }
 
@@ -352,24 +549,17 @@ static absl::Status CooToDense_(gpuStream_t stream, void** buffers,
   JAX_RETURN_IF_ERROR(h.status());
   auto& handle = *h;
 
-  gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnMatDescr_t mat_b = 0;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseCreateCoo(&mat_a, d.rows, d.cols, d.nnz,
-                         /*cooRowInd=*/buffers[1],
-                         /*cooColInd=*/buffers[2],
-                         /*cooValues=*/buffers[0], d.index_type,
-                         GPUSPARSE_INDEX_BASE_ZERO, d.value_type)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_b, d.rows, d.cols,
-      /*ld=*/d.cols, buffers[3], d.value_type, GPUSPARSE_ORDER_ROW)));
+  auto mat_a = GetCachedCooMat(d, /*row_ind=*/buffers[1],
+                               /*col_ind=*/buffers[2], /*values=*/buffers[0],
+                               /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  DenseMatDescriptor dense{d.value_type, d.rows, d.cols};
+  auto mat_b = GetCachedDnMat(dense, buffers[3], /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_b.status());
 
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseSparseToDense(handle.get(), mat_a, mat_b,
+      gpusparseSparseToDense(handle.get(), *mat_a, *mat_b,
                              GPUSPARSE_SPARSETODENSE_ALG_DEFAULT, buffers[4])));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_b)));
   return absl::OkStatus();
 }
 
@@ -393,25 +583,21 @@ static absl::Status CooFromDense_(gpuStream_t stream, void** buffers,
   JAX_RETURN_IF_ERROR(h.status());
   auto& handle = *h;
 
-  gpusparseDnMatDescr_t mat_a = 0;
-  gpusparseSpMatDescr_t mat_b = 0;
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_a, d.rows, d.cols,
-      /*ld=*/d.cols, buffers[0], d.value_type, GPUSPARSE_ORDER_ROW)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseCreateCoo(&mat_b, d.rows, d.cols, d.nnz,
-                         /*cooRowInd=*/buffers[2],
-                         /*cooColInd=*/buffers[3],
-                         /*cooValues=*/buffers[1], d.index_type,
-                         GPUSPARSE_INDEX_BASE_ZERO, d.value_type)));
+  DenseMatDescriptor dense{d.value_type, d.rows, d.cols};
+  auto mat_a = GetCachedDnMat(dense, buffers[0], /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  auto mat_b = GetCachedCooMat(d, /*row_ind=*/buffers[2],
+                               /*col_ind=*/buffers[3], /*values=*/buffers[1],
+                               /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_b.status());
+  // As in CsrFromDense_, only the descriptors are cached; the analysis pass
+  // is data-dependent and must run every call.
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDenseToSparse_analysis(
-      handle.get(), mat_a, mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
+      handle.get(), *mat_a, *mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
       buffers[4])));
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDenseToSparse_convert(
-      handle.get(), mat_a, mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
+      handle.get(), *mat_a, *mat_b, GPUSPARSE_DENSETOSPARSE_ALG_DEFAULT,
       buffers[4])));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_b)));
   return absl::OkStatus();
 }
 
@@ -449,25 +635,37 @@ static absl::Status CooMatvec_(gpuStream_t stream, void** buffers,
   SparseConst alpha = ConstOne(d.y.type);
   SparseConst beta = ConstZero(d.y.type);
 
-  gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnVecDescr_t vec_x = 0;
-  gpusparseDnVecDescr_t vec_y = 0;
+  if (d.A.batch_count > 1) {
+    // As in CsrMatvec_: no batched SpMV exists, so run one strided-batch SpMM
+    // over single-column dense matrices instead of a call per batch element.
+    auto mat_a = GetCachedCooMat(d.A, coo_row_ind, coo_col_ind, coo_values,
+                                 /*strided_batch=*/true);
+    JAX_RETURN_IF_ERROR(mat_a.status());
+    DenseMatDescriptor x_mat{d.x.type, d.x.size, 1, d.A.batch_count, d.x.size};
+    auto mat_x = GetCachedDnMat(x_mat, xbuf, /*strided_batch=*/true);
+    JAX_RETURN_IF_ERROR(mat_x.status());
+    DenseMatDescriptor y_mat{d.y.type, d.y.size, 1, d.A.batch_count, d.y.size};
+    auto mat_y = GetCachedDnMat(y_mat, ybuf, /*strided_batch=*/true);
+    JAX_RETURN_IF_ERROR(mat_y.status());
+
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseSpMM(
+        handle.get(), d.op, /*opB=*/GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
+        *mat_a, *mat_x, &beta, *mat_y, d.y.type, GPUSPARSE_SPMM_COO_ALG,
+        buf)));
+    return absl::OkStatus();
+  }
 
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCoo(
-      &mat_a, d.A.rows, d.A.cols, d.A.nnz, coo_row_ind, coo_col_ind, coo_values,
-      d.A.index_type, GPUSPARSE_INDEX_BASE_ZERO, d.A.value_type)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_x, d.x.size, xbuf, d.x.type)));
-  JAX_RETURN_IF_ERROR(
-      JAX_AS_STATUS(gpusparseCreateDnVec(&vec_y, d.y.size, ybuf, d.y.type)));
+  auto mat_a = GetCachedCooMat(d.A, coo_row_ind, coo_col_ind, coo_values,
+                               /*strided_batch=*/false);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  auto vec_x = GetCachedDnVec(d.x, xbuf);
+  JAX_RETURN_IF_ERROR(vec_x.status());
+  auto vec_y = GetCachedDnVec(d.y, ybuf);
+  JAX_RETURN_IF_ERROR(vec_y.status());
 
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseSpMV(handle.get(), d.op, &alpha, mat_a, vec_x, &beta, vec_y,
+      gpusparseSpMV(handle.get(), d.op, &alpha, *mat_a, *vec_x, &beta, *vec_y,
                     d.y.type, GPUSPARSE_SPMV_COO_ALG, buf)));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_x)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnVec(vec_y)));
   return absl::OkStatus();
 }
 
@@ -505,35 +703,17 @@ static absl::Status CooMatmat_(gpuStream_t stream, void** buffers,
   SparseConst alpha = ConstOne(d.C.type);
   SparseConst beta = ConstZero(d.C.type);
 
-  gpusparseSpMatDescr_t mat_a = 0;
-  gpusparseDnMatDescr_t mat_b = 0;
-  gpusparseDnMatDescr_t mat_c = 0;
+  auto mat_a = GetCachedCooMat(d.A, coo_row_ind, coo_col_ind, coo_values,
+                               /*strided_batch=*/true);
+  JAX_RETURN_IF_ERROR(mat_a.status());
+  auto mat_b = GetCachedDnMat(d.B, Bbuf, /*strided_batch=*/true);
+  JAX_RETURN_IF_ERROR(mat_b.status());
+  auto mat_c = GetCachedDnMat(d.C, Cbuf, /*strided_batch=*/true);
+  JAX_RETURN_IF_ERROR(mat_c.status());
 
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateCoo(
-      &mat_a, d.A.rows, d.A.cols, d.A.nnz, coo_row_ind, coo_col_ind, coo_values,
-      d.A.index_type, GPUSPARSE_INDEX_BASE_ZERO, d.A.value_type)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseCooSetStridedBatch(mat_a, /*batchCount=*/d.A.batch_count,
-                                  /*batchStride=*/d.A.batch_stride)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_b, d.B.rows, d.B.cols,
-      /*ld=*/d.B.cols, Bbuf, d.B.type, GPUSPARSE_ORDER_ROW)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseDnMatSetStridedBatch(mat_b, /*batchCount=*/d.B.batch_count,
-                                    /*batchStride=*/d.B.batch_stride)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseCreateDnMat(
-      &mat_c, d.C.rows, d.C.cols,
-      /*ld=*/d.C.cols, Cbuf, d.C.type, GPUSPARSE_ORDER_ROW)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
-      gpusparseDnMatSetStridedBatch(mat_c, /*batchCount=*/d.C.batch_count,
-                                    /*batchStride=*/d.C.batch_stride)));
   JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseSpMM(
       handle.get(), d.op_A, /*opB=*/GPUSPARSE_OPERATION_NON_TRANSPOSE, &alpha,
-      mat_a, mat_b, &beta, mat_c, d.C.type, GPUSPARSE_SPMM_COO_ALG, buf)));
-
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroySpMat(mat_a)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_b)));
-  JAX_RETURN_IF_ERROR(JAX_AS_STATUS(gpusparseDestroyDnMat(mat_c)));
+      *mat_a, *mat_b, &beta, *mat_c, d.C.type, GPUSPARSE_SPMM_COO_ALG, buf)));
   return absl::OkStatus();
 }
 
@@ -547,8 +727,9 @@ void CooMatmat(gpuStream_t stream, void** buffers, const char* opaque,
 }
 #endif  // if JAX_GPU_HAVE_SPARSE
 
-template <typename T, typename F>
-static absl::Status gtsv2(F computeGtsv2, gpuStream_t stream, void** buffers,
+template <typename T, typename F, typename FB>
+static absl::Status gtsv2(F computeGtsv2, FB computeGtsv2StridedBatch,
+                          gpuStream_t stream, void** buffers,
                           const char* opaque, std::size_t opaque_len) {
   auto h = SparseHandlePool::Borrow(stream);
   JAX_RETURN_IF_ERROR(h.status());
@@ -580,6 +761,15 @@ static absl::Status gtsv2(F computeGtsv2, gpuStream_t stream, void** buffers,
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(
         gpuMemcpyAsync(X, B, B_bytes, gpuMemcpyDeviceToDevice, stream)));
   }
+  // With a single right-hand side per system the diagonals and solutions are
+  // already laid out consecutively with stride m, which is exactly the layout
+  // gtsv2StridedBatch expects, so the whole batch goes down in one launch
+  // instead of one per system. The lowering sizes the workspace accordingly.
+  if (n == 1 && batch > 1) {
+    JAX_RETURN_IF_ERROR(JAX_AS_STATUS(computeGtsv2StridedBatch(
+        handle.get(), m, dl, d, du, X, batch, /*batchStride=*/m, buffer)));
+    return absl::OkStatus();
+  }
   for (int i = 0; i < batch; ++i) {
     JAX_RETURN_IF_ERROR(JAX_AS_STATUS(computeGtsv2(
         handle.get(), m, n, dl, d, du, X, ldb, buffer)));
@@ -593,7 +783,8 @@ static absl::Status gtsv2(F computeGtsv2, gpuStream_t stream, void** buffers,
 
 void gtsv2_f32(gpuStream_t stream, void** buffers, const char* opaque,
                std::size_t opaque_len, XlaCustomCallStatus* status) {
-  auto s = gtsv2<float>(gpusparseSgtsv2, stream, buffers, opaque, opaque_len);
+  auto s = gtsv2<float>(gpusparseSgtsv2, gpusparseSgtsv2StridedBatch, stream,
+                        buffers, opaque, opaque_len);
   if (!s.ok()) {
     XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
                                   s.message().length());
@@ -602,7 +793,8 @@ void gtsv2_f32(gpuStream_t stream, void** buffers, const char* opaque,
 
 void gtsv2_f64(gpuStream_t stream, void** buffers, const char* opaque,
                std::size_t opaque_len, XlaCustomCallStatus* status) {
-  auto s = gtsv2<double>(gpusparseDgtsv2, stream, buffers, opaque, opaque_len);
+  auto s = gtsv2<double>(gpusparseDgtsv2, gpusparseDgtsv2StridedBatch, stream,
+                         buffers, opaque, opaque_len);
   if (!s.ok()) {
     XlaCustomCallStatusSetFailure(status, std::string(s.message()).c_str(),
                                   s.message().length());
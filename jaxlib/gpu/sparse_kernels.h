@@ -101,6 +101,11 @@ struct CsrMatmatDescriptor {
   SparseMatDescriptor A;
   DenseMatDescriptor B, C;
   gpusparseOperation_t op_A;
+  // SpMM accumulator type and algorithm. compute_type may differ from the
+  // storage types — e.g. fp32 accumulation over fp16/bf16 operands, which
+  // selects the tensor-core kernels on hardware that has them.
+  gpuDataType compute_type;
+  gpusparseSpMMAlg_t alg;
 };
 
 void CsrMatmat(gpuStream_t stream, void** buffers, const char* opaque,
@@ -14,6 +14,7 @@
 #include "absl/status/statusor.h"
 #include "jaxlib/absl_status_casters.h"
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
+#include "jaxlib/gpu/launch_latency.h"
 #include "jaxlib/gpu/triton.pb.h"
 #include "jaxlib/gpu/triton_kernels.h"
 #include "jaxlib/gpu/triton_utils.h"
@@ -121,8 +122,24 @@ NB_MODULE(_triton, m) {
   m.def("get_custom_call",
         [] { return EncapsulateFunction(&TritonKernelCall); });
 
+  // Produces the codec-framed custom-call payload for a serialized
+  // TritonAnyKernelCall. Prefer this over compressing with zlib in Python:
+  // the payload both compresses and decompresses several times faster.
+  m.def("compress_kernel_call_proto",
+        ValueOrThrowWrapper([](nb::bytes serialized) -> absl::StatusOr<nb::bytes> {
+          // Copy the payload out while the GIL is held, then compress with it
+          // released; kernel-call protos can be large and the compression is
+          // pure native work.
+          std::string input(serialized.c_str(), serialized.size());
+          JAX_ASSIGN_OR_RETURN(std::string payload, [&] {
+            ScopedGilRelease release;
+            return CompressTritonKernelCallProto(input);
+          }());
+          return nb::bytes(payload.c_str(), payload.size());
+        }));
+
   m.def("get_compute_capability",
-        ValueOrThrowWrapper([](int device) -> absl::StatusOr<int> {
+        ValueOrThrowNoGilWrapper([](int device) -> absl::StatusOr<int> {
           int major, minor;
           GPU_RETURN_IF_ERROR(gpuInit(device));
           GPU_RETURN_IF_ERROR(gpuDeviceGetAttribute(
@@ -135,12 +152,44 @@ NB_MODULE(_triton, m) {
   m.def("get_serialized_metadata",
         ValueOrThrowWrapper(
             [](nb::bytes opaque) -> absl::StatusOr<nb::bytes> {
-              JAX_ASSIGN_OR_RETURN(
-                  std::string metadata,
-                  GetTritonKernelCallSerializedMetadata(
-                      absl::string_view(opaque.c_str(), opaque.size())));
+              // Decompresses the payload, so run it with the GIL released.
+              std::string input(opaque.c_str(), opaque.size());
+              JAX_ASSIGN_OR_RETURN(std::string metadata, [&] {
+                ScopedGilRelease release;
+                return GetTritonKernelCallSerializedMetadata(input);
+              }());
               return nb::bytes(metadata.c_str(), metadata.size());
             }));
+
+  m.def("get_autotune_results",
+        ValueOrThrowWrapper([]() -> absl::StatusOr<nb::bytes> {
+          JAX_ASSIGN_OR_RETURN(std::string results,
+                               SerializeAutotuneResults());
+          return nb::bytes(results.c_str(), results.size());
+        }));
+
+  m.def("load_autotune_results",
+        ThrowIfErrorWrapper([](nb::bytes serialized) -> absl::Status {
+          return LoadAutotuneResults(
+              absl::string_view(serialized.c_str(), serialized.size()));
+        }));
+
+  m.def("get_launch_latency_histograms", []() {
+    // Cumulative per-kernel launch-latency histograms; bucket i counts
+    // launches that took [2^i, 2^(i+1)) nanoseconds from custom-call entry
+    // to launch return. Scrapers should compute deltas between snapshots.
+    nb::dict histograms;
+    for (const auto& [name, histogram] : SnapshotLaunchLatencies()) {
+      nb::dict entry;
+      entry["count"] = histogram.count;
+      entry["total_ns"] = histogram.total_ns;
+      std::vector<uint64_t> buckets(
+          histogram.buckets, histogram.buckets + kLaunchLatencyBuckets);
+      entry["buckets"] = buckets;
+      histograms[nb::cast(name)] = entry;
+    }
+    return histograms;
+  });
 }
 
 }  // namespace jax::JAX_GPU_NAMESPACE
@@ -1,9 +1,11 @@
 #include "jaxlib/gpu/triton_kernels.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <limits>
 #include <memory>
 #include <string>
@@ -27,11 +29,13 @@
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
+#include "jaxlib/gpu/launch_latency.h"
 #include "jaxlib/gpu/triton.pb.h"
 #include "jaxlib/gpu/triton_utils.h"
 #include "jaxlib/gpu/vendor.h"
 #include "xla/service/custom_call_status.h"
 #include "tsl/platform/env.h"
+#include "tsl/platform/fingerprint.h"
 
 #ifdef JAX_GPU_CUDA
 #include "xla/stream_executor/cuda/cuda_asm_compiler.h"
@@ -97,13 +101,45 @@ absl::StatusOr<ModuleImage*> GetModuleImage(std::string kernel_name,
       tsl::ReadFileToString(tsl::Env::Default(), fname, &result_blob));
   std::vector<uint8_t> module_image(result_blob.begin(), result_blob.end());
 #else
-  // TODO(cjfj): Support `TRITON_PTXAS_PATH` environment variable?
-  int cc_major = compute_capability / 10;
-  int cc_minor = compute_capability % 10;
-  JAX_ASSIGN_OR_RETURN(
-      std::vector<uint8_t> module_image,
-      stream_executor::CompileGpuAsm(cc_major, cc_minor, ptx.data(),
-                                     stream_executor::GpuAsmOpts{}));
+  // Optional second-level cache of compiled images on disk, so that process
+  // restarts do not re-run ptxas over every kernel. The file name encodes a
+  // stable fingerprint of the kernel name, shared memory usage, PTX and
+  // compute capability.
+  std::string cache_path;
+  const char* cache_dir = getenv("JAX_TRITON_CACHE_DIR");
+  if (cache_dir != nullptr && cache_dir[0] != '\0') {
+    tsl::Fprint128 fprint = tsl::Fingerprint128(
+        absl::StrFormat("%s|%u|%d|%s", kernel_name, shared_mem_bytes,
+                        compute_capability, ptx));
+    cache_path = absl::StrFormat("%s/jax_triton_%016x%016x.cubin", cache_dir,
+                                 fprint.high64, fprint.low64);
+  }
+
+  std::vector<uint8_t> module_image;
+  std::string cached_blob;
+  if (!cache_path.empty() &&
+      tsl::ReadFileToString(tsl::Env::Default(), cache_path, &cached_blob)
+          .ok()) {
+    module_image.assign(cached_blob.begin(), cached_blob.end());
+  } else {
+    // TODO(cjfj): Support `TRITON_PTXAS_PATH` environment variable?
+    int cc_major = compute_capability / 10;
+    int cc_minor = compute_capability % 10;
+    JAX_ASSIGN_OR_RETURN(
+        module_image,
+        stream_executor::CompileGpuAsm(cc_major, cc_minor, ptx.data(),
+                                       stream_executor::GpuAsmOpts{}));
+    if (!cache_path.empty()) {
+      // Best-effort, atomic via rename; a failed write only costs a
+      // recompilation in a later process.
+      std::string tmp_path = absl::StrFormat(
+          "%s.tmp.%u", cache_path, tsl::Env::Default()->NowMicros());
+      std::string blob(module_image.begin(), module_image.end());
+      if (tsl::WriteStringToFile(tsl::Env::Default(), tmp_path, blob).ok()) {
+        tsl::Env::Default()->RenameFile(tmp_path, cache_path).IgnoreError();
+      }
+    }
+  }
 #endif
 
   auto [it2, success] = module_images.insert(
@@ -133,31 +169,54 @@ absl::StatusOr<float> Benchmark(gpuStream_t stream, KernelCall& kernel_call,
   return elapsed_ms;
 }
 
+// Process-wide cache of resolved kernel calls, plus the autotuning decisions
+// behind them so they can be exported to, or imported from, other hosts.
+struct KernelCallCache {
+  absl::Mutex mutex;
+  absl::flat_hash_map<std::string, std::unique_ptr<KernelCall>> kernel_calls
+      ABSL_GUARDED_BY(mutex);
+  // Autotuning winners, keyed by fingerprint of the opaque descriptor. Local
+  // autotuning runs populate this; imported entries pre-empt autotuning.
+  absl::flat_hash_map<std::string, jax_triton::TritonKernelCall>
+      autotune_results ABSL_GUARDED_BY(mutex);
+};
+
+KernelCallCache& GetKernelCallCache() {
+  static auto* cache = new KernelCallCache;
+  return *cache;
+}
+
+// Stable fingerprint of an opaque kernel-call descriptor, used to match
+// autotuning decisions across identical processes.
+std::string DescriptorFingerprint(absl::string_view opaque) {
+  tsl::Fprint128 fprint = tsl::Fingerprint128(opaque);
+  return absl::StrFormat("%016x%016x", fprint.high64, fprint.low64);
+}
+
 absl::StatusOr<KernelCall*> GetKernelCall(absl::string_view opaque,
                                           gpuStream_t stream, void** buffers) {
-  static absl::Mutex mutex;
-  static auto& kernel_calls =
-      *new absl::flat_hash_map<std::string, std::unique_ptr<KernelCall>>
-          ABSL_GUARDED_BY(mutex);
-
+  KernelCallCache& cache = GetKernelCallCache();
   {
     // Fast path uses reader lock (as hash map look-up is relatively slow).
-    absl::ReaderMutexLock lock(&mutex);
-    auto it = kernel_calls.find(opaque);
-    if (ABSL_PREDICT_TRUE(it != kernel_calls.end())) return it->second.get();
+    absl::ReaderMutexLock lock(&cache.mutex);
+    auto it = cache.kernel_calls.find(opaque);
+    if (ABSL_PREDICT_TRUE(it != cache.kernel_calls.end()))
+      return it->second.get();
   }
 
   if (opaque.empty()) {
     return absl::InvalidArgumentError("Opaque data is empty.");
   }
 
-  absl::MutexLock lock(&mutex);
-  std::unique_ptr<KernelCall>& kernel_call = kernel_calls[opaque];
+  absl::MutexLock lock(&cache.mutex);
+  std::unique_ptr<KernelCall>& kernel_call = cache.kernel_calls[opaque];
   // We released the reader lock, so it may have been written by another thread.
   if (kernel_call != nullptr) return kernel_call.get();
 
-  // The opaque data is a zlib compressed protobuf.
-  JAX_ASSIGN_OR_RETURN(std::string serialized, ZlibUncompress(opaque));
+  // The opaque data is a compressed protobuf (bare zlib from legacy
+  // producers, or a codec-framed payload; see triton_utils.h).
+  JAX_ASSIGN_OR_RETURN(std::string serialized,
+                       UncompressTritonKernelCallPayload(opaque));
 
   jax_triton::TritonAnyKernelCall proto;
   if (!proto.ParseFromString(serialized)) {
@@ -169,14 +228,22 @@ absl::StatusOr<KernelCall*> GetKernelCall(absl::string_view opaque,
                          KernelCall::FromProto(proto.kernel_call()));
     kernel_call = std::make_unique<KernelCall>(std::move(kernel_call_));
   } else if (proto.has_autotuned_kernel_call()) {
-    JAX_ASSIGN_OR_RETURN(
-        AutotunedKernelCall autotuned_call,
-        AutotunedKernelCall::FromProto(proto.autotuned_kernel_call()));
-    {
+    std::string fingerprint = DescriptorFingerprint(opaque);
+    auto imported = cache.autotune_results.find(fingerprint);
+    if (imported != cache.autotune_results.end()) {
+      // Another host (or a previous run) already picked a winning config.
+      JAX_ASSIGN_OR_RETURN(KernelCall kernel_call_,
+                           KernelCall::FromProto(imported->second));
+      kernel_call = std::make_unique<KernelCall>(std::move(kernel_call_));
+    } else {
+      JAX_ASSIGN_OR_RETURN(
+          AutotunedKernelCall autotuned_call,
+          AutotunedKernelCall::FromProto(proto.autotuned_kernel_call()));
       JAX_ASSIGN_OR_RETURN(KernelCall kernel_call_,
                            AutotunedKernelCall::Autotune(
                                std::move(autotuned_call), stream, buffers));
       kernel_call = std::make_unique<KernelCall>(std::move(kernel_call_));
+      cache.autotune_results[fingerprint] = kernel_call->ToProto();
     }
   } else {
     return absl::InvalidArgumentError("Unknown kernel call type.");
@@ -187,6 +254,33 @@ absl::StatusOr<KernelCall*> GetKernelCall(absl::string_view opaque,
 
 }  // namespace
 
+absl::StatusOr<std::string> SerializeAutotuneResults() {
+  KernelCallCache& cache = GetKernelCallCache();
+  absl::MutexLock lock(&cache.mutex);
+  jax_triton::TritonAutotuneCache proto;
+  for (const auto& [fingerprint, kernel_call] : cache.autotune_results) {
+    jax_triton::TritonAutotuneCache_Entry* entry = proto.add_entries();
+    entry->set_descriptor_fingerprint(fingerprint);
+    *entry->mutable_kernel_call() = kernel_call;
+  }
+  return proto.SerializeAsString();
+}
+
+absl::Status LoadAutotuneResults(absl::string_view serialized) {
+  jax_triton::TritonAutotuneCache proto;
+  if (!proto.ParseFromString(std::string(serialized))) {
+    return absl::InvalidArgumentError(
+        "Failed to parse serialized autotune results.");
+  }
+  KernelCallCache& cache = GetKernelCallCache();
+  absl::MutexLock lock(&cache.mutex);
+  for (const jax_triton::TritonAutotuneCache_Entry& entry : proto.entries()) {
+    cache.autotune_results[entry.descriptor_fingerprint()] =
+        entry.kernel_call();
+  }
+  return absl::OkStatus();
+}
+
 class ModuleImage {
  public:
   ModuleImage(std::string_view kernel_name, std::vector<uint8_t> module_image,
@@ -441,36 +535,73 @@ KernelCall::KernelCall(Kernel kernel, uint32_t grid_0, uint32_t grid_1,
                        uint32_t grid_2, std::vector<Parameter> parameters)
     : kernel_(std::move(kernel)),
       grid_{grid_0, grid_1, grid_2},
-      parameters_(std::move(parameters)) {}
+      parameters_(std::move(parameters)) {
+  BuildParamBlock();
+}
 
-absl::Status KernelCall::Launch(gpuStream_t stream, void** buffers) {
-  std::vector<void*> params;
-  params.reserve(parameters_.size());
+KernelCall::KernelCall(const KernelCall& other)
+    : kernel_(other.kernel_),
+      grid_{other.grid_[0], other.grid_[1], other.grid_[2]},
+      parameters_(other.parameters_) {
+  BuildParamBlock();
+}
+
+KernelCall& KernelCall::operator=(const KernelCall& other) {
+  if (this != &other) {
+    kernel_ = other.kernel_;
+    std::copy(std::begin(other.grid_), std::end(other.grid_),
+              std::begin(grid_));
+    parameters_ = other.parameters_;
+    BuildParamBlock();
+  }
+  return *this;
+}
+
+void KernelCall::BuildParamBlock() {
+  param_slots_.clear();
+  param_slots_.reserve(parameters_.size());
+  array_slots_.clear();
   for (size_t i = 0; i < parameters_.size(); ++i) {
     const Parameter& param = parameters_[i];
-    if (std::holds_alternative<Parameter::Array>(param.value)) {
-      const auto& array = std::get<Parameter::Array>(param.value);
-      void*& ptr = *(buffers++);
-      auto cu_ptr = reinterpret_cast<gpuDevicePtr_t>(ptr);
-
-      if (ABSL_PREDICT_FALSE((array.ptr_divisibility != 0) &&
-                             ((size_t)cu_ptr % array.ptr_divisibility != 0))) {
-        return absl::InvalidArgumentError(
-            absl::StrFormat("Parameter %zu (%zu) is not divisible by %d.", i,
-                            (size_t)ptr, array.ptr_divisibility));
-      }
-
-      if (array.bytes_to_zero > 0) {
-        GPU_RETURN_IF_ERROR(
-            gpuMemsetD8Async(cu_ptr, 0, array.bytes_to_zero, stream));
-      }
-      params.push_back(&ptr);
+    if (const auto* array = std::get_if<Parameter::Array>(&param.value)) {
+      array_slots_.push_back(
+          {i, array->bytes_to_zero, array->ptr_divisibility});
+      param_slots_.push_back(nullptr);  // Patched with the buffer pointer.
     } else {
-      params.push_back(const_cast<void*>(std::visit(
+      param_slots_.push_back(const_cast<void*>(std::visit(
           [](auto&& arg) { return reinterpret_cast<const void*>(&arg); },
           param.value)));
     }
   }
+}
+
+absl::Status KernelCall::Launch(gpuStream_t stream, void** buffers) {
+  // Only the array-pointer slots change between launches; everything else
+  // was wired up by BuildParamBlock. The scratch block is thread-local
+  // rather than a member since a cached KernelCall may be launched
+  // concurrently, e.g. by per-device executor threads; assigning into it
+  // reuses its capacity, so the steady-state launch path never allocates.
+  static thread_local std::vector<void*> params;
+  params.assign(param_slots_.begin(), param_slots_.end());
+  for (size_t j = 0; j < array_slots_.size(); ++j) {
+    const ArraySlot& slot = array_slots_[j];
+    void* ptr = buffers[j];
+    auto cu_ptr = reinterpret_cast<gpuDevicePtr_t>(ptr);
+
+    if (ABSL_PREDICT_FALSE((slot.ptr_divisibility != 0) &&
+                           ((size_t)cu_ptr % slot.ptr_divisibility != 0))) {
+      return absl::InvalidArgumentError(
+          absl::StrFormat("Parameter %zu (%zu) is not divisible by %d.",
+                          slot.param_index, (size_t)ptr,
+                          slot.ptr_divisibility));
+    }
+
+    if (slot.bytes_to_zero > 0) {
+      GPU_RETURN_IF_ERROR(
+          gpuMemsetD8Async(cu_ptr, 0, slot.bytes_to_zero, stream));
+    }
+    params[slot.param_index] = &buffers[j];
+  }
 
   return kernel_.Launch(stream, grid_, params.data());
 }
@@ -550,6 +681,97 @@ jax_triton::TritonAutotunedKernelCall AutotunedKernelCall::ToProto() const {
   return proto;
 }
 
+namespace {
+
+// Pool of device scratch buffers used to snapshot aliased inputs around
+// autotuning. Sessions recur on every executable load and the aliased
+// buffers of large fused-update kernels reach hundreds of MB, so blocks are
+// reused across sessions instead of going through the allocator each time.
+// Blocks whose retention would push a device over the cap are freed on
+// release.
+class AutotuneScratchPool {
+ public:
+  struct Block {
+    void* ptr = nullptr;
+    size_t size = 0;
+  };
+
+  static AutotuneScratchPool& Instance() {
+    static auto& pool = *new AutotuneScratchPool;
+    return pool;
+  }
+
+  absl::StatusOr<Block> Acquire(gpuDevice_t device, size_t size) {
+    {
+      absl::MutexLock lock(&mutex_);
+      std::vector<Block>& blocks = free_blocks_[device];
+      // Pick the smallest sufficient block so large blocks stay available
+      // for large requests.
+      auto best = blocks.end();
+      for (auto it = blocks.begin(); it != blocks.end(); ++it) {
+        if (it->size >= size &&
+            (best == blocks.end() || it->size < best->size)) {
+          best = it;
+        }
+      }
+      if (best != blocks.end()) {
+        Block block = *best;
+        blocks.erase(best);
+        retained_bytes_[device] -= block.size;
+        return block;
+      }
+    }
+    Block block;
+    block.size = size;
+    if (gpuMalloc(&block.ptr, size) != gpuSuccess) {
+      // The device may simply be at capacity; drop the pooled blocks and
+      // retry once before giving up.
+      FreeBlocks(device);
+      GPU_RETURN_IF_ERROR(gpuMalloc(&block.ptr, size));
+    }
+    return block;
+  }
+
+  void Release(gpuDevice_t device, Block block) {
+    if (block.ptr == nullptr) {
+      return;
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      if (retained_bytes_[device] + block.size <= kMaxRetainedBytes) {
+        retained_bytes_[device] += block.size;
+        free_blocks_[device].push_back(block);
+        return;
+      }
+    }
+    gpuFree(block.ptr);
+  }
+
+ private:
+  static constexpr size_t kMaxRetainedBytes = size_t{256} << 20;
+
+  void FreeBlocks(gpuDevice_t device) {
+    std::vector<Block> blocks;
+    {
+      absl::MutexLock lock(&mutex_);
+      blocks = std::move(free_blocks_[device]);
+      free_blocks_[device].clear();
+      retained_bytes_[device] = 0;
+    }
+    for (const Block& block : blocks) {
+      gpuFree(block.ptr);
+    }
+  }
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<gpuDevice_t, std::vector<Block>> free_blocks_
+      ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<gpuDevice_t, size_t> retained_bytes_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
 /*static*/ absl::StatusOr<KernelCall> AutotunedKernelCall::Autotune(
     AutotunedKernelCall kernel_call, gpuStream_t stream, void** buffers) {
   // Ensure a valid context for driver calls that don't take the stream.
@@ -569,18 +791,29 @@ jax_triton::TritonAutotunedKernelCall AutotunedKernelCall::ToProto() const {
         "can have arbitrary data");
   }
 
+  JAX_ASSIGN_OR_RETURN(gpuDevice_t device, GetStreamDevice(stream));
+
   // If an input aliases with an output, it will get overwritten during the
   // kernel execution. If the kernel is called repeatedly, as we do during
   // auto-tuning, the final result will be junk, so we take a copy of the
-  // input to restore after auto-tuning.
-  std::unordered_map<size_t, std::vector<uint8_t>> input_copies;
+  // input to restore after auto-tuning. The single snapshot is shared by all
+  // configs in the session. It lives in pooled device scratch and the copies
+  // are issued on the benchmark stream: device-to-device bandwidth dwarfs
+  // the synchronous PCIe round trip a host-side snapshot would pay.
+  AutotuneScratchPool& scratch_pool = AutotuneScratchPool::Instance();
+  std::unordered_map<size_t, AutotuneScratchPool::Block> input_copies;
+  absl::Cleanup return_scratch = [&] {
+    for (const auto& [_, block] : input_copies) {
+      scratch_pool.Release(device, block);
+    }
+  };
   for (auto [input_idx, output_idx, size] : kernel_call.input_output_aliases_) {
     if (buffers[input_idx] == buffers[output_idx]) {
-      std::vector<uint8_t> input_copy(size);
-      GPU_RETURN_IF_ERROR(gpuMemcpyDtoHAsync(
-          input_copy.data(),
-          reinterpret_cast<gpuDevicePtr_t>(buffers[input_idx]), size, stream));
-      input_copies[input_idx] = std::move(input_copy);
+      JAX_ASSIGN_OR_RETURN(AutotuneScratchPool::Block block,
+                           scratch_pool.Acquire(device, size));
+      input_copies.insert_or_assign(input_idx, block);
+      GPU_RETURN_IF_ERROR(gpuMemcpyAsync(block.ptr, buffers[input_idx], size,
+                                         gpuMemcpyDeviceToDevice, stream));
     }
   }
 
@@ -588,8 +821,8 @@ jax_triton::TritonAutotunedKernelCall AutotunedKernelCall::ToProto() const {
   // First run a single iteration of each to config to determine how many
   // iterations to run for benchmarking.
   float best = std::numeric_limits<float>::infinity();
-  JAX_ASSIGN_OR_RETURN(gpuDevice_t device, GetStreamDevice(stream));
   absl::flat_hash_set<Config*> configs_to_skip;
+  absl::flat_hash_map<Config*, float> first_iter_times;
   for (Config& config : kernel_call.configs_) {
     if (!config.kernel_call.CanLaunchOnDevice(device)) {
       configs_to_skip.insert(&config);
@@ -598,9 +831,23 @@ jax_triton::TritonAutotunedKernelCall AutotunedKernelCall::ToProto() const {
     JAX_ASSIGN_OR_RETURN(float t,
                          Benchmark(stream, config.kernel_call, buffers, 1));
     LOG(INFO) << config.description << ", ran 1 iter in " << t << " ms";
+    first_iter_times[&config] = t;
     best = std::min(best, t);
   }
 
+  // Prune configs that are already far slower than the best config after a
+  // single iteration; running them for the full benchmark time would only
+  // lengthen the autotuning stall.
+  constexpr float kPruneRatio = 2.0f;
+  absl::flat_hash_set<Config*> pruned_configs;
+  for (auto& [config, t] : first_iter_times) {
+    if (t > kPruneRatio * best) {
+      LOG(INFO) << config->description << " pruned after 1 iter (" << t
+                << " ms > " << kPruneRatio << "x best " << best << " ms)";
+      pruned_configs.insert(config);
+    }
+  }
+
   int timed_iters = std::max(static_cast<int>(kBenchmarkTimeMillis / best), 1);
   if (timed_iters > 100) {
     timed_iters = 100;
@@ -618,6 +865,9 @@ jax_triton::TritonAutotunedKernelCall AutotunedKernelCall::ToProto() const {
                    << config.description;
       continue;
     }
+    if (pruned_configs.contains(&config)) {
+      continue;
+    }
 
     JAX_ASSIGN_OR_RETURN(
         float t, Benchmark(stream, config.kernel_call, buffers, timed_iters));
@@ -641,13 +891,16 @@ jax_triton::TritonAutotunedKernelCall AutotunedKernelCall::ToProto() const {
 
   // Restore aliased inputs to their original values.
   for (auto [input_idx, _, size] : kernel_call.input_output_aliases_) {
-    GPU_RETURN_IF_ERROR(
-        gpuMemcpyHtoDAsync(reinterpret_cast<gpuDevicePtr_t>(buffers[input_idx]),
-                           input_copies[input_idx].data(), size, stream));
+    auto it = input_copies.find(input_idx);
+    if (it == input_copies.end()) {
+      continue;
+    }
+    GPU_RETURN_IF_ERROR(gpuMemcpyAsync(buffers[input_idx], it->second.ptr,
+                                       size, gpuMemcpyDeviceToDevice, stream));
   }
 
-  // Synchronize stream to ensure copies are complete before the host copy
-  // is deleted.
+  // Synchronize so the scratch blocks cannot be handed to another session
+  // (which may run on a different stream) while the restores are in flight.
   GPU_RETURN_IF_ERROR(gpuStreamSynchronize(stream));
 
   return std::move(kernel_call.configs_[0].kernel_call);
@@ -655,11 +908,22 @@ jax_triton::TritonAutotunedKernelCall AutotunedKernelCall::ToProto() const {
 
 void TritonKernelCall(gpuStream_t stream, void** buffers, const char* opaque,
                       size_t opaque_len, XlaCustomCallStatus* status) {
+  // Always-on latency instrumentation: wall time from custom-call entry to
+  // launch return, exported per kernel name through jax_triton's extension
+  // module. A steady-clock read per call is well under 1% of launch cost.
+  auto start = std::chrono::steady_clock::now();
   absl::Status result = [=] {
     JAX_ASSIGN_OR_RETURN(
         KernelCall * kernel_call,
         GetKernelCall(absl::string_view(opaque, opaque_len), stream, buffers));
-    return kernel_call->Launch(stream, buffers);
+    absl::Status launch_status = kernel_call->Launch(stream, buffers);
+    if (launch_status.ok()) {
+      RecordLaunchLatency(kernel_call->kernel_name(),
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count());
+    }
+    return launch_status;
   }();
   if (!result.ok()) {
     absl::string_view msg = result.message();
@@ -10,6 +10,7 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "jaxlib/gpu/gpu_kernel_helpers.h"
 #include "jaxlib/gpu/triton.pb.h"
 #include "jaxlib/gpu/vendor.h"
@@ -20,6 +21,14 @@ namespace jax::JAX_GPU_NAMESPACE {
 void TritonKernelCall(gpuStream_t stream, void** buffers, const char* opaque,
                       size_t opaque_len, XlaCustomCallStatus* status);
 
+// Serializes the autotuning decisions made so far in this process as a
+// jax_triton.TritonAutotuneCache, so identical hosts can reuse them.
+absl::StatusOr<std::string> SerializeAutotuneResults();
+
+// Seeds the autotuning cache with decisions exported from another process.
+// Kernels whose descriptors match an imported entry skip autotuning.
+absl::Status LoadAutotuneResults(absl::string_view serialized);
+
 class ModuleImage;
 
 class Kernel {
@@ -37,6 +46,8 @@ class Kernel {
   // Returns true if we can launch the kernel without crashing.
   bool CanLaunchOnDevice(gpuDevice_t) const;
 
+  const std::string& kernel_name() const { return kernel_name_; }
+
  private:
   std::string kernel_name_;
   uint32_t block_dim_x_;
@@ -69,6 +80,14 @@ class KernelCall {
   KernelCall(Kernel kernel, uint32_t grid_0, uint32_t grid_1, uint32_t grid_2,
              std::vector<Parameter> parameters);
 
+  // The precomputed launch-parameter block points into the call's own
+  // parameter storage, so copies must rebuild it rather than alias the
+  // source. Moves keep the heap storage and need no fixup.
+  KernelCall(const KernelCall& other);
+  KernelCall& operator=(const KernelCall& other);
+  KernelCall(KernelCall&&) = default;
+  KernelCall& operator=(KernelCall&&) = default;
+
   absl::Status Launch(gpuStream_t stream, void** buffers);
 
   static absl::StatusOr<KernelCall> FromProto(
@@ -78,10 +97,28 @@ class KernelCall {
   // Returns true if we can launch the kernel without crashing.
   bool CanLaunchOnDevice(gpuDevice_t) const;
 
+  const std::string& kernel_name() const { return kernel_.kernel_name(); }
+
  private:
+  // Precomputes param_slots_ and array_slots_ from parameters_, so that
+  // Launch only has to patch the array-pointer slots.
+  void BuildParamBlock();
+
+  struct ArraySlot {
+    size_t param_index;  // Position within the full parameter list.
+    size_t bytes_to_zero;
+    size_t ptr_divisibility;
+  };
+
   Kernel kernel_;
   uint32_t grid_[3];
   std::vector<Parameter> parameters_;
+  // Template for the void* block handed to the kernel launch: scalar slots
+  // point at the values held in parameters_; array slots are patched with
+  // the buffer pointers on every launch.
+  std::vector<void*> param_slots_;
+  // One entry per array parameter, in buffer order.
+  std::vector<ArraySlot> array_slots_;
 };
 
 class AutotunedKernelCall {
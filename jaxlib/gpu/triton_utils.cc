@@ -2,8 +2,13 @@
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
 
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
+#include "snappy.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -12,44 +17,140 @@
 
 namespace jax::JAX_GPU_NAMESPACE {
 
+namespace {
+
+// Reusable zlib inflate state. Creating and destroying a z_stream allocates
+// and frees zlib's internal window for every call; reusing one per thread
+// turns that into a single inflateReset.
+class ZlibInflater {
+ public:
+  ZlibInflater() { ok_ = (inflateInit(&stream_) == Z_OK); }
+  ~ZlibInflater() {
+    if (ok_) inflateEnd(&stream_);
+  }
+
+  ZlibInflater(const ZlibInflater&) = delete;
+  ZlibInflater& operator=(const ZlibInflater&) = delete;
+
+  absl::StatusOr<std::string> Uncompress(absl::string_view compressed) {
+    if (!ok_ || (inflateReset(&stream_) != Z_OK)) {
+      return absl::InternalError("Failed to initialize zlib stream.");
+    }
+    std::string data;
+    data.resize(std::max<size_t>(5 * compressed.size(), 64));
+    stream_.next_in =
+        reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+    stream_.avail_in = compressed.size();
+    size_t total_out = 0;
+    while (true) {
+      stream_.next_out = reinterpret_cast<Bytef*>(data.data()) + total_out;
+      stream_.avail_out = data.size() - total_out;
+      int ret = inflate(&stream_, Z_NO_FLUSH);
+      total_out = data.size() - stream_.avail_out;
+      if (ret == Z_STREAM_END) {
+        data.resize(total_out);
+        return data;
+      }
+      if (((ret == Z_OK) || (ret == Z_BUF_ERROR)) && (stream_.avail_out == 0)) {
+        data.resize(2 * data.size());  // The output buffer wasn't large enough.
+        continue;
+      }
+      return absl::InvalidArgumentError("Failed to uncompress opaque data.");
+    }
+  }
+
+ private:
+  z_stream stream_ = {};
+  bool ok_;
+};
+
+// Extracts a single length-delimited field from a serialized
+// TritonAnyKernelCall without deserializing the whole message. The kernel
+// call payloads dwarf the name and metadata fields, so skipping over them is
+// much cheaper than a full parse. Returns an empty string if the field is
+// absent, matching proto3 semantics.
+absl::StatusOr<std::string> GetSerializedField(absl::string_view serialized,
+                                               int field_number) {
+  google::protobuf::io::CodedInputStream stream(
+      reinterpret_cast<const uint8_t*>(serialized.data()), serialized.size());
+  uint32_t tag;
+  while ((tag = stream.ReadTag()) != 0) {
+    if ((tag >> 3 == static_cast<uint32_t>(field_number)) &&
+        ((tag & 7) ==
+         google::protobuf::internal::WireFormatLite::WIRETYPE_LENGTH_DELIMITED)) {
+      uint32_t length;
+      std::string value;
+      if (!stream.ReadVarint32(&length) || !stream.ReadString(&value, length)) {
+        return absl::InvalidArgumentError("Failed to parse serialized data.");
+      }
+      return value;
+    }
+    if (!google::protobuf::internal::WireFormatLite::SkipField(&stream, tag)) {
+      return absl::InvalidArgumentError("Failed to parse serialized data.");
+    }
+  }
+  return std::string();
+}
+
+}  // namespace
+
 absl::StatusOr<std::string> ZlibUncompress(absl::string_view compressed) {
-  std::string data;
-  uLongf dest_len = 5 * compressed.size();
-  while (true) {
-    data.resize(dest_len);
-    int ret = uncompress(reinterpret_cast<Bytef*>(data.data()), &dest_len,
-                         reinterpret_cast<const Bytef*>(compressed.data()),
-                         compressed.size());
-    if (ret == Z_OK) {
-      // `uncompress` overwrites `dest_len` with the uncompressed size.
-      data.resize(dest_len);
-      break;
-    } else if (ret == Z_BUF_ERROR) {
-      dest_len *= 2;  // The string buffer wasn't large enough.
-    } else {
+  static thread_local ZlibInflater inflater;
+  return inflater.Uncompress(compressed);
+}
+
+absl::StatusOr<std::string> CompressTritonKernelCallProto(
+    absl::string_view serialized) {
+  std::string out;
+  out.resize(1 + snappy::MaxCompressedLength(serialized.size()));
+  out[0] = kTritonPayloadSnappyCodec;
+  size_t compressed_length;
+  snappy::RawCompress(serialized.data(), serialized.size(), &out[1],
+                      &compressed_length);
+  out.resize(1 + compressed_length);
+  return out;
+}
+
+absl::StatusOr<std::string> UncompressTritonKernelCallPayload(
+    absl::string_view compressed) {
+  if (compressed.empty()) {
+    return absl::InvalidArgumentError("Opaque data is empty.");
+  }
+  // A zlib stream's first byte carries the compression method 8 in its low
+  // nibble; codec tags are chosen to never collide with it.
+  if ((compressed[0] & 0x0f) == 0x08) {
+    return ZlibUncompress(compressed);
+  }
+  if (compressed[0] == kTritonPayloadSnappyCodec) {
+    absl::string_view body = compressed.substr(1);
+    size_t uncompressed_length;
+    if (!snappy::GetUncompressedLength(body.data(), body.size(),
+                                       &uncompressed_length)) {
+      return absl::InvalidArgumentError("Failed to uncompress opaque data.");
+    }
+    std::string data;
+    data.resize(uncompressed_length);
+    if (!snappy::RawUncompress(body.data(), body.size(), data.data())) {
       return absl::InvalidArgumentError("Failed to uncompress opaque data.");
     }
+    return data;
   }
-  return data;
+  return absl::InvalidArgumentError("Unknown opaque data codec.");
 }
 
 absl::StatusOr<std::string> GetTritonKernelCallName(absl::string_view opaque) {
-  JAX_ASSIGN_OR_RETURN(std::string serialized, ZlibUncompress(opaque));
-  jax_triton::TritonAnyKernelCall proto;
-  if (!proto.ParseFromString(serialized)) {
-    return absl::InvalidArgumentError("Failed to parse serialized data.");
-  }
-  return proto.name();
+  JAX_ASSIGN_OR_RETURN(std::string serialized,
+                       UncompressTritonKernelCallPayload(opaque));
+  return GetSerializedField(serialized,
+                            jax_triton::TritonAnyKernelCall::kNameFieldNumber);
 }
 
 absl::StatusOr<std::string> GetTritonKernelCallSerializedMetadata(
     absl::string_view opaque) {
-  JAX_ASSIGN_OR_RETURN(std::string serialized, ZlibUncompress(opaque));
-  jax_triton::TritonAnyKernelCall proto;
-  if (!proto.ParseFromString(serialized)) {
-    return absl::InvalidArgumentError("Failed to parse serialized data.");
-  }
-  return proto.metadata();
+  JAX_ASSIGN_OR_RETURN(std::string serialized,
+                       UncompressTritonKernelCallPayload(opaque));
+  return GetSerializedField(
+      serialized, jax_triton::TritonAnyKernelCall::kMetadataFieldNumber);
 }
 
 }  // namespace jax::JAX_GPU_NAMESPACE
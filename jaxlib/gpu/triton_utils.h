@@ -10,7 +10,24 @@
 
 namespace jax::JAX_GPU_NAMESPACE {
 
+// Kernel-call payloads are compressed serialized TritonAnyKernelCall protos.
+// Historically the payload was a bare zlib stream; newer producers frame it
+// with a leading codec byte. Codec tags must never have 8 in their low
+// nibble, which is how a zlib stream's first byte is recognized.
+inline constexpr char kTritonPayloadSnappyCodec = 0x01;
+
 absl::StatusOr<std::string> ZlibUncompress(absl::string_view compressed);
+
+// Compresses a serialized TritonAnyKernelCall with the preferred codec,
+// framed so that UncompressTritonKernelCallPayload can identify it.
+absl::StatusOr<std::string> CompressTritonKernelCallProto(
+    absl::string_view serialized);
+
+// Uncompresses a payload produced either by CompressTritonKernelCallProto or
+// by a legacy producer emitting a bare zlib stream.
+absl::StatusOr<std::string> UncompressTritonKernelCallPayload(
+    absl::string_view compressed);
+
 absl::StatusOr<std::string> GetTritonKernelCallName(absl::string_view opaque);
 absl::StatusOr<std::string> GetTritonKernelCallSerializedMetadata(
     absl::string_view opaque);
@@ -63,6 +63,8 @@ typedef cudaStream_t gpuStream_t;
 typedef cudaError_t gpuError_t;
 typedef CUevent gpuEvent_t;
 typedef CUfunction gpuFunction_t;
+typedef cudaGraph_t gpuGraph_t;
+typedef cudaGraphExec_t gpuGraphExec_t;
 typedef cudnnHandle_t gpudnnHandle_t;
 typedef cudnnStatus_t gpudnnStatus_t;
 typedef CUmodule gpuModule_t;
@@ -78,6 +80,7 @@ typedef cusparseStatus_t gpusparseStatus_t;
 typedef cusparseSpMatDescr_t gpusparseSpMatDescr_t;
 typedef cusparseDnMatDescr_t gpusparseDnMatDescr_t;
 typedef cusparseDnVecDescr_t gpusparseDnVecDescr_t;
+typedef cusparseSpMMAlg_t gpusparseSpMMAlg_t;
 
 #define GPU_C_16F CUDA_C_16F
 #define GPU_R_16F CUDA_R_16F
@@ -87,6 +90,7 @@ typedef cusparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define GPU_R_64F CUDA_R_64F
 
 #define gpublasCreate cublasCreate
+#define gpublasDestroy cublasDestroy
 #define gpublasSetStream cublasSetStream
 #define gpublasSgeqrfBatched cublasSgeqrfBatched
 #define gpublasDgeqrfBatched cublasDgeqrfBatched
@@ -100,11 +104,13 @@ typedef cusparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define GPUBLAS_STATUS_SUCCESS CUBLAS_STATUS_SUCCESS
 
 #define gpudnnCreate cudnnCreate
+#define gpudnnDestroy cudnnDestroy
 #define gpudnnSetStream cudnnSetStream
 
 #define GPUDNN_STATUS_SUCCESS CUDNN_STATUS_SUCCESS
 
 #define gpusolverDnCreate cusolverDnCreate
+#define gpusolverDnDestroy cusolverDnDestroy
 #define gpusolverDnSetStream cusolverDnSetStream
 #define gpusolverDnCreateSyevjInfo cusolverDnCreateSyevjInfo
 #define gpusolverDnDestroySyevjInfo cusolverDnDestroySyevjInfo
@@ -187,7 +193,9 @@ typedef cusparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define GPUSOLVER_STATUS_SUCCESS CUSOLVER_STATUS_SUCCESS
 
 #define gpusparseCooSetStridedBatch cusparseCooSetStridedBatch
+#define gpusparseCsrSetStridedBatch cusparseCsrSetStridedBatch
 #define gpusparseCreate cusparseCreate
+#define gpusparseDestroy cusparseDestroy
 #define gpusparseCreateCoo cusparseCreateCoo
 #define gpusparseCreateCsr cusparseCreateCsr
 #define gpusparseCreateDnMat cusparseCreateDnMat
@@ -204,12 +212,19 @@ typedef cusparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define gpusparseSparseToDense_bufferSize cusparseSparseToDense_bufferSize
 #define gpusparseSpMM cusparseSpMM
 #define gpusparseSpMM_bufferSize cusparseSpMM_bufferSize
+#define gpusparseSpMM_preprocess cusparseSpMM_preprocess
 #define gpusparseSpMV cusparseSpMV
 #define gpusparseSpMV_bufferSize cusparseSpMV_bufferSize
 #define gpusparseSgtsv2 cusparseSgtsv2
 #define gpusparseDgtsv2 cusparseDgtsv2
 #define gpusparseSgtsv2_bufferSizeExt cusparseSgtsv2_bufferSizeExt
 #define gpusparseDgtsv2_bufferSizeExt cusparseDgtsv2_bufferSizeExt
+#define gpusparseSgtsv2StridedBatch cusparseSgtsv2StridedBatch
+#define gpusparseDgtsv2StridedBatch cusparseDgtsv2StridedBatch
+#define gpusparseSgtsv2StridedBatch_bufferSizeExt \
+  cusparseSgtsv2StridedBatch_bufferSizeExt
+#define gpusparseDgtsv2StridedBatch_bufferSizeExt \
+  cusparseDgtsv2StridedBatch_bufferSizeExt
 
 #define GPUSPARSE_INDEX_16U CUSPARSE_INDEX_16U
 #define GPUSPARSE_INDEX_32I CUSPARSE_INDEX_32I
@@ -282,15 +297,25 @@ typedef cusparseDnVecDescr_t gpusparseDnVecDescr_t;
 
 #define gpuGetLastError cudaGetLastError
 #define gpuGetErrorString cudaGetErrorString
+#define gpuGraphDestroy cudaGraphDestroy
+#define gpuGraphExecDestroy cudaGraphExecDestroy
+#define gpuGraphInstantiateWithFlags cudaGraphInstantiateWithFlags
+#define gpuGraphLaunch cudaGraphLaunch
+#define gpuMalloc cudaMalloc
+#define gpuFree cudaFree
 #define gpuMemcpy cudaMemcpy
 #define gpuMemcpyAsync cudaMemcpyAsync
 #define gpuMemcpyDeviceToDevice cudaMemcpyDeviceToDevice
 #define gpuMemcpyHostToDevice cudaMemcpyHostToDevice
 #define gpuMemcpyDeviceToHost cudaMemcpyDeviceToHost
+#define gpuStreamBeginCapture cudaStreamBeginCapture
+#define gpuStreamEndCapture cudaStreamEndCapture
 #define gpuStreamSynchronize cudaStreamSynchronize
 #define gpuStreamWaitEvent cudaStreamWaitEvent
 #define gpuSuccess cudaSuccess
 
+#define GPU_STREAM_CAPTURE_MODE_THREAD_LOCAL cudaStreamCaptureModeThreadLocal
+
 namespace jax::JAX_GPU_NAMESPACE {
 namespace {
 constexpr uint32_t kNumThreadsPerWarp = 32;
@@ -330,6 +355,8 @@ typedef hipStream_t gpuStream_t;
 typedef hipError_t gpuError_t;
 typedef hipEvent_t gpuEvent_t;
 typedef hipFunction_t gpuFunction_t;
+typedef hipGraph_t gpuGraph_t;
+typedef hipGraphExec_t gpuGraphExec_t;
 typedef hipModule_t gpuModule_t;
 typedef void gpuSyevjInfo;
 typedef hipsolverSyevjInfo_t gpuSyevjInfo_t;
@@ -342,6 +369,7 @@ typedef hipsparseStatus_t gpusparseStatus_t;
 typedef hipsparseSpMatDescr_t gpusparseSpMatDescr_t;
 typedef hipsparseDnMatDescr_t gpusparseDnMatDescr_t;
 typedef hipsparseDnVecDescr_t gpusparseDnVecDescr_t;
+typedef hipsparseSpMMAlg_t gpusparseSpMMAlg_t;
 
 #define GPU_C_16F HIP_C_16F
 #define GPU_R_16F HIP_R_16F
@@ -351,6 +379,7 @@ typedef hipsparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define GPU_R_64F HIP_R_64F
 
 #define gpublasCreate hipblasCreate
+#define gpublasDestroy hipblasDestroy
 #define gpublasSetStream hipblasSetStream
 #define gpublasSgeqrfBatched hipblasSgeqrfBatched
 #define gpublasDgeqrfBatched hipblasDgeqrfBatched
@@ -364,6 +393,7 @@ typedef hipsparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define GPUBLAS_STATUS_SUCCESS HIPBLAS_STATUS_SUCCESS
 
 #define gpusolverDnCreate hipsolverCreate
+#define gpusolverDnDestroy hipsolverDestroy
 #define gpusolverDnSetStream hipsolverSetStream
 #define gpusolverDnCreateSyevjInfo hipsolverCreateSyevjInfo
 #define gpusolverDnDestroySyevjInfo hipsolverDestroySyevjInfo
@@ -446,7 +476,9 @@ typedef hipsparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define GPUSOLVER_STATUS_SUCCESS HIPSOLVER_STATUS_SUCCESS
 
 #define gpusparseCooSetStridedBatch hipsparseCooSetStridedBatch
+#define gpusparseCsrSetStridedBatch hipsparseCsrSetStridedBatch
 #define gpusparseCreate hipsparseCreate
+#define gpusparseDestroy hipsparseDestroy
 #define gpusparseSetStream hipsparseSetStream
 #define gpusparseCreateCoo hipsparseCreateCoo
 #define gpusparseCreateCsr hipsparseCreateCsr
@@ -463,12 +495,19 @@ typedef hipsparseDnVecDescr_t gpusparseDnVecDescr_t;
 #define gpusparseSparseToDense_bufferSize hipsparseSparseToDense_bufferSize
 #define gpusparseSpMM hipsparseSpMM
 #define gpusparseSpMM_bufferSize hipsparseSpMM_bufferSize
+#define gpusparseSpMM_preprocess hipsparseSpMM_preprocess
 #define gpusparseSpMV hipsparseSpMV
 #define gpusparseSpMV_bufferSize hipsparseSpMV_bufferSize
 #define gpusparseSgtsv2 hipsparseSgtsv2
 #define gpusparseDgtsv2 hipsparseDgtsv2
 #define gpusparseSgtsv2_bufferSizeExt hipsparseSgtsv2_bufferSizeExt
 #define gpusparseDgtsv2_bufferSizeExt hipsparseDgtsv2_bufferSizeExt
+#define gpusparseSgtsv2StridedBatch hipsparseSgtsv2StridedBatch
+#define gpusparseDgtsv2StridedBatch hipsparseDgtsv2StridedBatch
+#define gpusparseSgtsv2StridedBatch_bufferSizeExt \
+  hipsparseSgtsv2StridedBatch_bufferSizeExt
+#define gpusparseDgtsv2StridedBatch_bufferSizeExt \
+  hipsparseDgtsv2StridedBatch_bufferSizeExt
 
 #define GPUSPARSE_INDEX_16U HIPSPARSE_INDEX_16U
 #define GPUSPARSE_INDEX_32I HIPSPARSE_INDEX_32I
@@ -491,14 +530,24 @@ typedef hipsparseDnVecDescr_t gpusparseDnVecDescr_t;
 
 #define gpuGetLastError hipGetLastError
 #define gpuGetErrorString hipGetErrorString
+#define gpuGraphDestroy hipGraphDestroy
+#define gpuGraphExecDestroy hipGraphExecDestroy
+#define gpuGraphInstantiateWithFlags hipGraphInstantiateWithFlags
+#define gpuGraphLaunch hipGraphLaunch
+#define gpuMalloc hipMalloc
+#define gpuFree hipFree
 #define gpuMemcpyAsync hipMemcpyAsync
 #define gpuMemcpyDeviceToDevice hipMemcpyDeviceToDevice
 #define gpuMemcpyHostToDevice hipMemcpyHostToDevice
 #define gpuMemcpyDeviceToHost hipMemcpyDeviceToHost
+#define gpuStreamBeginCapture hipStreamBeginCapture
+#define gpuStreamEndCapture hipStreamEndCapture
 #define gpuStreamSynchronize hipStreamSynchronize
 #define gpuStreamWaitEvent hipStreamWaitEvent
 #define gpuSuccess hipSuccess
 
+#define GPU_STREAM_CAPTURE_MODE_THREAD_LOCAL hipStreamCaptureModeThreadLocal
+
 #define gpuCtxGetDevice hipCtxGetDevice
 #define gpuCtxGetCurrent hipCtxGetCurrent
 #define gpuCtxPopCurrent hipCtxPopCurrent
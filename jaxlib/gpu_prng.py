@@ -107,3 +107,64 @@ def _threefry2x32_lowering(prng, platform, keys, data,
 
 cuda_threefry2x32 = partial(_threefry2x32_lowering, _cuda_prng, "cu")
 rocm_threefry2x32 = partial(_threefry2x32_lowering, _hip_prng, "hip")
+
+
+def _philox4x32_lowering(prng, platform, keys, data,
+                         length: int | ir.Value | None = None,
+                         output_shape: ir.Value | None = None):
+  """Philox4x32-10 kernel for GPU.
+
+  Takes a 2x32-bit key and a 4x32-bit counter per element and produces four
+  32-bit outputs per element. In presence of dynamic shapes, `length` is an
+  `ir.Value` and `output_shape` is a 1D tensor describing the shape of the
+  four outputs.
+  """
+  if not prng:
+    raise GpuLibNotLinkedError()
+  assert len(keys) == 2, keys
+  assert len(data) == 4, data
+  assert (ir.RankedTensorType(keys[0].type).element_type ==
+          ir.IntegerType.get_unsigned(32)), keys[0].type
+
+  typ = keys[0].type
+  dims = ir.RankedTensorType(typ).shape
+
+  for x in itertools.chain(keys, data):
+    assert x.type == typ, (x.type, typ)
+  ndims = len(dims)
+  layout = tuple(range(ndims - 1, -1, -1))
+  operand_layouts = [layout] * 6
+  operands = [keys[0], keys[1], data[0], data[1], data[2], data[3]]
+
+  if length is None:
+    length = _prod(dims)
+
+  if isinstance(length, int):
+    opaque = prng.philox4x32_descriptor(length)
+    result_shapes = None
+  else:
+    assert output_shape is not None
+    opaque = prng.philox4x32_descriptor(-1)
+    assert (ir.RankedTensorType(length.type).element_type ==
+            ir.IntegerType.get_signless(64)), length
+    assert (ir.RankedTensorType(length.type).shape ==
+            [1]), (length, ir.RankedTensorType(length.type).shape)
+    # Pass the length, which will be used by the custom call target since the
+    # static length in the descriptor is -1.
+    operands.append(length)
+    operand_layouts.append((0,))
+    # We also need to pass separately the shapes of the outputs.
+    result_shapes = [output_shape] * 4
+
+  return custom_call(
+      f"{platform}_philox4x32",
+      result_types=[typ] * 4,
+      operands=operands,
+      backend_config=opaque,
+      operand_layouts=operand_layouts,
+      result_layouts=[layout] * 4,
+      result_shapes=result_shapes).results
+
+
+cuda_philox4x32 = partial(_philox4x32_lowering, _cuda_prng, "cu")
+rocm_philox4x32 = partial(_philox4x32_lowering, _hip_prng, "hip")
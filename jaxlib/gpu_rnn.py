@@ -36,11 +36,35 @@ if _rnn:
   compute_rnn_workspace_reserve_space_sizes = _rnn.compute_rnn_workspace_reserve_space_sizes
 
 
+def _splat_constant_seq_length(seq_lengths) -> int:
+  """Returns the length if seq_lengths is a splat constant, or -1.
+
+  When every sequence length is the same compile-time constant, the value can
+  be recorded in the kernel descriptor and the kernel skips a blocking
+  device-to-host copy of the seq_lengths buffer.
+  """
+  try:
+    op = seq_lengths.owner
+    if op is None or op.operation.name != 'stablehlo.constant':
+      return -1
+    attr = ir.DenseIntElementsAttr(op.operation.attributes['value'])
+    if not attr.is_splat:
+      return -1
+    return ir.IntegerAttr(attr.get_splat_value()).value
+  except (AttributeError, ValueError):
+    return -1
+
+
 def cudnn_rnn_lowering(ctx, input, h_0, c_0, weights, seq_lengths, *,
                        input_size: int, hidden_size: int, num_layers: int,
                        dropout: bool, bidirectional: bool,
-                       cudnn_allow_tf32: bool):
-  """CuDnn RNN."""
+                       cudnn_allow_tf32: bool, algo: int = 0):
+  """CuDnn RNN.
+
+  algo selects the cuDNN RNN algorithm: 0 standard, 1 persist-static,
+  2 persist-dynamic. -1 benchmarks all three on the first call for a shape
+  and caches the winner.
+  """
   out_dtype = ctx.avals_out[0].dtype
   if out_dtype == np.float32:
     out_type = ir.F32Type.get()
@@ -72,7 +96,9 @@ def cudnn_rnn_lowering(ctx, input, h_0, c_0, weights, seq_lengths, *,
                                      batch_size, max_seq_length, dropout,
                                      bidirectional, cudnn_allow_tf32,
                                      workspace_shape[0],
-                                     reserve_space_shape[0])
+                                     reserve_space_shape[0],
+                                     _splat_constant_seq_length(seq_lengths),
+                                     algo)
 
   i32_type = ir.IntegerType.get_signless(32)
 
@@ -97,7 +123,8 @@ def _hlo_zeros_f32(shape):
 def cudnn_rnn_bwd_lowering(ctx, dy, dhn, dcn, x, h0, c0, w, y,
                            reserve_space, seq_lengths, *, input_size: int,
                            hidden_size: int, num_layers: int, dropout: bool,
-                           bidirectional: bool, cudnn_allow_tf32: bool):
+                           bidirectional: bool, cudnn_allow_tf32: bool,
+                           algo: int = 0):
   """CuDnn RNN Backward pass."""
   batch_size = ctx.avals_in[3].shape[0]
   max_seq_length = ctx.avals_in[3].shape[1]
@@ -114,7 +141,9 @@ def cudnn_rnn_bwd_lowering(ctx, dy, dhn, dcn, x, h0, c0, w, y,
                                      batch_size, max_seq_length, dropout,
                                      bidirectional, cudnn_allow_tf32,
                                      workspace_shape[0],
-                                     reserve_space_shape[0])
+                                     reserve_space_shape[0],
+                                     _splat_constant_seq_length(seq_lengths),
+                                     algo)
 
   i32_type = ir.IntegerType.get_signless(32)
   zeroed_dw = _hlo_zeros_f32(ctx.avals_out[3].shape)
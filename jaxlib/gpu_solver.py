@@ -249,13 +249,22 @@ def _orgqr_hlo(platform, gpu_solver, dtype, a, tau):
   assert tau_dims[:-1] == dims[:-2]
   k = tau_dims[-1]
 
-  lwork, opaque = gpu_solver.build_orgqr_descriptor(
-      np.dtype(dtype), batch, m, n, k)
+  if batch > 1 and m <= 128 and n <= 128:
+    # The solver libraries have no batched orgqr, but for batches of small
+    # matrices the multi-stream kernel keeps the GPU much busier than the
+    # matrix-at-a-time loop.
+    lwork, opaque = gpu_solver.build_orgqr_batched_descriptor(
+        np.dtype(dtype), batch, m, n, k)
+    kernel = f"{platform}solver_orgqr_batched"
+  else:
+    lwork, opaque = gpu_solver.build_orgqr_descriptor(
+        np.dtype(dtype), batch, m, n, k)
+    kernel = f"{platform}solver_orgqr"
 
   layout = (num_bd, num_bd + 1) + tuple(range(num_bd - 1, -1, -1))
   i32_type = ir.IntegerType.get_signless(32)
   out = custom_call(
-      f"{platform}solver_orgqr",
+      kernel,
       result_types=[
         a.type,
         ir.RankedTensorType.get(batch_dims, i32_type),
@@ -135,8 +135,20 @@ def _csr_matvec_hlo(platform, gpu_sparse, data, indices, indptr, x, *, shape,
                     transpose=False, compute_dtype=None, compute_type=None,
                     data_dtype, index_dtype, x_dtype):
   """CSR matrix/vector multiply."""
-  data_type, index_type, nnz = _validate_csr_hlo(data, indices, indptr, shape)
-  rows, cols = shape
+  batch_count = 1
+  if len(shape) == 3:
+    # Batched mode, y_i = A_i x_i over a stack of same-nnz matrices: data,
+    # indices and indptr are the flattened stacks (nnz below is per batch
+    # element, with one (rows + 1)-sized indptr segment per element) and x is
+    # (batch_count, size). The whole batch runs as a single strided-batch
+    # kernel launch instead of one custom call per element.
+    batch_count, rows, cols = shape
+    data_type = ir.RankedTensorType(data.type).element_type
+    total_nnz, = ir.RankedTensorType(data.type).shape
+    nnz = total_nnz // batch_count
+  else:
+    rows, cols = shape
+    data_type, _, nnz = _validate_csr_hlo(data, indices, indptr, shape)
 
   if compute_dtype is None:
     compute_dtype = data_dtype
@@ -144,20 +156,27 @@ def _csr_matvec_hlo(platform, gpu_sparse, data, indices, indptr, x, *, shape,
 
   buffer_size, opaque = gpu_sparse.build_csr_matvec_descriptor(
       data_dtype, x_dtype, compute_dtype, index_dtype,
-      rows, cols, nnz, transpose)
+      rows, cols, nnz, transpose, batch_count)
   out_size = cols if transpose else rows
 
+  if batch_count > 1:
+    out_shape = [batch_count, out_size]
+    out_layout = x_layout = [1, 0]
+  else:
+    out_shape = [out_size]
+    out_layout = x_layout = [0]
+
   out = custom_call(
       f"{platform}sparse_csr_matvec",
       result_types=[
-          ir.RankedTensorType.get([out_size], compute_type),
+          ir.RankedTensorType.get(out_shape, compute_type),
           ir.RankedTensorType.get([buffer_size],
                                   ir.IntegerType.get_signless(8)),
       ],
       operands=[data, indices, indptr, x],
       backend_config=opaque,
-      operand_layouts=[[0]] * 4,
-      result_layouts=[[0]] * 2).results
+      operand_layouts=[[0], [0], [0], x_layout],
+      result_layouts=[out_layout, [0]]).results
   return out[0]
 
 cuda_csr_matvec = partial(_csr_matvec_hlo, "cu", _cusparse)
@@ -166,8 +185,15 @@ rocm_csr_matvec = partial(_csr_matvec_hlo, "hip", _hipsparse)
 
 def _csr_matmat_hlo(platform, gpu_sparse, data, indices, indptr, B, *, shape,
                     transpose=False, compute_dtype=None, compute_type=None,
-                    index_dtype, data_dtype, B_dtype):
-  """CSR from dense matrix."""
+                    index_dtype, data_dtype, B_dtype, accum_dtype=None,
+                    alg=None):
+  """CSR from dense matrix.
+
+  accum_dtype optionally selects the SpMM accumulator type independently of
+  the storage dtypes (e.g. np.float32 over fp16/bf16 operands to engage the
+  tensor-core kernels); alg is the raw vendor SpMM algorithm enum value. Both
+  default to the platform's existing behavior.
+  """
   data_type, index_type, nnz = _validate_csr_hlo(data, indices, indptr, shape)
   rows, cols = shape
   B_shape = ir.RankedTensorType(B.type).shape
@@ -179,7 +205,7 @@ def _csr_matmat_hlo(platform, gpu_sparse, data, indices, indptr, B, *, shape,
 
   buffer_size, opaque = gpu_sparse.build_csr_matmat_descriptor(
       data_dtype, B_dtype, compute_dtype, index_dtype,
-      rows, cols, Ccols, nnz, transpose)
+      rows, cols, Ccols, nnz, transpose, accum_dtype, alg)
   out_size = cols if transpose else rows
 
   out = custom_call(
@@ -258,7 +284,14 @@ def _coo_matvec_hlo(platform, gpu_sparse, data, row, col, x, *, shape,
                     index_dtype, data_dtype, x_dtype):
   """COO matrix/vector multiply."""
   data_type, _, nnz = _validate_coo_hlo(data, row, col)
-  rows, cols = shape
+  batch_count = 1
+  if len(shape) == 3:
+    # Batched mode, y_i = A_i x_i; see _csr_matvec_hlo. data, row and col are
+    # the flattened stacks and nnz is per batch element.
+    batch_count, rows, cols = shape
+    nnz = nnz // batch_count
+  else:
+    rows, cols = shape
 
   if compute_dtype is None:
     compute_dtype = data_dtype
@@ -266,20 +299,27 @@ def _coo_matvec_hlo(platform, gpu_sparse, data, row, col, x, *, shape,
 
   buffer_size, opaque = gpu_sparse.build_coo_matvec_descriptor(
       data_dtype, x_dtype, compute_dtype, index_dtype,
-      rows, cols, nnz, transpose)
+      rows, cols, nnz, transpose, batch_count)
   out_size = cols if transpose else rows
 
+  if batch_count > 1:
+    out_shape = [batch_count, out_size]
+    out_layout = x_layout = [1, 0]
+  else:
+    out_shape = [out_size]
+    out_layout = x_layout = [0]
+
   out = custom_call(
       f"{platform}sparse_coo_matvec",
       result_types=[
-          ir.RankedTensorType.get([out_size], compute_type),
+          ir.RankedTensorType.get(out_shape, compute_type),
           ir.RankedTensorType.get([buffer_size],
                                   ir.IntegerType.get_signless(8)),
       ],
       operands=[data, row, col, x],
       backend_config=opaque,
-      operand_layouts=[[0]] * 4,
-      result_layouts=[[0]] * 2).results
+      operand_layouts=[[0], [0], [0], x_layout],
+      result_layouts=[out_layout, [0]]).results
   return out[0]
 
 cuda_coo_matvec = partial(_coo_matvec_hlo, "cu", _cusparse)
@@ -354,10 +394,21 @@ def _gtsv2_hlo(
   batch_size = math.prod(batch_dim_vals)
   num_bd = len(b_shape_vals) - 2
   f32 = (t == np.float32)
+  # With a single right-hand side and batch > 1 the kernel solves the whole
+  # batch with one gtsv2StridedBatch launch, which needs its own workspace
+  # size; otherwise it loops over per-system gtsv2 calls sharing one
+  # workspace.
+  batched = n == 1 and batch_size > 1
   if f32:
-    buffer_size = gpu_sparse.gtsv2_f32_buffer_size(m, n, ldb)
+    if batched:
+      buffer_size = gpu_sparse.gtsv2_batched_f32_buffer_size(m, batch_size)
+    else:
+      buffer_size = gpu_sparse.gtsv2_f32_buffer_size(m, n, ldb)
   else:
-    buffer_size = gpu_sparse.gtsv2_f64_buffer_size(m, n, ldb)
+    if batched:
+      buffer_size = gpu_sparse.gtsv2_batched_f64_buffer_size(m, batch_size)
+    else:
+      buffer_size = gpu_sparse.gtsv2_f64_buffer_size(m, n, ldb)
 
   b_layout = (num_bd, num_bd + 1) + tuple(range(num_bd - 1, -1, -1))
   d_layout = (num_bd,) + tuple(range(num_bd - 1, -1, -1))
@@ -37,6 +37,9 @@ if _cuda_triton:
   get_compute_capability = _cuda_triton.get_compute_capability
   get_custom_call = _cuda_triton.get_custom_call
   get_serialized_metadata = _cuda_triton.get_serialized_metadata
+  get_autotune_results = _cuda_triton.get_autotune_results
+  load_autotune_results = _cuda_triton.load_autotune_results
+  compress_kernel_call_proto = _cuda_triton.compress_kernel_call_proto
 
 try:
   from .rocm import _triton as _hip_triton # pytype: disable=import-error
@@ -51,5 +54,8 @@ try:
   get_compute_capability = _hip_triton.get_compute_capability
   get_custom_call = _hip_triton.get_custom_call
   get_serialized_metadata = _hip_triton.get_serialized_metadata
+  get_autotune_results = _hip_triton.get_autotune_results
+  load_autotune_results = _hip_triton.load_autotune_results
+  compress_kernel_call_proto = _hip_triton.compress_kernel_call_proto
 except ImportError:
   _hip_triton = None
@@ -16,15 +16,32 @@ limitations under the License.
 #ifndef JAXLIB_HANDLE_POOL_H_
 #define JAXLIB_HANDLE_POOL_H_
 
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
 
 namespace jax {
 
+// Counters describing the current state of one HandlePool; see
+// HandlePool::GetStats. Streams are reported as opaque integers since the
+// stats cross into Python.
+struct HandlePoolStats {
+  int64_t created = 0;    // Handles ever created.
+  int64_t destroyed = 0;  // Handles destroyed by capacity eviction.
+  int64_t borrowed = 0;   // Handles currently lent out.
+  int64_t idle = 0;       // Handles sitting in the pool.
+  std::vector<std::pair<std::uintptr_t, int64_t>> idle_per_stream;
+};
+
 // To avoid creating cublas/cusolver contexts in the middle of execution, we
 // maintain a pool of them.
 template <typename HandleType, typename StreamType>
@@ -69,7 +86,9 @@ class HandlePool {
     friend class HandlePool<HandleType, StreamType>;
     Handle(HandlePool<HandleType, StreamType>* pool, HandleType handle,
            StreamType stream)
-        : pool_(pool), handle_(handle), stream_(stream) {}
+        : pool_(pool), handle_(handle), stream_(stream) {
+      pool_->borrowed_.fetch_add(1, std::memory_order_relaxed);
+    }
     HandlePool<HandleType, StreamType>* pool_ = nullptr;
     HandleType handle_ = nullptr;
     StreamType stream_ = nullptr;
@@ -79,13 +98,65 @@ class HandlePool {
   // associated with the handle.
   static absl::StatusOr<Handle> Borrow(StreamType stream);
 
+  // Ensures at least 'count' handles exist for 'stream', creating any that
+  // are missing and leaving them idle in the pool. Handle creation is
+  // expensive (tens of milliseconds), so callers can invoke this at load time
+  // instead of paying the cost on the first Borrow.
+  static absl::Status Prewarm(StreamType stream, int count);
+
+  // Snapshot of the pool's occupancy counters.
+  static HandlePoolStats GetStats();
+
+  // Caps the number of idle handles the pool may keep across all streams;
+  // the least-recently-used idle handles are destroyed when the cap is
+  // exceeded. Each idle cublas/cusolver handle pins device memory, so jobs
+  // that churn through many streams can use this to bound what the pool
+  // holds onto. -1 (the default) leaves the pool unbounded.
+  static void SetCapacity(int64_t max_idle);
+  static int64_t GetCapacity();
+
  private:
+  // Idle handles for a single stream. Each stream has its own mutex so that
+  // concurrent Borrow/Return calls on distinct streams do not contend on a
+  // pool-wide lock.
+  struct StreamCache {
+    absl::Mutex mu;
+    std::vector<HandleType> handles ABSL_GUARDED_BY(mu);
+    // Tick of the last Borrow/Return touching this stream; used to pick the
+    // least-recently-used cache when evicting over-capacity idle handles.
+    int64_t last_use ABSL_GUARDED_BY(mu) = 0;
+  };
+
+  // Destroys a handle evicted by SetCapacity. Specialized next to each
+  // pool's Borrow, since only the kernels know the vendor destroy call.
+  static void DestroyHandle(HandleType handle);
+
   static HandlePool<HandleType, StreamType>* Instance();
 
+  // Returns the cache for `stream`, creating it if necessary. The pool-wide
+  // mutex is taken in write mode only the first time a stream is seen; all
+  // subsequent lookups take it in read mode, which does not serialize readers.
+  StreamCache* GetCache(StreamType stream);
+
+  // Removes an idle handle for `stream` from the pool, if one exists.
+  bool TryAcquire(StreamType stream, HandleType* handle);
+
   void Return(HandleType handle, StreamType stream);
 
+  // Destroys least-recently-used idle handles until the pool is within
+  // capacity again.
+  void EnforceCapacity();
+
   absl::Mutex mu_;
-  std::map<StreamType, std::vector<HandleType>> handles_ ABSL_GUARDED_BY(mu_);
+  std::map<StreamType, std::unique_ptr<StreamCache>> caches_
+      ABSL_GUARDED_BY(mu_);
+
+  std::atomic<int64_t> created_{0};
+  std::atomic<int64_t> destroyed_{0};
+  std::atomic<int64_t> borrowed_{0};
+  std::atomic<int64_t> total_idle_{0};
+  std::atomic<int64_t> capacity_{-1};
+  std::atomic<int64_t> tick_{0};
 };
 
 template <typename HandleType, typename StreamType>
@@ -95,11 +166,140 @@ HandlePool<HandleType, StreamType>::Instance() {
   return pool;
 }
 
+template <typename HandleType, typename StreamType>
+typename HandlePool<HandleType, StreamType>::StreamCache*
+HandlePool<HandleType, StreamType>::GetCache(StreamType stream) {
+  {
+    absl::ReaderMutexLock lock(&mu_);
+    auto it = caches_.find(stream);
+    if (it != caches_.end()) {
+      return it->second.get();
+    }
+  }
+  absl::WriterMutexLock lock(&mu_);
+  auto& cache = caches_[stream];
+  if (!cache) {
+    cache = std::make_unique<StreamCache>();
+  }
+  return cache.get();
+}
+
+template <typename HandleType, typename StreamType>
+bool HandlePool<HandleType, StreamType>::TryAcquire(StreamType stream,
+                                                    HandleType* handle) {
+  StreamCache* cache = GetCache(stream);
+  absl::MutexLock lock(&cache->mu);
+  cache->last_use = tick_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (cache->handles.empty()) {
+    // The caller will create a fresh handle; count it here rather than in
+    // the per-pool Borrow specializations.
+    created_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  *handle = cache->handles.back();
+  cache->handles.pop_back();
+  total_idle_.fetch_sub(1, std::memory_order_relaxed);
+  return true;
+}
+
 template <typename HandleType, typename StreamType>
 void HandlePool<HandleType, StreamType>::Return(HandleType handle,
                                                 StreamType stream) {
-  absl::MutexLock lock(&mu_);
-  handles_[stream].push_back(handle);
+  StreamCache* cache = GetCache(stream);
+  {
+    absl::MutexLock lock(&cache->mu);
+    cache->handles.push_back(handle);
+    cache->last_use = tick_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+  borrowed_.fetch_sub(1, std::memory_order_relaxed);
+  total_idle_.fetch_add(1, std::memory_order_relaxed);
+  EnforceCapacity();
+}
+
+template <typename HandleType, typename StreamType>
+void HandlePool<HandleType, StreamType>::EnforceCapacity() {
+  const int64_t cap = capacity_.load(std::memory_order_relaxed);
+  if (cap < 0) {
+    return;
+  }
+  while (total_idle_.load(std::memory_order_relaxed) > cap) {
+    HandleType victim_handle;
+    {
+      absl::ReaderMutexLock lock(&mu_);
+      StreamCache* victim = nullptr;
+      int64_t oldest = std::numeric_limits<int64_t>::max();
+      for (auto& [stream, cache] : caches_) {
+        absl::MutexLock cache_lock(&cache->mu);
+        if (!cache->handles.empty() && cache->last_use < oldest) {
+          oldest = cache->last_use;
+          victim = cache.get();
+        }
+      }
+      if (victim == nullptr) {
+        return;
+      }
+      absl::MutexLock cache_lock(&victim->mu);
+      if (victim->handles.empty()) {
+        continue;  // Lost a race with a Borrow; re-evaluate.
+      }
+      // The oldest idle handle of the least-recently-used stream.
+      victim_handle = victim->handles.front();
+      victim->handles.erase(victim->handles.begin());
+      total_idle_.fetch_sub(1, std::memory_order_relaxed);
+      destroyed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    DestroyHandle(victim_handle);
+  }
+}
+
+template <typename HandleType, typename StreamType>
+/*static*/ HandlePoolStats HandlePool<HandleType, StreamType>::GetStats() {
+  HandlePool<HandleType, StreamType>* pool = Instance();
+  HandlePoolStats stats;
+  stats.created = pool->created_.load(std::memory_order_relaxed);
+  stats.destroyed = pool->destroyed_.load(std::memory_order_relaxed);
+  stats.borrowed = pool->borrowed_.load(std::memory_order_relaxed);
+  stats.idle = pool->total_idle_.load(std::memory_order_relaxed);
+  absl::ReaderMutexLock lock(&pool->mu_);
+  stats.idle_per_stream.reserve(pool->caches_.size());
+  for (auto& [stream, cache] : pool->caches_) {
+    absl::MutexLock cache_lock(&cache->mu);
+    stats.idle_per_stream.emplace_back(
+        reinterpret_cast<std::uintptr_t>(stream),
+        static_cast<int64_t>(cache->handles.size()));
+  }
+  return stats;
+}
+
+template <typename HandleType, typename StreamType>
+/*static*/ void HandlePool<HandleType, StreamType>::SetCapacity(
+    int64_t max_idle) {
+  HandlePool<HandleType, StreamType>* pool = Instance();
+  pool->capacity_.store(max_idle < 0 ? -1 : max_idle,
+                        std::memory_order_relaxed);
+  pool->EnforceCapacity();
+}
+
+template <typename HandleType, typename StreamType>
+/*static*/ int64_t HandlePool<HandleType, StreamType>::GetCapacity() {
+  return Instance()->capacity_.load(std::memory_order_relaxed);
+}
+
+template <typename HandleType, typename StreamType>
+/*static*/ absl::Status HandlePool<HandleType, StreamType>::Prewarm(
+    StreamType stream, int count) {
+  // Borrowing the handles and holding them all until the end forces the pool
+  // to create any that do not exist yet; they are returned on destruction.
+  std::vector<Handle> handles;
+  handles.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    absl::StatusOr<Handle> handle = Borrow(stream);
+    if (!handle.ok()) {
+      return handle.status();
+    }
+    handles.push_back(*std::move(handle));
+  }
+  return absl::OkStatus();
 }
 
 // template <typename HandleType, typename StreamType>
@@ -17,6 +17,7 @@ limitations under the License.
 #define JAXLIB_KERNEL_NANOBIND_HELPERS_H_
 
 #include <string>
+#include <unordered_map>
 
 #include "nanobind/nanobind.h"
 #include "absl/base/casts.h"
@@ -48,8 +49,17 @@ class dtype : public nanobind::object {
 // UnpackDescriptor() is available in kernel_helpers.h.
 template <typename T>
 nanobind::bytes PackDescriptor(const T& descriptor) {
+  // Small-op graphs tend to pack the same handful of descriptors over and
+  // over, so identical payloads share a single interned bytes object. The
+  // cache is guarded by the GIL (descriptor builders are only called from
+  // Python) and deliberately leaked, like other process-lifetime state.
+  static auto& interned = *new std::unordered_map<std::string, nanobind::bytes>;
   std::string s = PackDescriptorAsString(descriptor);
-  return nanobind::bytes(s.data(), s.size());
+  auto it = interned.find(s);
+  if (it == interned.end()) {
+    it = interned.emplace(s, nanobind::bytes(s.data(), s.size())).first;
+  }
+  return it->second;
 }
 
 template <typename T>
@@ -18,23 +18,50 @@
     MlirDialectHandle name##_dialect = mlirGetDialectHandle__##name##__(); \
     mlirDialectHandleInsertDialect(name##_dialect, registry)
 
+namespace {
+
+// Registration is split into groups so that the `import jax` path only pays
+// for what tracing needs; the remaining groups are triggered from Python on
+// first use (e.g. when a Mosaic kernel is lowered).
+
+// Dialects every lowering to StableHLO uses.
+void RegisterTracingDialects(MlirDialectRegistry registry) {
+  REGISTER_DIALECT(arith);
+  REGISTER_DIALECT(func);
+  REGISTER_DIALECT(math);
+  REGISTER_DIALECT(memref);
+  REGISTER_DIALECT(scf);
+  REGISTER_DIALECT(vector);
+  // Used when computing compilation cache keys.
+  mlirRegisterTransformsStripDebugInfo();
+}
+
+// Dialects only Mosaic GPU lowers through.
+void RegisterMosaicGpuDialects(MlirDialectRegistry registry) {
+  REGISTER_DIALECT(gpu);
+  REGISTER_DIALECT(nvgpu);
+  REGISTER_DIALECT(nvvm);
+  REGISTER_DIALECT(llvm);
+}
+
+// Upstream transforms passes (canonicalize, cse, ...), run by the Mosaic
+// pipelines. Pass registration is process-global, not per-registry.
+void RegisterTransformsPasses() { mlirRegisterTransformsPasses(); }
+
+}  // namespace
+
 PYBIND11_MODULE(register_jax_dialects, m) {
   m.doc() = "Registers upstream MLIR dialects used by JAX.";
 
+  m.def("register_tracing_dialects", &RegisterTracingDialects);
+  m.def("register_mosaic_gpu_dialects", &RegisterMosaicGpuDialects);
+  m.def("register_transforms_passes", &RegisterTransformsPasses);
+
+  // Eagerly registers everything at once, for callers that do not know which
+  // groups they will need.
   m.def("register_dialects", [](MlirDialectRegistry registry) {
-    REGISTER_DIALECT(arith);
-    REGISTER_DIALECT(func);
-    REGISTER_DIALECT(math);
-    REGISTER_DIALECT(memref);
-    REGISTER_DIALECT(scf);
-    REGISTER_DIALECT(vector);
-    // For Mosaic GPU
-    REGISTER_DIALECT(gpu);
-    REGISTER_DIALECT(nvgpu);
-    REGISTER_DIALECT(nvvm);
-    REGISTER_DIALECT(llvm);
-    mlirRegisterTransformsPasses();
-    // Transforms used by JAX.
-    mlirRegisterTransformsStripDebugInfo();
+    RegisterTracingDialects(registry);
+    RegisterMosaicGpuDialects(registry);
+    RegisterTransformsPasses();
   });
 }
@@ -286,6 +286,170 @@ MlirContext getDefaultContext() {
       py::module_::import(IR_MODULE).attr("Context").attr("current"));
 }
 
+// An opaque multidimensional array of vreg values, mirroring the
+// xla::Array<Value> the C++ passes use. Disassembling into this and indexing
+// or slicing it natively keeps per-vreg MlirValue wrappers from being
+// materialized as Python objects on every boundary crossing; only the
+// entries a pass actually touches get wrapped.
+class VregArray {
+ public:
+  VregArray(llvm::SmallVector<int64_t> shape,
+            llvm::SmallVector<MlirValue> vals)
+      : shape_(std::move(shape)), vals_(std::move(vals)) {
+    int64_t size = 1;
+    for (int64_t d : shape_) {
+      size *= d;
+    }
+    CHECK_EQ(size, static_cast<int64_t>(vals_.size()));
+  }
+
+  const llvm::SmallVector<int64_t>& shape() const { return shape_; }
+  const llvm::SmallVector<MlirValue>& vals() const { return vals_; }
+  int64_t size() const { return static_cast<int64_t>(vals_.size()); }
+
+  // Indexing follows numpy basic indexing for ints and slices: a key with
+  // one int or slice per dimension (missing trailing dimensions are treated
+  // as full slices). All-int keys return the scalar value; any slice makes
+  // the result a VregArray view copy of the selected block.
+  py::object getItem(py::handle key) const {
+    llvm::SmallVector<DimSelection> selection = parseKey(key);
+    bool scalar = true;
+    for (const DimSelection& dim : selection) {
+      scalar &= dim.is_int;
+    }
+    if (scalar) {
+      return py::cast(vals_[flatIndex(selection)]);
+    }
+    llvm::SmallVector<int64_t> out_shape;
+    int64_t out_size = 1;
+    for (const DimSelection& dim : selection) {
+      if (!dim.is_int) {
+        out_shape.push_back(dim.count);
+        out_size *= dim.count;
+      }
+    }
+    llvm::SmallVector<MlirValue> out_vals;
+    out_vals.reserve(out_size);
+    gather(selection, /*dim=*/0, /*offset=*/0, out_vals);
+    return py::cast(VregArray(std::move(out_shape), std::move(out_vals)));
+  }
+
+  void setItem(py::handle key, py::handle value) {
+    llvm::SmallVector<DimSelection> selection = parseKey(key);
+    llvm::SmallVector<int64_t> target_positions;
+    scatterPositions(selection, /*dim=*/0, /*offset=*/0, target_positions);
+    if (py::isinstance<VregArray>(value)) {
+      const VregArray& src = py::cast<const VregArray&>(value);
+      if (static_cast<int64_t>(target_positions.size()) != src.size()) {
+        throw py::value_error("VregArray assignment size mismatch");
+      }
+      for (size_t i = 0; i < target_positions.size(); ++i) {
+        vals_[target_positions[i]] = src.vals_[i];
+      }
+    } else {
+      MlirValue val = py::cast<MlirValue>(value);
+      for (int64_t position : target_positions) {
+        vals_[position] = val;
+      }
+    }
+  }
+
+  // Escape hatch for passes still written against the numpy representation.
+  py::array_t<PyObject*> toNumpy() const {
+    py::array_t<PyObject*> np_vals(
+        llvm::ArrayRef<int64_t>{shape_.data(), shape_.size()});
+    for (ssize_t i = 0; i < np_vals.size(); ++i) {
+      np_vals.mutable_data()[i] = py::cast(vals_[i]).release().ptr();
+    }
+    return np_vals;
+  }
+
+ private:
+  struct DimSelection {
+    bool is_int;
+    int64_t start;
+    int64_t step;   // Only meaningful for slices.
+    int64_t count;  // 1 for ints.
+  };
+
+  llvm::SmallVector<DimSelection> parseKey(py::handle key) const {
+    py::tuple key_tuple = py::isinstance<py::tuple>(key)
+                              ? py::cast<py::tuple>(key)
+                              : py::make_tuple(key);
+    if (key_tuple.size() > shape_.size()) {
+      throw py::index_error("Too many indices for VregArray");
+    }
+    llvm::SmallVector<DimSelection> selection;
+    selection.reserve(shape_.size());
+    for (size_t i = 0; i < shape_.size(); ++i) {
+      if (i >= key_tuple.size()) {
+        selection.push_back({false, 0, 1, shape_[i]});
+        continue;
+      }
+      py::handle entry = key_tuple[i];
+      if (py::isinstance<py::slice>(entry)) {
+        py::ssize_t start, stop, step, count;
+        if (!py::cast<py::slice>(entry).compute(
+                static_cast<py::ssize_t>(shape_[i]), &start, &stop, &step,
+                &count)) {
+          throw py::error_already_set();
+        }
+        selection.push_back({false, static_cast<int64_t>(start),
+                             static_cast<int64_t>(step),
+                             static_cast<int64_t>(count)});
+      } else {
+        int64_t idx = py::cast<int64_t>(entry);
+        if (idx < 0) {
+          idx += shape_[i];
+        }
+        if (idx < 0 || idx >= shape_[i]) {
+          throw py::index_error("VregArray index out of range");
+        }
+        selection.push_back({true, idx, 1, 1});
+      }
+    }
+    return selection;
+  }
+
+  int64_t flatIndex(const llvm::SmallVector<DimSelection>& selection) const {
+    int64_t index = 0;
+    for (size_t i = 0; i < shape_.size(); ++i) {
+      index = index * shape_[i] + selection[i].start;
+    }
+    return index;
+  }
+
+  void gather(const llvm::SmallVector<DimSelection>& selection, size_t dim,
+              int64_t offset, llvm::SmallVector<MlirValue>& out) const {
+    const DimSelection& sel = selection[dim];
+    for (int64_t i = 0; i < sel.count; ++i) {
+      int64_t index = offset * shape_[dim] + sel.start + i * sel.step;
+      if (dim + 1 == shape_.size()) {
+        out.push_back(vals_[index]);
+      } else {
+        gather(selection, dim + 1, index, out);
+      }
+    }
+  }
+
+  void scatterPositions(const llvm::SmallVector<DimSelection>& selection,
+                        size_t dim, int64_t offset,
+                        llvm::SmallVector<int64_t>& out) const {
+    const DimSelection& sel = selection[dim];
+    for (int64_t i = 0; i < sel.count; ++i) {
+      int64_t index = offset * shape_[dim] + sel.start + i * sel.step;
+      if (dim + 1 == shape_.size()) {
+        out.push_back(index);
+      } else {
+        scatterPositions(selection, dim + 1, index, out);
+      }
+    }
+  }
+
+  llvm::SmallVector<int64_t> shape_;
+  llvm::SmallVector<MlirValue> vals_;
+};
+
 }  // namespace
 
 PYBIND11_MODULE(_tpu_ext, m) {
@@ -607,11 +771,78 @@ PYBIND11_MODULE(_tpu_ext, m) {
     free(val_arr.vals);
     return np_vals;
   });
+  py::class_<VregArray>(m, "VregArray", py::module_local())
+      .def(py::init([](py::array_t<PyObject*, py::array::c_style> np_arr) {
+             llvm::SmallVector<int64_t> shape(np_arr.ndim());
+             for (int64_t i = 0; i < np_arr.ndim(); ++i) {
+               shape.data()[i] = np_arr.shape()[i];
+             }
+             llvm::SmallVector<MlirValue> vals(np_arr.size());
+             for (int64_t i = 0; i < np_arr.size(); ++i) {
+               vals.data()[i] =
+                   py::cast<MlirValue>(py::handle(np_arr.data()[i]));
+             }
+             return VregArray(std::move(shape), std::move(vals));
+           }),
+           py::arg("vregs"))
+      .def_property_readonly(
+          "shape",
+          [](const VregArray& self) {
+            return toPyTuple(self.shape().data(), self.shape().size());
+          })
+      .def_property_readonly("size", &VregArray::size)
+      .def_property_readonly(
+          "ndim", [](const VregArray& self) { return self.shape().size(); })
+      .def("__getitem__", &VregArray::getItem)
+      .def("__setitem__", &VregArray::setItem)
+      .def("to_numpy", &VregArray::toNumpy);
+  // VregArray counterparts of assemble/disassemble: the vregs cross the
+  // boundary as one handle and never materialize per-entry Python objects.
+  m.def("assemble",
+        [](const MlirType ty, MlirTpuVectorLayout layout,
+           const VregArray& vregs) -> MlirOperation {
+          if (!mlirTypeIsAVector(ty)) {
+            throw py::type_error("Expected vector type");
+          }
+          llvm::SmallVector<int64_t> shape = vregs.shape();
+          llvm::SmallVector<MlirValue> vals = vregs.vals();
+          return mlirTpuAssemble(
+              getDefaultInsertionPoint(), ty, layout,
+              MlirTpuValueArray{MlirTpuI64ArrayRef{shape.data(), shape.size()},
+                                vals.data()},
+              TARGET_SHAPE);
+        });
+  m.def("disassemble_to_vregs", [](MlirTpuVectorLayout layout, MlirValue val) {
+    NotImplementedDetector detector(getDefaultContext());
+    MlirTpuValueArray val_arr = mlirTpuDisassemble(getDefaultInsertionPoint(),
+                                                   layout, val, TARGET_SHAPE);
+    if (val_arr.vals == nullptr) {
+      if (detector.detected()) {
+        throw NotImplementedException();
+      }
+      throw py::value_error("Failed to disassemble");
+    }
+    llvm::SmallVector<int64_t> shape(val_arr.shape.ptr,
+                                     val_arr.shape.ptr + val_arr.shape.size);
+    int64_t size = 1;
+    for (int64_t d : shape) {
+      size *= d;
+    }
+    llvm::SmallVector<MlirValue> vals(val_arr.vals, val_arr.vals + size);
+    free(val_arr.shape.ptr);
+    free(val_arr.vals);
+    return VregArray(std::move(shape), std::move(vals));
+  });
   m.def("apply_layout_op",
         [](int hardware_generation, const MlirOperation c_op) {
           NotImplementedDetector detector(getDefaultContext());
-          MlirLogicalResult res =
-              mlirTpuApplyLayoutOp(hardware_generation, c_op, TARGET_SHAPE);
+          MlirLogicalResult res;
+          {
+            // The rewrite is pure native work; let other Python threads run.
+            py::gil_scoped_release release;
+            res = mlirTpuApplyLayoutOp(hardware_generation, c_op,
+                                       TARGET_SHAPE);
+          }
           if (mlirLogicalResultIsFailure(res)) {
             if (detector.detected()) {
               throw NotImplementedException();
@@ -619,6 +850,25 @@ PYBIND11_MODULE(_tpu_ext, m) {
             throw std::runtime_error("applyLayoutOp failed");
           }
         });
+  m.def("apply_layout_ops",
+        [](int hardware_generation, std::vector<MlirOperation> c_ops) {
+          // Batched version of apply_layout_op: one boundary crossing and one
+          // diagnostic handler attach per batch instead of per op. The ops
+          // must be listed in the order in which they should be rewritten.
+          NotImplementedDetector detector(getDefaultContext());
+          py::gil_scoped_release release;
+          for (const MlirOperation& c_op : c_ops) {
+            MlirLogicalResult res =
+                mlirTpuApplyLayoutOp(hardware_generation, c_op, TARGET_SHAPE);
+            if (mlirLogicalResultIsFailure(res)) {
+              py::gil_scoped_acquire acquire;
+              if (detector.detected()) {
+                throw NotImplementedException();
+              }
+              throw std::runtime_error("applyLayoutOp failed");
+            }
+          }
+        });
   m.def("relayout",
         [](MlirValue v, MlirTpuVectorLayout src, MlirTpuVectorLayout dst) {
           NotImplementedDetector detector(getDefaultContext());
@@ -632,6 +882,30 @@ PYBIND11_MODULE(_tpu_ext, m) {
           }
           return new_v;
         });
+  m.def("relayout_many",
+        [](std::vector<MlirValue> vs, MlirTpuVectorLayout src,
+           MlirTpuVectorLayout dst) {
+          // Batched version of relayout for values that share source and
+          // destination layouts; attaches the diagnostic handler once.
+          NotImplementedDetector detector(getDefaultContext());
+          MlirTpuInsertionPoint insertion_point = getDefaultInsertionPoint();
+          std::vector<MlirValue> new_vs;
+          new_vs.reserve(vs.size());
+          py::gil_scoped_release release;
+          for (const MlirValue& v : vs) {
+            MlirValue new_v =
+                mlirTpuRelayout(insertion_point, v, src, dst, TARGET_SHAPE);
+            if (new_v.ptr == nullptr) {
+              py::gil_scoped_acquire acquire;
+              if (detector.detected()) {
+                throw NotImplementedException();
+              }
+              throw py::value_error("Failed to relayout");
+            }
+            new_vs.push_back(new_v);
+          }
+          return new_vs;
+        });
   py::register_exception_translator([](std::exception_ptr p) {
     try {
       if (p) std::rethrow_exception(p);
@@ -651,6 +925,18 @@ PYBIND11_MODULE(_tpu_ext, m) {
       },
       py::arg("context"), py::arg("load") = true);
 
+  m.def(
+      "compile_stats",
+      [](bool reset) {
+        MlirTpuCompileStats stats = mlirTpuGetCompileStats(reset);
+        py::dict d;
+        d["ops_rewritten"] = stats.ops_rewritten;
+        d["relayouts_materialized"] = stats.relayouts_materialized;
+        d["relayout_cache_hits"] = stats.relayout_cache_hits;
+        return d;
+      },
+      py::arg("reset") = false);
+
   m.def("private_is_tiled_layout", [](MlirAttribute attr) {
     return mlirTPUAttributeIsATiledLayoutAttr(attr);
   });
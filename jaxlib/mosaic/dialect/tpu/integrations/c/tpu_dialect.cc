@@ -383,6 +383,21 @@ MlirValue mlirTpuRelayout(MlirTpuInsertionPoint insertion_point, MlirValue val,
   }
   return wrap(std::move(failure_or_new_val).value());
 }
+
+MlirTpuCompileStats mlirTpuGetCompileStats(bool reset) {
+  mlir::tpu::MosaicCompileStats &stats = mlir::tpu::mosaicCompileStats();
+  MlirTpuCompileStats snapshot;
+  if (reset) {
+    snapshot.ops_rewritten = stats.ops_rewritten.exchange(0);
+    snapshot.relayouts_materialized = stats.relayouts_materialized.exchange(0);
+    snapshot.relayout_cache_hits = stats.relayout_cache_hits.exchange(0);
+  } else {
+    snapshot.ops_rewritten = stats.ops_rewritten.load();
+    snapshot.relayouts_materialized = stats.relayouts_materialized.load();
+    snapshot.relayout_cache_hits = stats.relayout_cache_hits.load();
+  }
+  return snapshot;
+}
 }
 
 #include "mlir/CAPI/Pass.h"     // IWYU pragma: keep
@@ -216,6 +216,17 @@ MLIR_CAPI_EXPORTED MlirValue
 mlirTpuRelayout(MlirTpuInsertionPoint insertion_point, MlirValue val,
                 MlirTpuVectorLayout src, MlirTpuVectorLayout dst,
                 MlirTpuI64TargetTuple target_shape);
+
+// Snapshot of the process-wide Mosaic compile-time counters.
+typedef struct MlirTpuCompileStats {
+  int64_t ops_rewritten;
+  int64_t relayouts_materialized;
+  int64_t relayout_cache_hits;
+} MlirTpuCompileStats;
+
+// Returns the current counter values. If `reset` is true, the counters are
+// atomically zeroed as they are read.
+MLIR_CAPI_EXPORTED MlirTpuCompileStats mlirTpuGetCompileStats(bool reset);
 #ifdef __cplusplus
 }
 #endif
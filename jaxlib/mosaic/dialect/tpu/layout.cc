@@ -83,8 +83,45 @@ DenseBoolArrayAttr RectangularVregBounds::getSublaneMask(
   return DenseBoolArrayAttr::get(mlir_ctx, sublane_mask);
 }
 
+SmallVector<int64_t> RectangularVregBounds::maskCacheKey(
+    const std::array<int64_t, 2> target_shape) const {
+  return {0, starts_[0], starts_[1], ends_[0], ends_[1]};
+}
+
 namespace {
 
+// Folds the layout properties that the getVectorMask implementations below
+// depend on into a mask cache key. Layout offsets are deliberately included
+// even though the implementations must not use them; they are cheap and keep
+// the key conservative.
+void appendLayoutMaskKey(SmallVector<int64_t>& key, const VectorLayout& layout) {
+  key.push_back(layout.bitwidth());
+  for (const LayoutOffset& offset : layout.offsets()) {
+    key.push_back(offset.value_or(-1));
+  }
+  key.push_back(layout.tiling()[0]);
+  key.push_back(layout.tiling()[1]);
+  key.push_back(static_cast<int64_t>(layout.implicit_dim()));
+}
+
+// Returns whether the target can materialize a vector mask with a distinct
+// value per subelement directly, through tpu.create_subelement_mask. Other
+// (generation, packing) combinations virtualize subelement masking through
+// 32-bit bitmasks instead.
+bool hasNativeSubelementMask(const int generation, const int packing) {
+  return (packing == 2 && generation >= 4) || (packing == 4 && generation >= 5);
+}
+
+// The bits occupied within a 32-bit word by the subelements in [start, stop).
+// Subelement 0 lives in the least significant bits.
+uint64_t subelementBitRange(const int packing, const int64_t start,
+                            const int64_t stop) {
+  const int bits_per_subelement = 32 / packing;
+  const uint64_t all = 0xFFFFFFFF;
+  return (all << (start * bits_per_subelement)) &
+         (all >> ((packing - stop) * bits_per_subelement));
+}
+
 // Represents a subset of a (packed) 1D vector register.
 //
 // All indices below are scaled up by the packing. That is, the maximal stop
@@ -139,31 +176,69 @@ class SingleRowVRegBounds : public VRegDataBounds {
   FailureOr<TypedValue<VectorType>> getVectorMask(
       OpBuilder& builder, const Location loc, const int generation,
       const std::array<int64_t, 2> target_shape) const override {
-    if (maskVariesAlong(Direction::kSubelements, target_shape)) {
-      return emitError(loc, "Not implemented");
-    }
     const auto i32_vreg = VectorType::get(target_shape, builder.getI32Type());
-    const auto getI32VregConstant = [&](const int32_t v) {
+    const auto getI32VregConstant = [&](const uint64_t v) {
       return builder.create<arith::ConstantOp>(
-          loc, i32_vreg, DenseElementsAttr::get(i32_vreg, v));
+          loc, i32_vreg,
+          DenseElementsAttr::get(i32_vreg, builder.getIntegerAttr(
+                                               builder.getI32Type(),
+                                               APInt(32, v))));
     };
-    if (layout_.bitwidth() != 32 &&
-        (start_offset_ % (target_shape[1] * layout_.packing()) != 0 ||
-         stop_offset_ % (target_shape[1] * layout_.packing()) != 0)) {
-      return emitError(loc, "Not implemented");
-    }
-    const Value start = getI32VregConstant(start_offset_ / layout_.packing());
-    const Value end = getI32VregConstant(stop_offset_ / layout_.packing());
     const Value iota = builder.create<tpu::IotaOp>(loc, i32_vreg, nullptr);
-    return cast<TypedValue<VectorType>>(
-        builder
-            .create<arith::AndIOp>(
-                loc,
-                builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sge,
-                                              iota, start),
-                builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt,
-                                              iota, end))
-            .getResult());
+    // Entries are packed into 32-bit words in order, so word w of the vreg
+    // (in the row-major (sublane, lane) order produced by the iota) holds
+    // the entries [w * packing, (w + 1) * packing).
+    const int64_t packing = layout_.packing();
+    if (!maskVariesAlong(Direction::kSubelements, target_shape)) {
+      const Value start = getI32VregConstant(start_offset_ / packing);
+      const Value end = getI32VregConstant(stop_offset_ / packing);
+      return cast<TypedValue<VectorType>>(
+          builder
+              .create<arith::AndIOp>(
+                  loc,
+                  builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::sge,
+                                                iota, start),
+                  builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt,
+                                                iota, end))
+              .getResult());
+    }
+    // A bound falls in the middle of a word, which no vector mask can express:
+    // return a 32-bit bitmask instead, with the live subelements of the two
+    // boundary words selected explicitly. Callers blend through an i32
+    // bitcast.
+    const int64_t start_word = start_offset_ / packing;
+    const int64_t stop_word = stop_offset_ / packing;
+    const Value zero = getI32VregConstant(0);
+    const Value interior = builder.create<arith::AndIOp>(
+        loc,
+        builder.create<arith::CmpIOp>(
+            loc, arith::CmpIPredicate::sge, iota,
+            getI32VregConstant(llvm::divideCeil(start_offset_, packing))),
+        builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::slt, iota,
+                                      getI32VregConstant(stop_word)));
+    Value bitmask = builder.create<arith::SelectOp>(
+        loc, interior, getI32VregConstant(0xFFFFFFFF), zero);
+    const auto orSelectedBits = [&](const int64_t word, const uint64_t bits) {
+      const Value is_word = builder.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, iota, getI32VregConstant(word));
+      const Value word_bits = builder.create<arith::SelectOp>(
+          loc, is_word, getI32VregConstant(bits), zero);
+      bitmask = builder.create<arith::OrIOp>(loc, bitmask, word_bits);
+    };
+    const bool partial_head = start_offset_ % packing != 0;
+    if (partial_head) {
+      const int64_t stop_subelem =
+          stop_word == start_word ? stop_offset_ % packing : packing;
+      orSelectedBits(start_word, subelementBitRange(
+                                     packing, start_offset_ % packing,
+                                     stop_subelem));
+    }
+    if (stop_offset_ % packing != 0 &&
+        !(partial_head && stop_word == start_word)) {
+      orSelectedBits(stop_word,
+                     subelementBitRange(packing, 0, stop_offset_ % packing));
+    }
+    return cast<TypedValue<VectorType>>(bitmask);
   }
 
   // See base class.
@@ -182,6 +257,14 @@ class SingleRowVRegBounds : public VRegDataBounds {
     return DenseBoolArrayAttr::get(mlir_ctx, sublane_mask);
   }
 
+  // See base class.
+  SmallVector<int64_t> maskCacheKey(
+      const std::array<int64_t, 2> target_shape) const override {
+    SmallVector<int64_t> key{1, start_offset_, stop_offset_};
+    appendLayoutMaskKey(key, layout_);
+    return key;
+  }
+
  private:
   VectorLayout layout_;
   int64_t start_offset_;
@@ -252,23 +335,16 @@ class TiledRectangularVregBounds : public VRegDataBounds {
     const IntegerType i1 = builder.getI1Type();
     FAILUREOR_ASSIGN_OR_RETURN(
         const VectorType mask_vreg_ty, [&]() -> FailureOr<VectorType> {
-          // I'm pretty sure this works for all bitwidths, but it's untested.
           if (maskVariesAlong(Direction::kSubelements, target_shape)) {
-            if (layout_.packing() != 2) {
-              // TODO(b/300082350): Generalize this
-              return emitError(loc, "Not implemented");
-            }
-            // For older TPUs, we virtualize masking, but only for simple cases.
-            if (generation < 4) {
-              if (num_tiles_ > 1) {
-                return emitError(loc, "Not implemented");
-              }
-              return VectorType::get(target_shape, i1);
-            } else {
+            if (hasNativeSubelementMask(generation, layout_.packing())) {
               return VectorType::get(
                   {target_shape[0], target_shape[1], layout_.packing()}, i1);
             }
-            return VectorType::get({target_shape[0], target_shape[1], 2}, i1);
+            // Otherwise masking is virtualized through a 32-bit bitmask, but
+            // only for simple cases.
+            if (num_tiles_ > 1) {
+              return emitError(loc, "Not implemented");
+            }
           }
           return VectorType::get(target_shape, i1);
         }());
@@ -312,25 +388,21 @@ class TiledRectangularVregBounds : public VRegDataBounds {
       if (maskVariesAlong(Direction::kSubelements, target_shape)) {
         int64_t start_row = start_offsets_[0] + row_offset;
         int64_t end_row = end_offsets_[0] + row_offset;
-        if (generation >= 4) {
+        if (hasNativeSubelementMask(generation, packing)) {
           // Only use non-trivial start/end if they don't fall on sublane
           // boundary. Otherwise CreateMaskOp already does the right thing. This
           // lets us use cheaper instruction sequences on TPUv4.
-          if (start_offsets_[0] % layout_.packing() == 0) {
+          if (start_offsets_[0] % packing == 0) {
             start_row = 0;
           }
-          if (end_offsets_[0] % layout_.packing() == 0) {
-            end_row = target_shape[0] * layout_.packing();
+          if (end_offsets_[0] % packing == 0) {
+            end_row = target_shape[0] * packing;
           }
           auto submask = builder.create<tpu::CreateSubelementMaskOp>(
-              loc, mask_vreg_ty, start_row, end_row, layout_.packing());
+              loc, mask_vreg_ty, start_row, end_row, packing);
           tile_mask = builder.create<arith::AndIOp>(loc, tile_mask, submask);
-        } else {  // generation < 4
-          if (num_tiles_ > 1) {
-            return emitError(loc,
-                             "Not implemented: TPU generations before 4 cannot "
-                             "handle all bf16 masking");
-          }
+        } else {  // No native subelement masks: virtualize through bitmasks.
+          CHECK_EQ(num_tiles_, 1);  // Enforced by the mask type selection.
           const auto getMaskCst = [&](const uint64_t v) {
             const auto int_mask_ty =
                 VectorType::get(target_shape, builder.getI32Type());
@@ -342,25 +414,31 @@ class TiledRectangularVregBounds : public VRegDataBounds {
           };
           Value tile_bitmask = builder.create<arith::SelectOp>(
               loc, tile_mask, getMaskCst(0xFFFFFFFF), getMaskCst(0));
-          if (start_row % 2 != 0) {
+          if (start_row % packing != 0) {
             auto row_mask = builder.create<tpu::CreateMaskOp>(
                 loc, mask_vreg_ty,
-                ValueRange{boundIdxConst(start_row / 2), boundIdxConst(0)},
-                ValueRange{boundIdxConst(start_row / 2 + 1),
+                ValueRange{boundIdxConst(start_row / packing),
+                           boundIdxConst(0)},
+                ValueRange{boundIdxConst(start_row / packing + 1),
                            boundIdxConst(target_shape[1])});
             auto row_bitmask = builder.create<arith::SelectOp>(
-                loc, row_mask, getMaskCst(0xFFFF0000), getMaskCst(0xFFFFFFFF));
+                loc, row_mask,
+                getMaskCst(
+                    subelementBitRange(packing, start_row % packing, packing)),
+                getMaskCst(0xFFFFFFFF));
             tile_bitmask =
                 builder.create<arith::AndIOp>(loc, tile_bitmask, row_bitmask);
           }
-          if (end_row % 2 != 0) {
+          if (end_row % packing != 0) {
             auto row_mask = builder.create<tpu::CreateMaskOp>(
                 loc, mask_vreg_ty,
-                ValueRange{boundIdxConst(end_row / 2), boundIdxConst(0)},
-                ValueRange{boundIdxConst(end_row / 2 + 1),
+                ValueRange{boundIdxConst(end_row / packing), boundIdxConst(0)},
+                ValueRange{boundIdxConst(end_row / packing + 1),
                            boundIdxConst(target_shape[1])});
             auto row_bitmask = builder.create<arith::SelectOp>(
-                loc, row_mask, getMaskCst(0xFFFF), getMaskCst(0xFFFFFFFF));
+                loc, row_mask,
+                getMaskCst(subelementBitRange(packing, 0, end_row % packing)),
+                getMaskCst(0xFFFFFFFF));
             tile_bitmask =
                 builder.create<arith::AndIOp>(loc, tile_bitmask, row_bitmask);
           }
@@ -393,6 +471,16 @@ class TiledRectangularVregBounds : public VRegDataBounds {
     return DenseBoolArrayAttr::get(mlir_ctx, mask);
   }
 
+  // See base class.
+  SmallVector<int64_t> maskCacheKey(
+      const std::array<int64_t, 2> target_shape) const override {
+    SmallVector<int64_t> key{2, num_tiles_, start_offsets_[0],
+                             start_offsets_[1], end_offsets_[0],
+                             end_offsets_[1]};
+    appendLayoutMaskKey(key, layout_);
+    return key;
+  }
+
  private:
   VectorLayout layout_;
   int64_t num_tiles_;
@@ -429,7 +517,9 @@ VectorLayout::as_tuple() const {
 }
 
 bool VectorLayout::operator==(const VectorLayout& other) const {
-  return as_tuple() == other.as_tuple();
+  // The precomputed keys reject almost all mismatches with one comparison;
+  // the field comparison only guards against hash collisions.
+  return key_ == other.key_ && as_tuple() == other.as_tuple();
 }
 
 bool VectorLayout::hasNativeTiling(
@@ -699,7 +789,7 @@ mlir::Diagnostic& operator<<(mlir::Diagnostic& diag, const Layout& v) {
 }
 
 llvm::hash_code hash_value(const VectorLayout& layout) {
-  return llvm::hash_value(layout.as_tuple());
+  return llvm::hash_code(layout.key_);
 }
 
 std::ostream &operator<<(std::ostream &os, VectorLayout::ImplicitDim dim) {
@@ -25,6 +25,7 @@ limitations under the License.
 #include <tuple>
 
 #include "absl/log/check.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/bit.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -82,6 +83,16 @@ struct VRegDataBounds {
   // in that sublane are used to represent data (relevant for packed layouts).
   virtual DenseBoolArrayAttr getSublaneMask(
       MLIRContext *ctxt, std::array<int64_t, 2> target_shape) const = 0;
+
+  // Returns a stable content key for the mask getVectorMask emits for these
+  // bounds, or an empty vector when the mask is not cacheable. For a fixed
+  // generation and target shape, equal keys yield identical masks, so callers
+  // may reuse a previously generated mask value instead of emitting a new
+  // one. Mask generation only depends on constants, never on surrounding IR.
+  virtual SmallVector<int64_t> maskCacheKey(
+      std::array<int64_t, 2> target_shape) const {
+    return {};
+  }
 };
 
 // Represents a rectangular region of data within a vector register.
@@ -114,6 +125,10 @@ class RectangularVregBounds : public VRegDataBounds {
       MLIRContext *mlir_ctxt,
       std::array<int64_t, 2> target_shape) const override;
 
+  // See base class.
+  SmallVector<int64_t> maskCacheKey(
+      std::array<int64_t, 2> target_shape) const override;
+
  private:
   std::array<int64_t, 2> starts_;
   std::array<int64_t, 2> ends_;
@@ -238,6 +253,11 @@ class VectorLayout {
     for (auto [o, t] : llvm::zip(offsets_, tiling_)) {
       CHECK(!o || 0 <= *o && *o < t);
     }
+    // Layouts are immutable, so the hash can be computed once here. It doubles
+    // as a fast-reject key in operator==: layout comparison and hashing are
+    // hot in the inference fixed-point iteration, and both become single-word
+    // operations this way.
+    key_ = static_cast<uint64_t>(llvm::hash_value(as_tuple()));
   }
 
   int8_t bitwidth() const { return bitwidth_; }
@@ -470,6 +490,8 @@ class VectorLayout {
   std::array<int64_t, 2> tiling_;
   int8_t bitwidth_;
   ImplicitDim implicit_dim_;
+  // Precomputed hash of the fields above; see the constructor.
+  uint64_t key_;
 };
 
 using Layout = std::optional<VectorLayout>;
@@ -19,10 +19,14 @@ limitations under the License.
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/TypeSwitch.h"  // IWYU pragma: keep.
+#include "llvm/Support/Mutex.h"
 #include "mlir/IR/AffineExpr.h"
 #include "mlir/IR/AffineMap.h"
 #include "mlir/IR/Builders.h"
@@ -178,6 +182,50 @@ AffineMap TiledLayoutAttr::getAffineMap() const {
   return map;
 }
 
+MosaicCompileStats &mosaicCompileStats() {
+  static auto *stats = new MosaicCompileStats;
+  return *stats;
+}
+
+namespace {
+// Deliberately leaked, like the other process-lifetime stats. StringMap entry
+// addresses are stable across rehashing, so returned references stay valid.
+llvm::sys::SmartMutex<true> &patternStatsMutex() {
+  static auto *mutex = new llvm::sys::SmartMutex<true>;
+  return *mutex;
+}
+llvm::StringMap<MosaicPatternStats> &patternStatsRegistry() {
+  static auto *registry = new llvm::StringMap<MosaicPatternStats>;
+  return *registry;
+}
+}  // namespace
+
+MosaicPatternStats &mosaicPatternStats(llvm::StringRef pattern_name) {
+  llvm::sys::SmartScopedLock<true> lock(patternStatsMutex());
+  return patternStatsRegistry()[pattern_name];
+}
+
+std::vector<std::tuple<std::string, int64_t, int64_t, int64_t>>
+snapshotMosaicPatternStats() {
+  std::vector<std::tuple<std::string, int64_t, int64_t, int64_t>> snapshot;
+  {
+    llvm::sys::SmartScopedLock<true> lock(patternStatsMutex());
+    snapshot.reserve(patternStatsRegistry().size());
+    for (const auto &entry : patternStatsRegistry()) {
+      const MosaicPatternStats &stats = entry.getValue();
+      snapshot.emplace_back(entry.getKey().str(),
+                            stats.matches.load(std::memory_order_relaxed),
+                            stats.rewrites.load(std::memory_order_relaxed),
+                            stats.time_ns.load(std::memory_order_relaxed));
+    }
+  }
+  std::sort(snapshot.begin(), snapshot.end(),
+            [](const auto &a, const auto &b) {
+              return std::get<3>(a) > std::get<3>(b);
+            });
+  return snapshot;
+}
+
 MemRefType getMemRefType(Value value) {
   if (auto erase_op = value.getDefiningOp<tpu::EraseLayoutOp>()) {
     value = erase_op.getOperand();
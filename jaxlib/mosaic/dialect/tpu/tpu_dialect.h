@@ -16,9 +16,13 @@ limitations under the License.
 #ifndef JAXLIB_MOSAIC_DIALECT_TPU_DIALECT_H_
 #define JAXLIB_MOSAIC_DIALECT_TPU_DIALECT_H_
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/IR/BuiltinOps.h"
@@ -50,6 +54,40 @@ namespace tpu {
 
 std::pair<bool, bool> mightCommunicateBetweenChips(Operation* op);
 
+// Process-wide compile-time statistics for the Mosaic TPU pipeline. Counters
+// accumulate across compiles (and across threads; they are updated with
+// relaxed atomics). Snapshot and optionally reset them through the C API or
+// the tpu extension module, e.g. to regression-track compile latency in CI.
+struct MosaicCompileStats {
+  // Ops processed by the apply-vector-layout pass.
+  std::atomic<int64_t> ops_rewritten{0};
+  // Layout conversions for which a gather/shuffle sequence was emitted.
+  std::atomic<int64_t> relayouts_materialized{0};
+  // Layout conversions satisfied by reusing a previously emitted sequence.
+  std::atomic<int64_t> relayout_cache_hits{0};
+};
+
+MosaicCompileStats& mosaicCompileStats();
+
+// Cumulative per-pattern statistics for the greedy rewrite passes (currently
+// recorded by LinalgVectorizationPass), keyed by pattern debug name. Like
+// MosaicCompileStats, the counters accumulate across compiles and threads.
+struct MosaicPatternStats {
+  // matchAndRewrite invocations.
+  std::atomic<int64_t> matches{0};
+  // Invocations that succeeded, i.e. rewrote the IR.
+  std::atomic<int64_t> rewrites{0};
+  // Wall time spent in matchAndRewrite, successful or not.
+  std::atomic<int64_t> time_ns{0};
+};
+
+MosaicPatternStats& mosaicPatternStats(llvm::StringRef pattern_name);
+
+// Returns (pattern name, matches, rewrites, time_ns) for every pattern
+// recorded so far, sorted by descending time.
+std::vector<std::tuple<std::string, int64_t, int64_t, int64_t>>
+snapshotMosaicPatternStats();
+
 std::unique_ptr<OperationPass<func::FuncOp>> createInferMemRefLayoutPass(
     int hardware_generation = -1);
 
@@ -63,6 +101,12 @@ std::unique_ptr<OperationPass<func::FuncOp>> createApplyVectorLayoutPass(
 std::unique_ptr<OperationPass<func::FuncOp>>
 createLogicalToPhysicalDeviceIdPass(int64_t total_devices);
 
+std::unique_ptr<OperationPass<func::FuncOp>> createDmaPipeliningPass(
+    int prefetch_depth = 2);
+
+std::unique_ptr<OperationPass<func::FuncOp>> createAssignMemorySpacesPass(
+    int hardware_generation = -1, int64_t vmem_budget_bytes = -1);
+
 std::unique_ptr<OperationPass<func::FuncOp>> createLinalgVectorizationPass(
     bool supports_bf16_alu_instructions = false,
     bool supports_bf16_matmul = false);
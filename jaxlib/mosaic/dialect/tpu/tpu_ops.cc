@@ -265,6 +265,12 @@ class CanonicalizeAddOfMatmul : public OpRewritePattern<AddOp> {
   using OpRewritePattern<AddOp>::OpRewritePattern;
 
   LogicalResult matchAndRewrite(AddOp op, PatternRewriter &rewriter) const {
+    // The pattern is registered for all adds, but only vector adds can feed
+    // into a matmul accumulator. Bail out before probing defining ops, since
+    // matmul-heavy modules contain many scalar adds in their control flow.
+    if (!isa<VectorType>(op.getType())) {
+      return failure();
+    }
     auto try_canonicalize = [&](Value maybe_matmul, Value maybe_acc) {
       auto matmul = dyn_cast_if_present<MatmulOp>(maybe_matmul.getDefiningOp());
       if (!matmul) {
@@ -281,8 +287,9 @@ class CanonicalizeAddOfMatmul : public OpRewritePattern<AddOp> {
       }
       return failure();
     };
+    // Addition is commutative, so try the matmul on either side.
     return success(succeeded(try_canonicalize(op.getLhs(), op.getRhs())) ||
-                   succeeded(try_canonicalize(op.getLhs(), op.getRhs())));
+                   succeeded(try_canonicalize(op.getRhs(), op.getLhs())));
   }
 };
 
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
@@ -13,8 +14,8 @@
 #include <vector>
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVectorExtras.h"
-#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/iterator_range.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -46,6 +47,7 @@
 #include "mlir/Pass/Pass.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
+#include "mlir/Support/TypeID.h"
 #include "absl/log/check.h"
 #include "absl/log/log.h"
 #include "absl/status/status.h"
@@ -140,20 +142,50 @@ FailureOr<Value> maskOOB(RewriteContext &ctx, OpBuilder &builder,
   if (bounds.isComplete(ctx.target_shape)) {
     return value;
   }
-  FAILUREOR_ASSIGN_OR_RETURN(
-      TypedValue<VectorType> mask,
-      bounds.getVectorMask(builder, value.getLoc(), ctx.hardware_generation,
-                           ctx.target_shape));
+  const Location loc = value.getLoc();
+  // Identical bounds request identical masks, often for thousands of edge
+  // vregs, so masks are generated once per function, in the entry block
+  // (where they dominate any reuse -- mask generation only depends on
+  // constants), and reused by value afterwards.
+  const SmallVector<int64_t> small_key = bounds.maskCacheKey(ctx.target_shape);
+  TypedValue<VectorType> mask = nullptr;
+  std::vector<int64_t> key(small_key.begin(), small_key.end());
+  if (!key.empty()) {
+    if (auto it = ctx.mask_cache.find(key); it != ctx.mask_cache.end()) {
+      mask = cast<TypedValue<VectorType>>(it->second);
+    }
+  }
+  if (mask == nullptr) {
+    if (!key.empty()) {
+      Block &entry_block = ctx.func.getBody().front();
+      OpBuilder entry_builder(&entry_block, entry_block.begin());
+      FAILUREOR_ASSIGN_OR_RETURN(
+          mask, bounds.getVectorMask(entry_builder, loc,
+                                     ctx.hardware_generation,
+                                     ctx.target_shape));
+      ctx.mask_cache.insert({std::move(key), mask});
+    } else {
+      FAILUREOR_ASSIGN_OR_RETURN(
+          mask, bounds.getVectorMask(builder, loc, ctx.hardware_generation,
+                                     ctx.target_shape));
+    }
+  }
   if (cast<IntegerType>(mask.getType().getElementType()).getWidth() != 1) {
-    return emitError(value.getLoc(),
-                     "Not implemented: Unsupported mask bitwidth");
-  }
-  auto neutral_vec_ty = VectorType::get(ctx.target_shape, neutral.getType());
-  auto neutral_vec = builder.create<arith::ConstantOp>(
-      value.getLoc(), neutral_vec_ty,
-      DenseElementsAttr::get(neutral_vec_ty, neutral));
-  return builder
-      .create<arith::SelectOp>(value.getLoc(), mask, value, neutral_vec)
+    return emitError(loc, "Not implemented: Unsupported mask bitwidth");
+  }
+  Value neutral_vec;
+  if (auto it = ctx.neutral_vec_cache.find(neutral);
+      it != ctx.neutral_vec_cache.end()) {
+    neutral_vec = it->second;
+  } else {
+    auto neutral_vec_ty = VectorType::get(ctx.target_shape, neutral.getType());
+    Block &entry_block = ctx.func.getBody().front();
+    OpBuilder entry_builder(&entry_block, entry_block.begin());
+    neutral_vec = entry_builder.create<arith::ConstantOp>(
+        loc, neutral_vec_ty, DenseElementsAttr::get(neutral_vec_ty, neutral));
+    ctx.neutral_vec_cache.insert({neutral, neutral_vec});
+  }
+  return builder.create<arith::SelectOp>(loc, mask, value, neutral_vec)
       .getResult();
 }
 
@@ -204,8 +236,11 @@ xla::Array<Value> concatenate(const ArrayRef<xla::Array<Value>> arrays,
   return res;
 }
 
+// The ArrayRef aliases the array's storage, so it must not outlive it. Taking
+// the array by reference matters: this is called on every assemble(), and a
+// by-value parameter would deep-copy the whole vreg array just to flatten it.
 template <typename T>
-ArrayRef<T> XlaArrayToFlatArrayRef(xla::Array<T> xla_array) {
+ArrayRef<T> XlaArrayToFlatArrayRef(const xla::Array<T> &xla_array) {
   return ArrayRef<T>(xla_array.data(), xla_array.num_elements());
 }
 
@@ -436,9 +471,16 @@ FailureOr<std::array<int64_t, 2>> getMemRefTiling(
   return emitError(value.getLoc(), "Not implemented");
 }
 
-// Hoist a vector constant as an additional argument of the function.
+// Hoist a vector constant as an additional argument of the function. Each
+// distinct constant is appended only once: attributes are uniqued by the
+// context, so a pointer-keyed lookup catches repeated hoists of e.g. the
+// same quantization scale table.
 FailureOr<BlockArgument> appendConstant(RewriteContext &ctx,
                                         DenseElementsAttr value) {
+  if (auto it = ctx.hoisted_constants.find(value);
+      it != ctx.hoisted_constants.end()) {
+    return it->second;
+  }
   MLIRContext *mlir_ctx = ctx.func.getContext();
   Block &entry_block = ctx.func.getBody().front();
   auto value_ty = cast<VectorType>(value.getType());
@@ -496,6 +538,7 @@ FailureOr<BlockArgument> appendConstant(RewriteContext &ctx,
     ctx.func->setAttr("window_params", ArrayAttr::get(ctx.func.getContext(),
                                                       window_params_values));
   }
+  ctx.hoisted_constants.insert({value, argument});
   return argument;
 }
 
@@ -3577,7 +3620,9 @@ LogicalResult vector_shape_cast_rule(RewriteContext &ctx, Operation &op,
                   ctx.target_shape));
   auto getDstVregs = [&]() -> FailureOr<xla::Array<Value>> {
     if (no_op) {
-      xla::Array<Value> dst_vregs_local = src_vregs;
+      // src_vregs is dead after this branch, so reshape it in place rather
+      // than copying it.
+      xla::Array<Value> dst_vregs_local = std::move(src_vregs);
       dst_vregs_local.Reshape(
           layout_out.tileArrayShape(dst_shape, ctx.target_shape));
       return dst_vregs_local;
@@ -4027,45 +4072,50 @@ LogicalResult prng_random_bits_rule(RewriteContext &ctx, Operation &op,
   return success();
 }
 
-const llvm::StringMap<rule_type> &rules() {
-  static auto rules = new llvm::StringMap<rule_type>{
-      {arith::ConstantOp::getOperationName(), arith_constant_rule},
-      {arith::ExtFOp::getOperationName(), arith_extf_rule},
-      {arith::ExtSIOp::getOperationName(), arith_extsi_rule},
-      {arith::TruncFOp::getOperationName(), arith_truncf_rule},
-      {arith::TruncIOp::getOperationName(), arith_trunci_rule},
-      {func::ReturnOp::getOperationName(), func_return_rule},
-      {scf::ForOp::getOperationName(), scf_for_rule},
-      {scf::WhileOp::getOperationName(), scf_while_rule},
-      {scf::ConditionOp::getOperationName(), scf_condition_rule},
-      {scf::IfOp::getOperationName(), scf_if_rule},
-      {scf::YieldOp::getOperationName(), scf_yield_rule},
-      {tpu::RotateOp::getOperationName(), tpu_rotate_rule},
-      {tpu::ConcatenateOp::getOperationName(), tpu_concatenate_rule},
-      {tpu::IotaOp::getOperationName(), tpu_iota_rule},
-      {tpu::GatherOp::getOperationName(), tpu_gather_rule},
-      {tpu::LoadOp::getOperationName(), tpu_load_rule},
-      {tpu::StoreOp::getOperationName(), tpu_store_rule},
-      {tpu::StridedLoadOp::getOperationName(), tpu_strided_load_rule},
-      {tpu::StridedStoreOp::getOperationName(), tpu_strided_store_rule},
-      {tpu::MatmulOp::getOperationName(), tpu_matmul_rule},
-      {tpu::RegionOp::getOperationName(), tpu_region_rule},
-      {tpu::RepeatOp::getOperationName(), tpu_repeat_rule},
-      {tpu::BitcastOp::getOperationName(), tpu_bitcast_rule},
-      {tpu::TraceOp::getOperationName(), tpu_trace_rule},
-      {tpu::AssumeLayoutOp::getOperationName(), tpu_assume_layout_rule},
-      {tpu::PRNGRandomBitsOp::getOperationName(), prng_random_bits_rule},
-      {vector::BroadcastOp::getOperationName(), vector_broadcast_rule},
-      {vector::ContractionOp::getOperationName(), vector_contract_rule},
-      {vector::ExtractOp::getOperationName(), vector_extract_rule},
-      {vector::LoadOp::getOperationName(), vector_load_rule},
-      {vector::MultiDimReductionOp::getOperationName(),
+// The dispatch table is keyed by the ops' TypeIDs, which are unique
+// process-lifetime pointers, so per-op dispatch is a pointer hash rather than
+// a hash of the op name string. Unregistered ops all share a TypeID and fall
+// through to the elementwise/unsupported handling, just as they missed the
+// name-keyed table before.
+const llvm::DenseMap<TypeID, rule_type> &rules() {
+  static auto rules = new llvm::DenseMap<TypeID, rule_type>{
+      {TypeID::get<arith::ConstantOp>(), arith_constant_rule},
+      {TypeID::get<arith::ExtFOp>(), arith_extf_rule},
+      {TypeID::get<arith::ExtSIOp>(), arith_extsi_rule},
+      {TypeID::get<arith::TruncFOp>(), arith_truncf_rule},
+      {TypeID::get<arith::TruncIOp>(), arith_trunci_rule},
+      {TypeID::get<func::ReturnOp>(), func_return_rule},
+      {TypeID::get<scf::ForOp>(), scf_for_rule},
+      {TypeID::get<scf::WhileOp>(), scf_while_rule},
+      {TypeID::get<scf::ConditionOp>(), scf_condition_rule},
+      {TypeID::get<scf::IfOp>(), scf_if_rule},
+      {TypeID::get<scf::YieldOp>(), scf_yield_rule},
+      {TypeID::get<tpu::RotateOp>(), tpu_rotate_rule},
+      {TypeID::get<tpu::ConcatenateOp>(), tpu_concatenate_rule},
+      {TypeID::get<tpu::IotaOp>(), tpu_iota_rule},
+      {TypeID::get<tpu::GatherOp>(), tpu_gather_rule},
+      {TypeID::get<tpu::LoadOp>(), tpu_load_rule},
+      {TypeID::get<tpu::StoreOp>(), tpu_store_rule},
+      {TypeID::get<tpu::StridedLoadOp>(), tpu_strided_load_rule},
+      {TypeID::get<tpu::StridedStoreOp>(), tpu_strided_store_rule},
+      {TypeID::get<tpu::MatmulOp>(), tpu_matmul_rule},
+      {TypeID::get<tpu::RegionOp>(), tpu_region_rule},
+      {TypeID::get<tpu::RepeatOp>(), tpu_repeat_rule},
+      {TypeID::get<tpu::BitcastOp>(), tpu_bitcast_rule},
+      {TypeID::get<tpu::TraceOp>(), tpu_trace_rule},
+      {TypeID::get<tpu::AssumeLayoutOp>(), tpu_assume_layout_rule},
+      {TypeID::get<tpu::PRNGRandomBitsOp>(), prng_random_bits_rule},
+      {TypeID::get<vector::BroadcastOp>(), vector_broadcast_rule},
+      {TypeID::get<vector::ContractionOp>(), vector_contract_rule},
+      {TypeID::get<vector::ExtractOp>(), vector_extract_rule},
+      {TypeID::get<vector::LoadOp>(), vector_load_rule},
+      {TypeID::get<vector::MultiDimReductionOp>(),
        vector_multi_reduction_rule},
-      {vector::ExtractStridedSliceOp::getOperationName(),
+      {TypeID::get<vector::ExtractStridedSliceOp>(),
        vector_extract_strided_slice_rule},
-      {vector::ShapeCastOp::getOperationName(), vector_shape_cast_rule},
-      {vector::StoreOp::getOperationName(), vector_store_rule},
-      {vector::TransposeOp::getOperationName(), vector_transpose_rule}};
+      {TypeID::get<vector::ShapeCastOp>(), vector_shape_cast_rule},
+      {TypeID::get<vector::StoreOp>(), vector_store_rule},
+      {TypeID::get<vector::TransposeOp>(), vector_transpose_rule}};
   return *rules;
 }
 }  // namespace
@@ -4510,6 +4560,8 @@ Value copy_one_sublane(OpBuilder &builder, Value src_vreg, int src_sl_idx,
 FailureOr<TypedValue<VectorType>> relayout(
     OpBuilder &builder, TypedValue<VectorType> v, VectorLayout src,
     const VectorLayout &dst, const std::array<int64_t, 2> target_shape) {
+  mosaicCompileStats().relayouts_materialized.fetch_add(
+      1, std::memory_order_relaxed);
   const int8_t bitwidth = src.bitwidth();
   if (bitwidth != dst.bitwidth()) {
     return emitError(v.getLoc(), "Can't change bitwidth during a relayout");
@@ -4922,6 +4974,7 @@ FailureOr<TypedValue<VectorType>> relayout(
 // For example, we should verify that ops that were supposed to generate
 // replicated outputs satisfy that requirement.
 LogicalResult applyLayoutOp(RewriteContext &ctx, Operation &op) {
+  mosaicCompileStats().ops_rewritten.fetch_add(1, std::memory_order_relaxed);
   // When an operation does not have any operands, the layout_in tuple is empty.
   // If one of the operands is not of vector type, the corresponding entry in
   // the layout_in tuple will be None. The same applies to the results of the
@@ -4960,10 +5013,27 @@ LogicalResult applyLayoutOp(RewriteContext &ctx, Operation &op) {
       if (lo->generalizes(*li, vty.getShape(), ctx.target_shape)) {
         continue;
       }
-      OpBuilder builder(&op);
-      FAILUREOR_ASSIGN_OR_RETURN(Value new_v,
-                                 relayout(builder, vector_operand, /*src=*/*lo,
-                                          /*dst=*/*li, ctx.target_shape));
+      // The same conversion of a value is often needed by several consumers.
+      // Reuse a previously materialized relayout when it lives in the current
+      // block: ops are rewritten in block order, so the earlier copy is
+      // guaranteed to dominate this use.
+      Value new_v;
+      for (const auto &[cached_dst, cached_v] :
+           ctx.relayout_cache.lookup(vector_operand)) {
+        if (cached_dst == *li && cached_v.getParentBlock() == op.getBlock()) {
+          new_v = cached_v;
+          mosaicCompileStats().relayout_cache_hits.fetch_add(
+              1, std::memory_order_relaxed);
+          break;
+        }
+      }
+      if (!new_v) {
+        OpBuilder builder(&op);
+        FAILUREOR_ASSIGN_OR_RETURN(
+            new_v, relayout(builder, vector_operand, /*src=*/*lo,
+                            /*dst=*/*li, ctx.target_shape));
+        ctx.relayout_cache[vector_operand].emplace_back(*li, new_v);
+      }
       op.setOperand(idx, new_v);
     }
   }
@@ -4983,9 +5053,9 @@ LogicalResult applyLayoutOp(RewriteContext &ctx, Operation &op) {
     }
     return success();
   }
-  if (auto rule_it = rules().find(op.getName().getStringRef());
+  if (auto rule_it = rules().find(op.getName().getTypeID());
       rule_it != rules().end()) {
-    const rule_type &rule = rule_it->getValue();
+    const rule_type &rule = rule_it->second;
     return rule(ctx, op, layouts_in, layouts_out);
   }
   if (OpTrait::hasElementwiseMappableTraits(&op)) {
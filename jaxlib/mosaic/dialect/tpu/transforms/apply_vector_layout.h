@@ -3,8 +3,14 @@
 
 #include <array>
 #include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/Value.h"
@@ -22,6 +28,27 @@ struct RewriteContext {
   const std::array<int64_t, 2> target_shape = {8, 128};
   const std::array<int64_t, 2> mxu_shape = {128, 128};
 
+  // Relayouts already materialized during this rewrite, keyed by the source
+  // value. Each entry lists (dst layout, converted value) pairs, so when the
+  // same conversion of a value is needed by several consumers the emitted
+  // gather/shuffle sequence is shared instead of duplicated per use.
+  llvm::DenseMap<Value, llvm::SmallVector<std::pair<VectorLayout, Value>, 2>>
+      relayout_cache;
+
+  // Out-of-bounds masks (and the neutral-element splats they select against)
+  // already materialized in the function's entry block, keyed by
+  // VRegDataBounds::maskCacheKey. Padded-edge-heavy kernels request the same
+  // mask for thousands of edge vregs; reusing one value per distinct bounds
+  // keeps the emitted IR (and downstream lowering time) from blowing up.
+  std::map<std::vector<int64_t>, Value> mask_cache;
+  llvm::DenseMap<Attribute, Value> neutral_vec_cache;
+
+  // Constants already hoisted into function arguments by appendConstant,
+  // keyed by their (context-uniqued) attribute. Hoisting the same constant
+  // twice would duplicate the argument and the host-side marshalling that
+  // goes with it.
+  llvm::DenseMap<Attribute, BlockArgument> hoisted_constants;
+
   MLIRContext *getMLIRContext() { return func.getContext(); }
 };
 
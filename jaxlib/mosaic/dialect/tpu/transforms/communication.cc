@@ -17,12 +17,16 @@ limitations under the License.
 #include <memory>
 #include <utility>
 
+#include "llvm/ADT/SmallVector.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Visitors.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Interfaces/ViewLikeInterface.h"
 #include "mlir/Support/LogicalResult.h"
 #include "jaxlib/mosaic/dialect/tpu/tpu_dialect.h"
 #include "xla/layout.h"
@@ -31,6 +35,11 @@ namespace mlir::tpu {
 
 namespace {
 
+// Discardable attributes caching the result of mightCommunicateBetweenChips.
+// Any pass that introduces or removes communication ops must drop them.
+constexpr StringRef kHasCommunicationAttr = "tpu.cached_has_communication";
+constexpr StringRef kHasCustomBarrierAttr = "tpu.cached_has_custom_barrier";
+
 struct CommsAnalysisState {
   bool has_communication = false;
   bool has_custom_barrier = false;
@@ -62,8 +71,20 @@ void analyzeCrossChipCommunication(mlir::Operation *op,
 }  // namespace
 
 std::pair<bool, bool> mightCommunicateBetweenChips(mlir::Operation *op) {
+  // The Python-driven lowering asks this question repeatedly about the same
+  // unmodified IR, so the walk result is cached on the op itself.
+  auto cached_comms = op->getAttrOfType<BoolAttr>(kHasCommunicationAttr);
+  auto cached_barrier = op->getAttrOfType<BoolAttr>(kHasCustomBarrierAttr);
+  if (cached_comms && cached_barrier) {
+    return std::make_pair(cached_comms.getValue(), cached_barrier.getValue());
+  }
   CommsAnalysisState state;
   analyzeCrossChipCommunication(op, &state);
+  Builder builder(op->getContext());
+  op->setAttr(kHasCommunicationAttr,
+              builder.getBoolAttr(state.has_communication));
+  op->setAttr(kHasCustomBarrierAttr,
+              builder.getBoolAttr(state.has_custom_barrier));
   return std::make_pair(state.has_communication, state.has_custom_barrier);
 }
 
@@ -145,4 +166,110 @@ createLogicalToPhysicalDeviceIdPass(int64_t total_devices) {
   return std::make_unique<LogicalToPhysicalDeviceIdPass>(total_devices);
 }
 
+#define GEN_PASS_DECL_DMAPIPELININGPASS
+#define GEN_PASS_DEF_DMAPIPELININGPASS
+#include "jaxlib/mosaic/dialect/tpu/tpu_passes.h.inc"
+
+namespace {
+
+// Strips memref views to the buffer they ultimately refer to.
+Value rootBuffer(Value ref) {
+  while (auto view = ref.getDefiningOp<ViewLikeOpInterface>()) {
+    ref = view.getViewSource();
+  }
+  return ref;
+}
+
+// Mosaic buffers come from distinct function arguments, allocations, and
+// semaphore ops, so two refs can only overlap when they trace back to the
+// same root buffer.
+bool mayAliasBuffer(Value a, Value b) { return rootBuffer(a) == rootBuffer(b); }
+
+// Returns true if `wait` can be moved below `op` without changing what the
+// program observes: the op runs entirely before the transfer is known to have
+// completed, so it must not touch the transfer's target or its semaphore.
+bool canSinkWaitPast(tpu::WaitDMAOp wait, Operation *op) {
+  if (op->hasTrait<OpTrait::IsTerminator>() || op->getNumRegions() != 0 ||
+      isa<tpu::WaitDMAOp>(op)) {
+    return false;
+  }
+  if (isMemoryEffectFree(op)) {
+    return true;
+  }
+  // Effectful op without the interface (e.g. a call): assume it can touch
+  // anything.
+  if (!isa<MemoryEffectOpInterface>(op)) {
+    return false;
+  }
+  for (Value operand : op->getOperands()) {
+    if (!isa<MemRefType>(operand.getType())) {
+      continue;
+    }
+    if (mayAliasBuffer(operand, wait.getRef()) ||
+        mayAliasBuffer(operand, wait.getSemaphore())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Sinks each tpu.wait_dma in the block as far down as legality and the
+// prefetch depth allow. Moving a wait below the ops that follow it lets
+// those ops (including the next slices' tpu.enqueue_dma) run while the
+// transfer is still in flight; bounding the number of enqueues a wait may
+// pass keeps at most `prefetch_depth` transfers outstanding.
+void pipelineBlock(Block &block, int prefetch_depth) {
+  llvm::SmallVector<tpu::WaitDMAOp> waits;
+  for (Operation &op : block) {
+    if (auto wait = dyn_cast<tpu::WaitDMAOp>(op)) {
+      waits.push_back(wait);
+    }
+  }
+  for (tpu::WaitDMAOp wait : waits) {
+    Operation *dest = nullptr;
+    int passed_enqueues = 0;
+    for (Operation *op = wait->getNextNode(); op != nullptr;
+         op = op->getNextNode()) {
+      if (!canSinkWaitPast(wait, op)) {
+        break;
+      }
+      if (isa<tpu::EnqueueDMAOp>(op)) {
+        // The waited transfer counts as one outstanding DMA; every enqueue
+        // the wait passes adds another.
+        if (passed_enqueues + 1 >= prefetch_depth) {
+          break;
+        }
+        ++passed_enqueues;
+      }
+      dest = op;
+    }
+    if (dest != nullptr) {
+      wait->moveAfter(dest);
+    }
+  }
+}
+
+}  // namespace
+
+struct DmaPipeliningPass : public impl::DmaPipeliningPassBase<DmaPipeliningPass> {
+  explicit DmaPipeliningPass(int prefetch_depth_) {
+    prefetch_depth = prefetch_depth_;
+  }
+
+  void runOnOperation() override {
+    if (prefetch_depth < 1) {
+      signalPassFailure();
+      return;
+    }
+    getOperation().walk([&](Block *block) {
+      pipelineBlock(*block, prefetch_depth);
+    });
+  }
+};
+
+std::unique_ptr<OperationPass<func::FuncOp>> createDmaPipeliningPass(
+    int prefetch_depth) {
+  return std::make_unique<DmaPipeliningPass>(prefetch_depth);
+}
+
 }  // namespace mlir::tpu
@@ -17,8 +17,12 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
@@ -43,14 +47,52 @@ namespace mlir::tpu {
 
 namespace {
 
-using rule_type = std::function<void(Operation *)>;
+// A subwindow access, identified up to the emitted bounds check: two accesses
+// with equal keys in the same block are guarded by the same predicate over the
+// same SSA values, so the check emitted before the first one covers both.
+struct SubwindowCheck {
+  SmallVector<Value, 4> base_indices;
+  SmallVector<int64_t, 4> window_shape;
+  SmallVector<int64_t, 4> full_shape;
+  SmallVector<int32_t, 4> strides;
+
+  bool operator==(const SubwindowCheck &other) const {
+    return base_indices == other.base_indices &&
+           window_shape == other.window_shape &&
+           full_shape == other.full_shape && strides == other.strides;
+  }
+};
+
+// Bounds checks already emitted, per block. Checks are inserted right before
+// the op they guard and the walk visits ops in block order, so an identical
+// check recorded earlier in the same block dominates the current op.
+class SubwindowCheckCache {
+ public:
+  // Returns false if an identical check was already emitted in this block.
+  bool insert(Block *block, SubwindowCheck check) {
+    std::vector<SubwindowCheck> &checks = emitted_[block];
+    if (llvm::is_contained(checks, check)) {
+      return false;
+    }
+    checks.push_back(std::move(check));
+    return true;
+  }
+
+ private:
+  DenseMap<Block *, std::vector<SubwindowCheck>> emitted_;
+};
+
+using rule_type = std::function<void(Operation *, SubwindowCheckCache &)>;
 
 template <typename Op>
-rule_type as_generic_rule(void (*rule)(Op)) {
-  return [rule](const Operation *op) { return rule(cast<Op>(op)); };
+rule_type as_generic_rule(void (*rule)(Op, SubwindowCheckCache &)) {
+  return [rule](const Operation *op, SubwindowCheckCache &cache) {
+    return rule(cast<Op>(op), cache);
+  };
 }
 
-void assertIsValidSubwindow(Operation *op, mlir::ValueRange base_indices,
+void assertIsValidSubwindow(Operation *op, SubwindowCheckCache &cache,
+                            mlir::ValueRange base_indices,
                             ArrayRef<int64_t> window_shape,
                             ArrayRef<int64_t> full_shape,
                             ArrayRef<int32_t> strides = {}) {
@@ -62,8 +104,20 @@ void assertIsValidSubwindow(Operation *op, mlir::ValueRange base_indices,
   if (base_indices.empty()) {
     return;
   }
+  if (!cache.insert(op->getBlock(),
+                    SubwindowCheck{SmallVector<Value, 4>(base_indices),
+                                   SmallVector<int64_t, 4>(window_shape),
+                                   SmallVector<int64_t, 4>(full_shape),
+                                   SmallVector<int32_t, 4>(strides)})) {
+    return;  // An identical check already dominates this op.
+  }
   Type idx_type = base_indices.front().getType();
   ImplicitLocOpBuilder builder(op->getLoc(), op);
+  // The per-dimension conditions are folded into a single assert so that
+  // assert-enabled binaries pay one branch per access rather than one per
+  // dimension. The message no longer names the failing dimension; rerunning
+  // under a debugger with the source location is enough to recover it.
+  Value valid;
   for (auto [dim, access] :
        llvm::enumerate(llvm::zip(base_indices, window_shape, full_shape))) {
     auto [idx, size, bound] = access;
@@ -78,45 +132,47 @@ void assertIsValidSubwindow(Operation *op, mlir::ValueRange base_indices,
                      builder.getIntegerAttr(idx_type, (size - 1) * stride))),
         builder.create<arith::ConstantOp>(
             builder.getIntegerAttr(idx_type, bound)));
-    std::string msg;
-    llvm::raw_string_ostream msg_builder(msg);
-    msg_builder << "Operation " << op->getName().getStringRef().str()
-                << " references out-of-bounds elements in dimension "
-                << std::to_string(dim) << " (source location: " << op->getLoc()
-                << ")";
-    builder.create<cf::AssertOp>(
-        builder.create<arith::AndIOp>(positive, in_bounds), msg);
+    Value dim_valid = builder.create<arith::AndIOp>(positive, in_bounds);
+    valid = valid ? builder.create<arith::AndIOp>(valid, dim_valid).getResult()
+                  : dim_valid;
   }
+  std::string msg;
+  llvm::raw_string_ostream msg_builder(msg);
+  msg_builder << "Operation " << op->getName().getStringRef().str()
+              << " references out-of-bounds elements (source location: "
+              << op->getLoc() << ")";
+  builder.create<cf::AssertOp>(valid, msg);
 }
 
-void vector_load_rule(vector::LoadOp op) {
-  assertIsValidSubwindow(op, op.getIndices(),
+void vector_load_rule(vector::LoadOp op, SubwindowCheckCache &cache) {
+  assertIsValidSubwindow(op, cache, op.getIndices(),
                          /*window_shape=*/op.getVectorType().getShape(),
                          /*full_shape=*/op.getBase().getType().getShape());
 }
 
-void vector_store_rule(vector::StoreOp op) {
-  assertIsValidSubwindow(op, op.getIndices(),
+void vector_store_rule(vector::StoreOp op, SubwindowCheckCache &cache) {
+  assertIsValidSubwindow(op, cache, op.getIndices(),
                          /*window_shape=*/op.getVectorType().getShape(),
                          /*full_shape=*/op.getBase().getType().getShape());
 }
 
-void tpu_memref_slice_rule(tpu::MemRefSliceOp op) {
-  assertIsValidSubwindow(op, op.getBaseIdx(),
+void tpu_memref_slice_rule(tpu::MemRefSliceOp op, SubwindowCheckCache &cache) {
+  assertIsValidSubwindow(op, cache, op.getBaseIdx(),
                          /*window_shape=*/op.getResult().getType().getShape(),
                          /*full_shape=*/op.getMemRef().getType().getShape());
 }
 
-void tpu_strided_load_rule(tpu::StridedLoadOp op) {
-  assertIsValidSubwindow(op, op.getIndices(),
+void tpu_strided_load_rule(tpu::StridedLoadOp op, SubwindowCheckCache &cache) {
+  assertIsValidSubwindow(op, cache, op.getIndices(),
                          /*window_shape=*/op.getResult().getType().getShape(),
                          /*full_shape=*/op.getBase().getType().getShape(),
                          /*strides=*/op.getStrides());
 }
 
-void tpu_strided_store_rule(tpu::StridedStoreOp op) {
+void tpu_strided_store_rule(tpu::StridedStoreOp op,
+                            SubwindowCheckCache &cache) {
   assertIsValidSubwindow(
-      op, op.getIndices(),
+      op, cache, op.getIndices(),
       /*window_shape=*/op.getValueToStore().getType().getShape(),
       /*full_shape=*/op.getBase().getType().getShape(),
       /*strides=*/op.getStrides());
@@ -141,11 +197,12 @@ struct DebugAssertInsertionPass
     : public impl::DebugAssertInsertionPassBase<DebugAssertInsertionPass> {
   void runOnOperation() override {
     func::FuncOp func = getOperation();
-    func.walk([](Operation *op) {
+    SubwindowCheckCache cache;
+    func.walk([&cache](Operation *op) {
       if (auto rule_it = rules().find(op->getName().getStringRef());
           rule_it != rules().end()) {
         const rule_type &rule = rule_it->getValue();
-        rule(op);
+        rule(op, cache);
       }
       return WalkResult::advance();
     });
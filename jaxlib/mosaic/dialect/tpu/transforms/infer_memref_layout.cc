@@ -5,6 +5,7 @@
 #include <cstdlib>
 #include <memory>
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/bit.h"
 #include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
@@ -19,6 +20,7 @@
 #include "mlir/IR/Location.h"
 #include "mlir/IR/Region.h"
 #include "mlir/IR/Value.h"
+#include "mlir/IR/Visitors.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Support/LLVM.h"
 #include "mlir/Support/LogicalResult.h"
@@ -191,12 +193,36 @@ FailureOr<MemRefType> inferMemref(MemRefType memref,
                          memory_space);
 }
 
-LogicalResult inferOp(Operation &op, const int hardware_generation) {
+// Memoizes inferMemref over a pass invocation. Pallas kernels reuse a small
+// set of block shapes, so arguments and allocas frequently share memref
+// types. Keying on the context-uniqued MemRefType is safe because the memo
+// never outlives the pass (and hence the context that uniques the types).
+FailureOr<MemRefType> inferMemrefCached(
+    MemRefType memref, const int hardware_generation,
+    DenseMap<MemRefType, MemRefType> &memo) {
+  if (auto it = memo.find(memref); it != memo.end()) {
+    return it->second;
+  }
+  FAILUREOR_ASSIGN_OR_RETURN(const MemRefType new_memref,
+                             inferMemref(memref, hardware_generation));
+  memo.insert({memref, new_memref});
+  return new_memref;
+}
+
+// Returns true if the memref type already carries a tiled layout and an
+// explicit memory space, i.e. it has been through inference before.
+bool isAnnotated(MemRefType ty) {
+  return isa<TiledLayoutAttr>(ty.getLayout()) && ty.getMemorySpace() != nullptr;
+}
+
+LogicalResult inferOp(Operation &op, const int hardware_generation,
+                      DenseMap<MemRefType, MemRefType> &memo) {
   if (auto alloca_op = dyn_cast<memref::AllocaOp>(op)) {
     TypedValue<MemRefType> arg = alloca_op.getResult();
     const MemRefType memref_ty = alloca_op.getResult().getType();
-    FAILUREOR_ASSIGN_OR_RETURN(const MemRefType new_memref_ty,
-                               inferMemref(memref_ty, hardware_generation));
+    FAILUREOR_ASSIGN_OR_RETURN(
+        const MemRefType new_memref_ty,
+        inferMemrefCached(memref_ty, hardware_generation, memo));
     alloca_op.getResult().setType(new_memref_ty);
     if (memref_ty != new_memref_ty) {
       OpBuilder builder(alloca_op->getContext());
@@ -211,8 +237,9 @@ LogicalResult inferOp(Operation &op, const int hardware_generation) {
   } else if (auto alloca_op = dyn_cast<tpu::AllocaSemaphoreOp>(op)) {
     TypedValue<MemRefType> arg = alloca_op.getResult();
     const MemRefType memref_ty = alloca_op.getResult().getType();
-    FAILUREOR_ASSIGN_OR_RETURN(const MemRefType new_memref_ty,
-                               inferMemref(memref_ty, hardware_generation));
+    FAILUREOR_ASSIGN_OR_RETURN(
+        const MemRefType new_memref_ty,
+        inferMemrefCached(memref_ty, hardware_generation, memo));
     alloca_op.getResult().setType(new_memref_ty);
     if (memref_ty != new_memref_ty) {
       OpBuilder builder(alloca_op->getContext());
@@ -228,7 +255,7 @@ LogicalResult inferOp(Operation &op, const int hardware_generation) {
   for (Region &region : op.getRegions()) {
     for (Block &block : region) {
       for (Operation& op : block) {
-        if (failed(inferOp(op, hardware_generation))) {
+        if (failed(inferOp(op, hardware_generation, memo))) {
           return failure();
         }
       }
@@ -237,10 +264,40 @@ LogicalResult inferOp(Operation &op, const int hardware_generation) {
   return success();
 }
 
-LogicalResult inferFunc(func::FuncOp f, const int hardware_generation) {
+// Returns true if the function has already been through layout inference,
+// i.e. all of its memref arguments and allocations carry layout annotations.
+// This happens e.g. when a module recovered from a compilation cache is
+// lowered again.
+bool alreadyInferred(func::FuncOp f) {
+  for (BlockArgument arg : f.getArguments()) {
+    if (auto memref_ty = dyn_cast<MemRefType>(arg.getType());
+        memref_ty && !isAnnotated(memref_ty)) {
+      return false;
+    }
+  }
+  const WalkResult result = f.walk([](Operation *op) {
+    MemRefType memref_ty;
+    if (auto alloca_op = dyn_cast<memref::AllocaOp>(op)) {
+      memref_ty = alloca_op.getResult().getType();
+    } else if (auto alloca_op = dyn_cast<tpu::AllocaSemaphoreOp>(op)) {
+      memref_ty = alloca_op.getResult().getType();
+    } else {
+      return WalkResult::advance();
+    }
+    return isAnnotated(memref_ty) ? WalkResult::advance()
+                                  : WalkResult::interrupt();
+  });
+  return !result.wasInterrupted();
+}
+
+LogicalResult inferFunc(func::FuncOp f, const int hardware_generation,
+                        DenseMap<MemRefType, MemRefType> &memo) {
   if (!f.getBody().hasOneBlock()) {
     return f.emitOpError("Functions should only have a single block");
   }
+  if (alreadyInferred(f)) {
+    return success();
+  }
   Block &entry = f.getBody().front();
   SmallVector<Type> new_arg_types;
   auto builder = OpBuilder::atBlockBegin(&entry);
@@ -250,8 +307,9 @@ LogicalResult inferFunc(func::FuncOp f, const int hardware_generation) {
       new_arg_types.push_back(arg.getType());
       continue;
     }
-    FAILUREOR_ASSIGN_OR_RETURN(const MemRefType new_memref_ty,
-                               inferMemref(memref_ty, hardware_generation));
+    FAILUREOR_ASSIGN_OR_RETURN(
+        const MemRefType new_memref_ty,
+        inferMemrefCached(memref_ty, hardware_generation, memo));
     arg.setType(new_memref_ty);
     new_arg_types.push_back(arg.getType());
     if (memref_ty != new_memref_ty) {
@@ -270,7 +328,7 @@ LogicalResult inferFunc(func::FuncOp f, const int hardware_generation) {
   f.setFunctionType(
       builder.getAttr<FunctionType>(new_arg_types, f.getResultTypes()));
   for (Operation &op : entry.getOperations()) {
-    if (failed(inferOp(op, hardware_generation))) {
+    if (failed(inferOp(op, hardware_generation, memo))) {
       return failure();
     }
   }
@@ -287,12 +345,13 @@ LogicalResult inferFunc(func::FuncOp f, const int hardware_generation) {
 //   hardware_generation: The TPU hardware generation to target.
 LogicalResult inferModule(ModuleOp module, const int hardware_generation) {
   // TODO(apaszke): Do layout assignment for scoped allocations too.
+  DenseMap<MemRefType, MemRefType> memo;
   for (Operation &op : *module.getBody()) {
     auto f = dyn_cast<func::FuncOp>(op);
     if (f == nullptr) {
       return module.emitOpError("Expected only FuncOps but found ") << op;
     }
-    if (failed(inferFunc(f, hardware_generation))) {
+    if (failed(inferFunc(f, hardware_generation, memo))) {
       return failure();
     }
   }
@@ -311,11 +370,15 @@ struct InferMemRefLayoutPass
       return;
     }
     func::FuncOp func = getOperation();
-    if (failed(inferFunc(func, hardware_generation))) {
+    if (failed(inferFunc(func, hardware_generation, inferred_memrefs_))) {
       signalPassFailure();
       return;
     }
   }
+
+  // Persists across the functions processed by this pass instance, so kernels
+  // that reuse the same block shapes share the inference work.
+  DenseMap<MemRefType, MemRefType> inferred_memrefs_;
 };
 
 std::unique_ptr<OperationPass<func::FuncOp>> createInferMemRefLayoutPass(
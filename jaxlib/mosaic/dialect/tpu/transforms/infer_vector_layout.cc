@@ -16,6 +16,8 @@ limitations under the License.
 #include <algorithm>
 #include <array>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -25,8 +27,11 @@ limitations under the License.
 #include <utility>
 #include <variant>
 
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVectorExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/SHA256.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/ControlFlow/IR/ControlFlowOps.h"
@@ -137,200 +142,275 @@ class VectorLayoutInferer {
           return failure();
         }
       }
-      bool has_vector_io = false;
-      for (auto op : any_op.getOperands()) {
-        has_vector_io |= op.getType().isa<VectorType>();
+      if (inferOp(any_op).failed()) {
+        return failure();
       }
-      for (auto r : any_op.getResults()) {
-        has_vector_io |= r.getType().isa<VectorType>();
+      CHECK(any_op.getNumResults() == 0 || any_op.hasAttr("out_layout"));
+      CHECK(any_op.getNumOperands() == 0 || any_op.hasAttr("in_layout"));
+    }
+    return match_terminator(block.getTerminator());
+  }
+
+  // Re-infers a block whose argument layouts may have changed since the last
+  // pass over it. Only ops reachable from a changed layout through use-def
+  // chains are revisited; all other ops keep the layouts they already carry,
+  // which remain valid because inference rules depend only on operand layouts
+  // and on properties (types, user op kinds) that re-inference cannot change.
+  LogicalResult reinferBlock(
+      Block &block, ArrayRef<Layout> arg_layouts,
+      const std::function<LogicalResult(Operation *)> &match_terminator) {
+    auto parent_op = block.getParentOp();
+    if (arg_layouts.size() != block.getNumArguments()) {
+      return parent_op->emitOpError(
+          "Block arguments must have the same number of layouts");
+    }
+    // Values whose layout differs from the previous pass.
+    DenseSet<Value> changed;
+    // Update the assume_layout stubs in place: downstream ops observe the new
+    // argument layouts through them.
+    for (auto [iter_arg, layout] :
+         llvm::zip_equal(block.getArguments(), arg_layouts)) {
+      if (!dyn_cast<VectorType>(iter_arg.getType())) {
+        continue;
       }
-      if (!has_vector_io && any_op.getRegions().empty()) {
-        SmallVector<Layout, 4> in_layout(any_op.getNumOperands(), kNoLayout);
-        if (any_op.getNumResults() == 0) {
-          setInLayout(&any_op, in_layout);
-        } else if (any_op.getNumResults() == 1) {
-          setLayout(&any_op, in_layout, kNoLayout);
-        } else {
-          any_op.emitOpError("Multi-result ops not supported");
-          return failure();
-        }
-      } else if (isa<arith::ExtFOp, arith::ExtSIOp>(any_op)) {
-        if (inferExt(&any_op).failed()) {
-          return failure();
-        }
-      } else if (isa<arith::TruncFOp, arith::TruncIOp>(any_op)) {
-        if (inferTrunc(&any_op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<arith::SelectOp>(any_op)) {
-        auto true_ty = dyn_cast<VectorType>(op.getTrueValue().getType());
-        auto false_ty = dyn_cast<VectorType>(op.getFalseValue().getType());
-        TPU_CHECK_OP(static_cast<bool>(true_ty) == static_cast<bool>(false_ty),
-                     "Only one side of arith is a vector?");
-        if (true_ty) {
-          TPU_CHECK_OP(true_ty.getElementTypeBitWidth() == kNativeBitwidth &&
-                           false_ty.getElementTypeBitWidth() == kNativeBitwidth,
-                       "Only 32-bit select supported");
-        }
-        if (inferElementwise(&any_op, /*check_bitwidth=*/false).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<arith::ExtUIOp>(any_op)) {
-        auto in_ty = dyn_cast<VectorType>(op.getIn().getType());
-        auto out_ty = dyn_cast<VectorType>(op.getType());
-        TPU_CHECK_OP(static_cast<bool>(in_ty) == static_cast<bool>(out_ty),
-                     "Input and output are not both vectors?");
-        if (in_ty) {
-          TPU_CHECK_OP(in_ty.getElementTypeBitWidth() == 1,
-                       "Only extending i1 is supported");
-        }
-        if (inferElementwise(&any_op, /*check_bitwidth=*/false).failed()) {
-          return failure();
-        }
-      } else if (isa<arith::CmpIOp>(any_op) || isa<arith::CmpFOp>(any_op)) {
-        Operation *op = &any_op;  // For TPU_CHECK_OP macros, which use the `op`
-                                  // variable in scope
-        auto lhs_ty = dyn_cast<VectorType>(any_op.getOperand(0).getType());
-        auto rhs_ty = dyn_cast<VectorType>(any_op.getOperand(1).getType());
-        TPU_CHECK_OP(static_cast<bool>(lhs_ty) == static_cast<bool>(rhs_ty),
-                     "Only one side of cmp is a vector?");
-        // TODO(tlongeri): Check that TPU generation supports comparison.
-        if (inferElementwise(&any_op, /*check_bitwidth=*/false).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<arith::ConstantOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<cf::AssertOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<memref::LoadOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<scf::IfOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<scf::ForOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<scf::WhileOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::RotateOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::ConcatenateOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::LoadOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::StoreOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::StridedLoadOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::StridedStoreOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::MatmulOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::EraseLayoutOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::IotaOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::GatherOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::BitcastOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::RepeatOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::TraceOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::PRNGRandomBitsOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<tpu::RegionOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<vector::BroadcastOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<vector::ContractionOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<vector::ExtractOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<vector::LoadOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<vector::MultiDimReductionOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<vector::ShapeCastOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
-        }
-      } else if (auto op = dyn_cast<vector::StoreOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
+      for (Operation *user : iter_arg.getUsers()) {
+        auto assume_op = dyn_cast<tpu::AssumeLayoutOp>(user);
+        if (!assume_op) {
+          continue;
         }
-      } else if (auto op = dyn_cast<vector::TransposeOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
+        if (getLayout(assume_op.getResult()) != layout) {
+          setLayout(assume_op, layout, layout);
+          changed.insert(assume_op.getResult());
         }
-      } else if (auto op = dyn_cast<vector::ExtractStridedSliceOp>(any_op)) {
-        if (infer(op).failed()) {
-          return failure();
+      }
+    }
+    for (Operation &any_op : block.without_terminator()) {
+      if (isa<tpu::AssumeLayoutOp>(any_op)) {
+        continue;
+      }
+      if (llvm::none_of(any_op.getOperands(),
+                        [&](Value v) { return changed.contains(v); })) {
+        continue;
+      }
+      VLOG(kLayoutLog) << "reinfer: " << Print(&any_op);
+      SmallVector<Layout, 4> old_out_layouts;
+      if (any_op.getNumResults() != 0) {
+        old_out_layouts = getOutLayout(&any_op);
+      }
+      any_op.removeAttr("in_layout");
+      any_op.removeAttr("out_layout");
+      // Nested regions were inferred against the old operand layouts, so they
+      // get a full re-inference along with their parent.
+      for (Region &region : any_op.getRegions()) {
+        for (Block &region_block : region) {
+          clearBlockLayouts(region_block);
         }
-      } else if (OpTrait::hasElementwiseMappableTraits(&any_op)) {
-        // We put elementwise rule to the end in case the overriding rule.
-        if (inferElementwise(&any_op).failed()) {
-          return failure();
+      }
+      if (inferOp(any_op).failed()) {
+        return failure();
+      }
+      for (auto [result, old_layout] :
+           llvm::zip_equal(any_op.getResults(), old_out_layouts)) {
+        if (getLayout(result) != old_layout) {
+          changed.insert(result);
         }
+      }
+    }
+    return match_terminator(block.getTerminator());
+  }
+
+  LogicalResult inferOp(Operation &any_op) {
+    bool has_vector_io = false;
+    for (auto op : any_op.getOperands()) {
+      has_vector_io |= op.getType().isa<VectorType>();
+    }
+    for (auto r : any_op.getResults()) {
+      has_vector_io |= r.getType().isa<VectorType>();
+    }
+    if (!has_vector_io && any_op.getRegions().empty()) {
+      SmallVector<Layout, 4> in_layout(any_op.getNumOperands(), kNoLayout);
+      if (any_op.getNumResults() == 0) {
+        setInLayout(&any_op, in_layout);
+      } else if (any_op.getNumResults() == 1) {
+        setLayout(&any_op, in_layout, kNoLayout);
       } else {
-        any_op.emitOpError("unsupported in vector layout inference");
+        any_op.emitOpError("Multi-result ops not supported");
         return failure();
       }
-      CHECK(any_op.getNumResults() == 0 || any_op.hasAttr("out_layout"));
-      CHECK(any_op.getNumOperands() == 0 || any_op.hasAttr("in_layout"));
+    } else if (isa<arith::ExtFOp, arith::ExtSIOp>(any_op)) {
+      if (inferExt(&any_op).failed()) {
+        return failure();
+      }
+    } else if (isa<arith::TruncFOp, arith::TruncIOp>(any_op)) {
+      if (inferTrunc(&any_op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<arith::SelectOp>(any_op)) {
+      auto true_ty = dyn_cast<VectorType>(op.getTrueValue().getType());
+      auto false_ty = dyn_cast<VectorType>(op.getFalseValue().getType());
+      TPU_CHECK_OP(static_cast<bool>(true_ty) == static_cast<bool>(false_ty),
+                   "Only one side of arith is a vector?");
+      if (true_ty) {
+        TPU_CHECK_OP(true_ty.getElementTypeBitWidth() == kNativeBitwidth &&
+                         false_ty.getElementTypeBitWidth() == kNativeBitwidth,
+                     "Only 32-bit select supported");
+      }
+      if (inferElementwise(&any_op, /*check_bitwidth=*/false).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<arith::ExtUIOp>(any_op)) {
+      auto in_ty = dyn_cast<VectorType>(op.getIn().getType());
+      auto out_ty = dyn_cast<VectorType>(op.getType());
+      TPU_CHECK_OP(static_cast<bool>(in_ty) == static_cast<bool>(out_ty),
+                   "Input and output are not both vectors?");
+      if (in_ty) {
+        TPU_CHECK_OP(in_ty.getElementTypeBitWidth() == 1,
+                     "Only extending i1 is supported");
+      }
+      if (inferElementwise(&any_op, /*check_bitwidth=*/false).failed()) {
+        return failure();
+      }
+    } else if (isa<arith::CmpIOp>(any_op) || isa<arith::CmpFOp>(any_op)) {
+      Operation *op = &any_op;  // For TPU_CHECK_OP macros, which use the `op`
+                                // variable in scope
+      auto lhs_ty = dyn_cast<VectorType>(any_op.getOperand(0).getType());
+      auto rhs_ty = dyn_cast<VectorType>(any_op.getOperand(1).getType());
+      TPU_CHECK_OP(static_cast<bool>(lhs_ty) == static_cast<bool>(rhs_ty),
+                   "Only one side of cmp is a vector?");
+      // TODO(tlongeri): Check that TPU generation supports comparison.
+      if (inferElementwise(&any_op, /*check_bitwidth=*/false).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<arith::ConstantOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<cf::AssertOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<memref::LoadOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<scf::IfOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<scf::ForOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<scf::WhileOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::RotateOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::ConcatenateOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::LoadOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::StoreOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::StridedLoadOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::StridedStoreOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::MatmulOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::EraseLayoutOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::IotaOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::GatherOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::BitcastOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::RepeatOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::TraceOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::PRNGRandomBitsOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<tpu::RegionOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::BroadcastOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::ContractionOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::ExtractOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::LoadOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::MultiDimReductionOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::ShapeCastOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::StoreOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::TransposeOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (auto op = dyn_cast<vector::ExtractStridedSliceOp>(any_op)) {
+      if (infer(op).failed()) {
+        return failure();
+      }
+    } else if (OpTrait::hasElementwiseMappableTraits(&any_op)) {
+      // We put elementwise rule to the end in case the overriding rule.
+      if (inferElementwise(&any_op).failed()) {
+        return failure();
+      }
+    } else {
+      any_op.emitOpError("unsupported in vector layout inference");
+      return failure();
     }
-    return match_terminator(block.getTerminator());
+    return success();
   }
 
   LogicalResult infer(arith::ConstantOp op) {
@@ -570,14 +650,11 @@ class VectorLayoutInferer {
       // Terminator in the loop will carry layouts to the next loop but
       // the loop's block args' layouts are determined by the initial inputs. We
       // need to force the same layouts for all in order to make layouts be
-      // consistent across all branches. To ensure that, we need to reprocess
-      // layout inference for the entire body with the final consolidated
-      // layout.
-      clearBlockLayouts(*op.getBody());
-      if (assumeLayoutsForBlockArgs(*op.getBody(),
-                                    ArrayRef<Layout>(in_layouts).drop_front(2))
-              .failed() ||
-          inferBlock(*op.getBody(), match_yield).failed()) {
+      // consistent across all branches. Only ops downstream of an argument
+      // whose layout actually changed are revisited.
+      if (reinferBlock(*op.getBody(),
+                       ArrayRef<Layout>(in_layouts).drop_front(2), match_yield)
+              .failed()) {
         return op.emitOpError(
             "failed to infer layout with compatible layouts for body in "
             "scf.for op");
@@ -682,23 +759,18 @@ class VectorLayoutInferer {
       ++out_idx;
     }
     if (require_reinfer) {
-      clearBlockLayouts(*op.getBeforeBody());
-      clearBlockLayouts(*op.getAfterBody());
       // Terminator in the loop will carry layouts to the next loop but
       // the loop's block args' layouts are determined by the initial inputs. We
       // need to force the same layouts for all in order to make layouts be
-      // consistent across all branches. To ensure that, we need to reprocess
-      // layout inference for the entire body with the final consolidated
-      // layout.
-      if (assumeLayoutsForBlockArgs(*op.getBeforeBody(), out_layouts)
-              .failed() ||
-          inferBlock(*op.getBeforeBody(), match_condition).failed()) {
+      // consistent across all branches. Only ops downstream of an argument
+      // whose layout actually changed are revisited.
+      if (reinferBlock(*op.getBeforeBody(), out_layouts, match_condition)
+              .failed()) {
         return op.emitOpError(
             "failed to infer layout with compatible layouts for before body in "
             "scf.while op");
       }
-      if (assumeLayoutsForBlockArgs(*op.getAfterBody(), out_layouts).failed() ||
-          inferBlock(*op.getAfterBody(), match_yield).failed()) {
+      if (reinferBlock(*op.getAfterBody(), out_layouts, match_yield).failed()) {
         return op.emitOpError(
             "failed to infer layout with compatible layouts for after body in "
             "scf.while op");
@@ -2010,6 +2082,32 @@ class VectorLayoutInferer {
   static constexpr int8_t kNativeBitwidth = 32;
 };
 
+// Incremental inference support. When enabled, every successfully inferred
+// function is stamped with a fingerprint of its printed form (which includes
+// the inferred layout attributes). Modules that round-trip through the Mosaic
+// serde machinery keep both the attributes and the stamp, so a recompile of an
+// unchanged function can skip inference entirely; any edit changes the printed
+// form and invalidates the stamp. Freshly traced functions carry no stamp and
+// always get full inference.
+constexpr StringRef kLayoutFingerprintAttrName = "tpu.layout_fingerprint";
+
+bool incrementalInferenceEnabled() {
+  static const bool enabled = []() {
+    const char *env = std::getenv("MOSAIC_INCREMENTAL_LAYOUT_INFERENCE");
+    return env != nullptr && strcmp(env, "0") != 0;
+  }();
+  return enabled;
+}
+
+std::string fingerprintFunc(func::FuncOp func) {
+  std::string printed;
+  llvm::raw_string_ostream os(printed);
+  func.print(os);
+  llvm::SHA256 hasher;
+  hasher.update(printed);
+  return llvm::toHex(hasher.final());
+}
+
 struct InferVectorLayoutPass
     : public impl::InferVectorLayoutPassBase<InferVectorLayoutPass> {
   InferVectorLayoutPass(int lane_count, int sublane_count) {
@@ -2018,9 +2116,28 @@ struct InferVectorLayoutPass
   }
   void runOnOperation() override {
     func::FuncOp func = getOperation();
+    if (incrementalInferenceEnabled()) {
+      const auto stamp =
+          func->getAttrOfType<StringAttr>(kLayoutFingerprintAttrName);
+      if (stamp) {
+        // The stamp is excluded from its own hash.
+        func->removeAttr(kLayoutFingerprintAttrName);
+        if (stamp.getValue() == fingerprintFunc(func)) {
+          // Unchanged since the last successful inference, so the layout
+          // attributes it already carries are still valid.
+          func->setAttr(kLayoutFingerprintAttrName, stamp);
+          return;
+        }
+      }
+    }
     VectorLayoutInferer run({sublane_count, lane_count});
     if (run.infer(func).failed()) {
       signalPassFailure();
+      return;
+    }
+    if (incrementalInferenceEnabled()) {
+      func->setAttr(kLayoutFingerprintAttrName,
+                    StringAttr::get(func.getContext(), fingerprintFunc(func)));
     }
   }
 };
@@ -13,6 +13,9 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <memory>
 #include <utility>
 
@@ -34,6 +37,7 @@ limitations under the License.
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"
 #include "mlir/include/mlir/IR/BuiltinTypeInterfaces.h"
 #include "mlir/include/mlir/IR/BuiltinTypes.h"
+#include "mlir/include/mlir/IR/Diagnostics.h"
 #include "mlir/include/mlir/IR/DialectRegistry.h"
 #include "mlir/include/mlir/IR/Matchers.h"
 #include "mlir/include/mlir/IR/Operation.h"
@@ -54,6 +58,33 @@ namespace mlir::tpu {
 #include "jaxlib/mosaic/dialect/tpu/tpu_passes.h.inc"
 
 namespace {
+
+// Wraps a pattern defined in this file with the per-pattern statistics from
+// tpu_dialect.cc, so unpredictable fixpoint runtimes can be attributed to a
+// specific pattern. OpT is the pattern's root op (or Operation * for generic
+// RewritePatterns). Patterns pulled in from upstream populate* helpers are
+// not attributed.
+template <typename OpT, typename PatternT>
+struct Counted : public PatternT {
+  using PatternT::PatternT;
+
+  LogicalResult matchAndRewrite(OpT op,
+                                PatternRewriter &rewriter) const override {
+    MosaicPatternStats &stats = mosaicPatternStats(this->getDebugName());
+    stats.matches.fetch_add(1, std::memory_order_relaxed);
+    const auto start = std::chrono::steady_clock::now();
+    const LogicalResult result = PatternT::matchAndRewrite(op, rewriter);
+    stats.time_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count(),
+                            std::memory_order_relaxed);
+    if (succeeded(result)) {
+      stats.rewrites.fetch_add(1, std::memory_order_relaxed);
+    }
+    return result;
+  }
+};
+
 struct VectorizationPattern
     : public OpInterfaceRewritePattern<linalg::LinalgOp> {
   using OpInterfaceRewritePattern<linalg::LinalgOp>::OpInterfaceRewritePattern;
@@ -432,7 +463,7 @@ struct LinalgVectorizationPass
     MLIRContext *ctx = func.getContext();
 
     RewritePatternSet patterns(ctx);
-    patterns.add<VectorizationPattern>(ctx);
+    patterns.add<Counted<linalg::LinalgOp, VectorizationPattern>>(ctx);
     // Pull in patterns to shuffle broadcast/transpose ops around in order to
     // cancel them or embed into contract ops. Embedding in the flexible
     // contract ops will help to sustain the structure through various
@@ -442,9 +473,12 @@ struct LinalgVectorizationPass
     vector::populateVectorTransferPermutationMapLoweringPatterns(patterns);
     vector::TransferReadOp::getCanonicalizationPatterns(patterns, ctx);
     vector::TransferWriteOp::getCanonicalizationPatterns(patterns, ctx);
-    patterns.add<TransferReadOfCmpI, TransferReadOfCollapseShape,
-                 TransferReadOfConstant, TransferReadOfExpandShape,
-                 TransferReadOfSelect, TransferReadOfSplat>(ctx);
+    patterns.add<Counted<vector::TransferReadOp, TransferReadOfCmpI>,
+                 Counted<vector::TransferReadOp, TransferReadOfCollapseShape>,
+                 Counted<vector::TransferReadOp, TransferReadOfConstant>,
+                 Counted<vector::TransferReadOp, TransferReadOfExpandShape>,
+                 Counted<vector::TransferReadOp, TransferReadOfSelect>,
+                 Counted<vector::TransferReadOp, TransferReadOfSplat>>(ctx);
     // Pull in patterns to convert bf16 ops to f32 ops.
     for (::llvm::StringLiteral unary_op_name :
          {arith::NegFOp::getOperationName(), math::TanhOp::getOperationName(),
@@ -454,8 +488,8 @@ struct LinalgVectorizationPass
           math::LogOp::getOperationName(), math::Log1pOp::getOperationName(),
           math::RoundOp::getOperationName(),
           math::RoundEvenOp::getOperationName()}) {
-      patterns.add<GenericBitwidthConvert>(unary_op_name, ctx,
-                                           supports_bf16_alu_instructions);
+      patterns.add<Counted<Operation *, GenericBitwidthConvert>>(
+          unary_op_name, ctx, supports_bf16_alu_instructions);
     }
     for (::llvm::StringLiteral binary_op_name :
          {arith::MulFOp::getOperationName(), arith::DivFOp::getOperationName(),
@@ -463,15 +497,16 @@ struct LinalgVectorizationPass
           arith::MaximumFOp::getOperationName(),
           arith::MinimumFOp::getOperationName(),
           math::PowFOp::getOperationName()}) {
-      patterns.add<GenericBitwidthConvert>(binary_op_name, ctx,
-                                           supports_bf16_alu_instructions);
+      patterns.add<Counted<Operation *, GenericBitwidthConvert>>(
+          binary_op_name, ctx, supports_bf16_alu_instructions);
     }
     for (::llvm::StringLiteral ternary_op_name :
          {arith::SelectOp::getOperationName()}) {
-      patterns.add<GenericBitwidthConvert>(ternary_op_name, ctx,
-                                           supports_bf16_alu_instructions);
+      patterns.add<Counted<Operation *, GenericBitwidthConvert>>(
+          ternary_op_name, ctx, supports_bf16_alu_instructions);
     }
-    patterns.add<ContractionBitwidthConvert>(supports_bf16_matmul, ctx);
+    patterns.add<Counted<vector::ContractionOp, ContractionBitwidthConvert>>(
+        supports_bf16_matmul, ctx);
 
     // We do not want to apply the vector patterns above to the ops that are
     // unrelated to the original linalg op.
@@ -484,7 +519,23 @@ struct LinalgVectorizationPass
         linalgOps.push_back(op);
       }
     });
-    if (failed(applyOpPatternsAndFold(linalgOps, std::move(patterns)))) {
+    GreedyRewriteConfig config;
+    // The driver's default iteration bound is generous; when debugging a
+    // non-converging fixpoint it helps to fail fast and inspect the
+    // per-pattern statistics in the diagnostic below.
+    if (const char *bound =
+            std::getenv("MOSAIC_LINALG_VECTORIZE_MAX_ITERATIONS");
+        bound != nullptr && std::atoi(bound) > 0) {
+      config.maxIterations = std::atoi(bound);
+    }
+    if (failed(applyOpPatternsAndFold(linalgOps, std::move(patterns), config))) {
+      InFlightDiagnostic diag = func.emitError(
+          "linalg vectorization failed to converge within the iteration bound");
+      for (const auto &[name, matches, rewrites, time_ns] :
+           snapshotMosaicPatternStats()) {
+        diag.attachNote() << name << ": " << rewrites << " rewrites / "
+                          << matches << " matches, " << time_ns << " ns";
+      }
       return signalPassFailure();
     }
   }
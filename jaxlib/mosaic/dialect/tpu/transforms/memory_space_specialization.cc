@@ -13,13 +13,23 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
 #include "absl/log/check.h"
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/include/mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/include/mlir/IR/Attributes.h"
 #include "mlir/include/mlir/IR/BuiltinTypes.h"
 #include "mlir/include/mlir/IR/Value.h"
 #include "mlir/include/mlir/Support/LLVM.h"
 #include "mlir/include/mlir/Support/LogicalResult.h"
 #include "jaxlib/mosaic/dialect/tpu/tpu_dialect.h"
+#include "jaxlib/mosaic/dialect/tpu/transforms/infer_memref_layout.h"
 
 namespace mlir {
 namespace tpu {
@@ -95,5 +105,159 @@ LogicalResult specializeMemorySpace(TypedValue<MemRefType> value,
   return success();
 }
 
+#define GEN_PASS_DECL_ASSIGNMEMORYSPACESPASS
+#define GEN_PASS_DEF_ASSIGNMEMORYSPACESPASS
+#include "jaxlib/mosaic/dialect/tpu/tpu_passes.h.inc"
+
+namespace {
+
+// Trip count assumed for loops whose bounds are not compile-time constants.
+// It only needs to rank buffers against each other, not predict runtime.
+constexpr int64_t kAssumedDynamicTripCount = 128;
+
+// VMEM usable by kernel buffers per core. All supported generations expose
+// 16 MiB; the vmem_budget_bytes pass option overrides this, e.g. to reserve
+// headroom for the vector temporaries the later passes materialize.
+int64_t vmemCapacityBytes(int hardware_generation) {
+  return int64_t{16} << 20;
+}
+
+std::optional<int64_t> constantTripCount(scf::ForOp op) {
+  std::optional<int64_t> lb = getConstantIntValue(op.getLowerBound());
+  std::optional<int64_t> ub = getConstantIntValue(op.getUpperBound());
+  std::optional<int64_t> step = getConstantIntValue(op.getStep());
+  if (!lb || !ub || !step || *step <= 0 || *ub <= *lb) {
+    return std::nullopt;
+  }
+  return (*ub - *lb + *step - 1) / *step;
+}
+
+// Product of the (estimated) trip counts of the loops enclosing `op`.
+int64_t loopWeight(Operation* op) {
+  int64_t weight = 1;
+  for (Operation* parent = op->getParentOp(); parent != nullptr;
+       parent = parent->getParentOp()) {
+    if (auto for_op = dyn_cast<scf::ForOp>(parent)) {
+      weight *= constantTripCount(for_op).value_or(kAssumedDynamicTripCount);
+    } else if (isa<scf::WhileOp>(parent)) {
+      weight *= kAssumedDynamicTripCount;
+    }
+    // Saturate; ranking does not benefit from precision beyond this.
+    if (weight >= (int64_t{1} << 20)) {
+      return int64_t{1} << 20;
+    }
+  }
+  return weight;
+}
+
+// Sums the loop-weighted use count of `value`, following the view-like ops
+// through which memory space also propagates.
+int64_t accessFrequency(Value value) {
+  int64_t frequency = 0;
+  for (Operation* user : value.getUsers()) {
+    if (isa<tpu::MemRefSliceOp, tpu::MemRefSqueezeOp, tpu::EraseLayoutOp>(
+            user)) {
+      frequency += accessFrequency(user->getResult(0));
+    } else {
+      frequency += loopWeight(user);
+    }
+  }
+  return frequency;
+}
+
+// Size the buffer will occupy in VMEM, i.e. after layout inference pads its
+// tiled dimensions. Returns nullopt for shapes that cannot go to VMEM.
+std::optional<int64_t> vmemBufferBytes(MemRefType ty, int hardware_generation) {
+  if (!ty.hasStaticShape() || !ty.getElementType().isIntOrFloat()) {
+    return std::nullopt;
+  }
+  ArrayRef<int64_t> shape = ty.getShape();
+  FailureOr<MemRefType> inferred = inferMemref(
+      MemRefType::get(shape, ty.getElementType()), hardware_generation);
+  if (succeeded(inferred)) {
+    shape = inferred->getShape();
+  }
+  int64_t elements = 1;
+  for (int64_t dim : shape) {
+    elements *= dim;
+  }
+  return elements * ty.getElementType().getIntOrFloatBitWidth() / 8;
+}
+
+struct BufferPlacement {
+  TypedValue<MemRefType> value;
+  int64_t bytes;
+  int64_t frequency;
+};
+
+}  // namespace
+
+struct AssignMemorySpacesPass
+    : public impl::AssignMemorySpacesPassBase<AssignMemorySpacesPass> {
+  AssignMemorySpacesPass(int hardware_generation_,
+                         int64_t vmem_budget_bytes_) {
+    hardware_generation = hardware_generation_;
+    vmem_budget_bytes = vmem_budget_bytes_;
+  }
+
+  void runOnOperation() override {
+    func::FuncOp func = getOperation();
+    if (hardware_generation < 0) {
+      func.emitError("hardware generation must be set");
+      signalPassFailure();
+      return;
+    }
+    int64_t budget = vmem_budget_bytes >= 0
+                         ? vmem_budget_bytes
+                         : vmemCapacityBytes(hardware_generation);
+
+    // Buffers the kernel has already pinned to VMEM consume budget first.
+    llvm::SmallVector<BufferPlacement> candidates;
+    for (BlockArgument arg : func.getArguments()) {
+      auto ty = dyn_cast<MemRefType>(arg.getType());
+      if (!ty) {
+        continue;
+      }
+      auto space = dyn_cast_if_present<MemorySpaceAttr>(ty.getMemorySpace());
+      if (!space) {
+        continue;
+      }
+      std::optional<int64_t> bytes = vmemBufferBytes(ty, hardware_generation);
+      if (space.getValue() == MemorySpace::vmem && bytes.has_value()) {
+        budget -= *bytes;
+      } else if (space.getValue() == MemorySpace::kAny && bytes.has_value()) {
+        candidates.push_back({cast<TypedValue<MemRefType>>(Value(arg)), *bytes,
+                              accessFrequency(arg)});
+      }
+    }
+
+    // Hottest bytes first: a buffer's claim on VMEM is its loop-weighted
+    // access count per byte. Whatever does not fit under the remaining
+    // budget is spilled to HBM, whose refs the kAny op set (slices, layout
+    // erasure, DMA) already supports — the coldest buffers pay the DMA.
+    llvm::stable_sort(candidates,
+                      [](const BufferPlacement& a, const BufferPlacement& b) {
+                        return a.frequency * b.bytes > b.frequency * a.bytes;
+                      });
+    for (const BufferPlacement& candidate : candidates) {
+      MemorySpace space = candidate.bytes <= budget ? MemorySpace::vmem
+                                                    : MemorySpace::kHbm;
+      if (failed(specializeMemorySpace(candidate.value, space))) {
+        signalPassFailure();
+        return;
+      }
+      if (space == MemorySpace::vmem) {
+        budget -= candidate.bytes;
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<func::FuncOp>> createAssignMemorySpacesPass(
+    int hardware_generation, int64_t vmem_budget_bytes) {
+  return std::make_unique<AssignMemorySpacesPass>(hardware_generation,
+                                                  vmem_budget_bytes);
+}
+
 }  // namespace tpu
 }  // namespace mlir
@@ -164,11 +164,16 @@ struct MosaicSerdePass : public impl::MosaicSerdePassBase<MosaicSerdePass> {
           op->emitError("Operation not in a serialized form");
           return WalkResult::interrupt();
         }
-        // Upgrade the op to the current version, if needed.
-        if (const auto rule = upgrade_rules().find(new_name->getStringRef());
-            rule != upgrade_rules().end()) {
-          if (rule->second(op, version).failed()) {
-            return WalkResult::interrupt();
+        // Upgrade the op to the current version, if needed. Modules stored at
+        // the current version never need upgrades, so skip the rule lookup
+        // entirely for them — deserialization is on the executable cache load
+        // path and the probe would otherwise run once per op.
+        if (version < kVersion) {
+          if (const auto rule = upgrade_rules().find(new_name->getStringRef());
+              rule != upgrade_rules().end()) {
+            if (rule->second(op, version).failed()) {
+              return WalkResult::interrupt();
+            }
           }
         }
       }
@@ -18,25 +18,35 @@ limitations under the License.
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include <chrono>
 #include <cstdint>
+#include <cstdio>
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
 #include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/synchronization/mutex.h"
 #include "llvm/include/llvm/ADT/SmallVector.h"
+#include "llvm/include/llvm/ADT/StringExtras.h"
+#include "llvm/include/llvm/ADT/StringRef.h"
 #include "llvm/include/llvm/Support/CodeGen.h"
+#include "llvm/include/llvm/Support/SHA256.h"
 #include "llvm/include/llvm/Support/TargetSelect.h"
+#include "llvm/include/llvm/Support/raw_ostream.h"
 #include "mlir/include/mlir/Conversion/ArithToLLVM/ArithToLLVM.h"
 #include "mlir/include/mlir/Conversion/ComplexToLLVM/ComplexToLLVM.h"
 #include "mlir/include/mlir/Conversion/ControlFlowToLLVM/ControlFlowToLLVM.h"
@@ -64,6 +74,7 @@ limitations under the License.
 #include "mlir/include/mlir/IR/AsmState.h"
 #include "mlir/include/mlir/IR/DialectRegistry.h"
 #include "mlir/include/mlir/IR/MLIRContext.h"
+#include "mlir/include/mlir/IR/OwningOpRef.h"
 #include "mlir/include/mlir/Parser/Parser.h"
 #include "mlir/include/mlir/Pass/PassManager.h"
 #include "mlir/include/mlir/Pass/PassRegistry.h"
@@ -75,10 +86,12 @@ limitations under the License.
 #include "mlir/include/mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
 #include "mlir/include/mlir/Target/LLVMIR/Dialect/NVVM/NVVMToLLVMIRTranslation.h"
 #include "mlir/include/mlir/Transforms/Passes.h"
+#include "jaxlib/gpu/launch_latency.h"
 #include "jaxlib/mosaic/gpu/launch_lowering.h"
 #include "jaxlib/mosaic/gpu/passes.h"
 #include "xla/service/custom_call_status.h"
 #include "xla/service/custom_call_target_registry.h"
+#include "xla/stream_executor/cuda/cuda_asm_compiler.h"
 
 namespace {
 
@@ -273,27 +286,48 @@ void DumpCompilationOutput(mlir::ModuleOp module) {
       std::cerr << "Failed to create a temporary directory" << std::endl;
       continue;
     }
-    std::string ptx_path = std::string(tmpdir->GetPath()) + "/kernel.ptx";
     std::string elf_path = std::string(tmpdir->GetPath()) + "/kernel.o";
-    // Dump PTX into a file.
-    std::ofstream ptx_out(ptx_path.c_str());
-    if (!ptx_out) {
-      std::cerr << "Failed to write PTX to a file" << std::endl;
-      continue;
-    }
-    ptx_out << ptx << std::endl;
-    // Run ptxas to generate SASS.
-    std::vector<const char*> ptxas_args = {
-        "ptxas",          "--opt-level",   "3",
-        "--gpu-name",     "sm_90a",        "--output-file",
-        elf_path.c_str(), ptx_path.c_str()};
-    if (dump_ptxas) {
-      ptxas_args.push_back("-v");
+    bool have_elf = false;
+    if (!dump_ptxas) {
+      // Assemble in process through nvPTXCompiler, like the Triton kernel
+      // path does, which skips the ptxas spawn and the PTX temp file. When
+      // ptxas's own verbose output was requested we must still shell out,
+      // since that output only exists on the tool's console.
+      auto elf = stream_executor::CompileGpuAsm(
+          /*cc_major=*/9, /*cc_minor=*/0, ptx.c_str(),
+          stream_executor::GpuAsmOpts{});
+      if (elf.ok()) {
+        std::ofstream elf_out(elf_path.c_str(), std::ios::binary);
+        elf_out.write(reinterpret_cast<const char*>(elf->data()), elf->size());
+        elf_out.close();
+        have_elf = elf_out.good();
+      }
+      // On failure (e.g. libnvptxcompiler unavailable at runtime) fall back
+      // to invoking ptxas below.
     }
-    ptxas_args.push_back(nullptr);
-    if (auto status = RunCUDATool("ptxas", ptxas_args); !status.ok()) {
-      std::cerr << "ptxas invocation failed: " << status.message() << std::endl;
-      continue;
+    if (!have_elf) {
+      std::string ptx_path = std::string(tmpdir->GetPath()) + "/kernel.ptx";
+      // Dump PTX into a file.
+      std::ofstream ptx_out(ptx_path.c_str());
+      if (!ptx_out) {
+        std::cerr << "Failed to write PTX to a file" << std::endl;
+        continue;
+      }
+      ptx_out << ptx << std::endl;
+      // Run ptxas to generate SASS.
+      std::vector<const char*> ptxas_args = {
+          "ptxas",          "--opt-level",   "3",
+          "--gpu-name",     "sm_90a",        "--output-file",
+          elf_path.c_str(), ptx_path.c_str()};
+      if (dump_ptxas) {
+        ptxas_args.push_back("-v");
+      }
+      ptxas_args.push_back(nullptr);
+      if (auto status = RunCUDATool("ptxas", ptxas_args); !status.ok()) {
+        std::cerr << "ptxas invocation failed: " << status.message()
+                  << std::endl;
+        continue;
+      }
     }
     if (!dump_sass) { continue; }  // We're done.
     // Call nvdisasm to pretty-print SASS.
@@ -307,18 +341,11 @@ void DumpCompilationOutput(mlir::ModuleOp module) {
   }
 }
 
-absl::StatusOr<std::unique_ptr<mlir::ExecutionEngine>> Compile(
+// JIT-compiles the host-side launcher of an already lowered module. The
+// module must have been run through the full pass pipeline, so that the
+// device code is embedded as a binary in gpu.binary ops.
+absl::StatusOr<std::unique_ptr<mlir::ExecutionEngine>> CreateEngine(
     mlir::ModuleOp module) {
-  DumpCompilationOutput(module);
-  auto passes = GetPassPipeline(module.getContext(),
-                                mlir::gpu::CompilationTarget::Binary);
-  if (mlir::failed(passes)) {
-    return absl::InternalError("Failed to construct pass pipeline");
-  }
-  if (mlir::failed(RunPasses(std::move(*passes), module))) {
-    return absl::InternalError("Pass pipeline failed");
-  }
-
   llvm::SmallVector<llvm::StringRef> runtime_lib;
   if (const char* lib_path = getenv("MOSAIC_GPU_RUNTIME_LIB_PATH")) {
     runtime_lib.emplace_back(lib_path);
@@ -336,6 +363,66 @@ absl::StatusOr<std::unique_ptr<mlir::ExecutionEngine>> Compile(
   return std::move(*maybe_execution_engine);
 }
 
+absl::StatusOr<std::unique_ptr<mlir::ExecutionEngine>> Compile(
+    mlir::ModuleOp module) {
+  DumpCompilationOutput(module);
+  auto passes = GetPassPipeline(module.getContext(),
+                                mlir::gpu::CompilationTarget::Binary);
+  if (mlir::failed(passes)) {
+    return absl::InternalError("Failed to construct pass pipeline");
+  }
+  if (mlir::failed(RunPasses(std::move(*passes), module))) {
+    return absl::InternalError("Pass pipeline failed");
+  }
+  return CreateEngine(module);
+}
+
+// Bump this whenever the lowered form stored in the on-disk cache changes
+// incompatibly (e.g. when the pass pipeline or the target chip changes).
+constexpr int kKernelCacheVersion = 1;
+
+// Returns the path of the on-disk cache entry for the given serialized
+// module, or an empty string if the cache is disabled. The cache is enabled
+// by pointing MOSAIC_GPU_CACHE_DIR at an existing directory. Entries hold the
+// fully lowered module, with the device binary already embedded in gpu.binary
+// ops, so warm restarts skip the MLIR pipeline and the ptxas invocation and
+// only pay for the host-side JIT.
+std::string KernelCachePath(llvm::StringRef module) {
+  const char* cache_dir = getenv("MOSAIC_GPU_CACHE_DIR");
+  if (!cache_dir) {
+    return "";
+  }
+  llvm::SHA256 hasher;
+  hasher.update(module);
+  std::string path(cache_dir);
+  path += "/mosaic-gpu-sm_90a-v";
+  path += std::to_string(kKernelCacheVersion);
+  path += "-";
+  path += llvm::toHex(hasher.final(), /*LowerCase=*/true);
+  path += ".mlir";
+  return path;
+}
+
+// Persists the lowered module at the given cache path. Failures are silently
+// ignored: the cache is best-effort and the kernel has already been compiled.
+void WriteKernelCacheEntry(mlir::ModuleOp module, const std::string& path) {
+  // Write to a process-unique file first so concurrent processes compiling
+  // the same kernel cannot observe a partially written entry, then publish
+  // it with an atomic rename.
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+  std::string printed;
+  llvm::raw_string_ostream os(printed);
+  module.print(os);
+  std::ofstream out(tmp_path.c_str());
+  out << printed;
+  out.close();
+  if (out) {
+    std::rename(tmp_path.c_str(), path.c_str());
+  } else {
+    std::remove(tmp_path.c_str());
+  }
+}
+
 class CompiledKernel {
  public:
   CompiledKernel(std::unique_ptr<mlir::ExecutionEngine> engine, void* ctx,
@@ -352,11 +439,20 @@ class CompiledKernel {
   MosaicHostFunc* host_launch_;
 };
 
-std::pair<absl::flat_hash_map<uint64_t, CompiledKernel>*, absl::Mutex*>
+// A cache slot for one kernel_id. The entry-level mutex serializes
+// compilation of a single kernel while letting distinct kernels compile
+// concurrently; the cache-level mutex is only held for map operations.
+struct KernelCacheEntry {
+  absl::Mutex mutex;
+  std::optional<CompiledKernel> kernel ABSL_GUARDED_BY(mutex);
+};
+
+std::pair<absl::flat_hash_map<uint64_t, std::shared_ptr<KernelCacheEntry>>*,
+          absl::Mutex*>
 GetKernelCache() {
   static absl::Mutex mutex;
   static auto& context_cache =
-      *new absl::flat_hash_map<uint64_t, CompiledKernel>;
+      *new absl::flat_hash_map<uint64_t, std::shared_ptr<KernelCacheEntry>>;
   return std::make_pair(&context_cache, &mutex);
 }
 
@@ -364,34 +460,70 @@ GetKernelCache() {
 // a single HLO module. So it should be safe to not include the CUDA context
 // in the key.
 absl::StatusOr<std::pair<void*, MosaicHostFunc*>> CompileAndInit(
-    uint64_t kernel_id, const char* module) {
+    uint64_t kernel_id, llvm::StringRef module) {
   auto cache_and_mutex = GetKernelCache();
   auto* cache = cache_and_mutex.first;
   auto* mutex = cache_and_mutex.second;
 
+  std::shared_ptr<KernelCacheEntry> entry;
   {
     // Fast path uses reader lock (as hash map look-up is relatively slow).
     absl::ReaderMutexLock lock(mutex);
     auto it = cache->find(kernel_id);
-    if (ABSL_PREDICT_TRUE(it != cache->end()))
-      return it->second.GetHostLaunch();
+    if (ABSL_PREDICT_TRUE(it != cache->end())) {
+      entry = it->second;
+    }
+  }
+  if (!entry) {
+    absl::MutexLock lock(mutex);
+    // We released the reader lock, another thread might have created it.
+    std::shared_ptr<KernelCacheEntry>& slot = (*cache)[kernel_id];
+    if (!slot) {
+      slot = std::make_shared<KernelCacheEntry>();
+    }
+    entry = slot;
   }
 
-  absl::MutexLock lock(mutex);
-  // We released the reader lock, another thread might have initialized it.
-  if (cache->find(kernel_id) == cache->end()) {
+  // Only the entry for this kernel_id is locked during the compile, so
+  // first-touch compilation of distinct kernels proceeds in parallel, with
+  // concurrency bounded by the number of calling executor threads.
+  absl::MutexLock entry_lock(&entry->mutex);
+  if (!entry->kernel.has_value()) {
     mlir::MLIRContext context(mlir::MLIRContext::Threading::DISABLED);
     InitContext(&context);
     mlir::ParserConfig parse_config(&context);
-    auto module_op =
-        mlir::parseSourceString<mlir::ModuleOp>(module, parse_config);
+    const std::string cache_path = KernelCachePath(module);
+    mlir::OwningOpRef<mlir::ModuleOp> module_op;
+    bool lowered = false;
+    if (!cache_path.empty()) {
+      if (std::ifstream in(cache_path.c_str()); in) {
+        std::ostringstream lowered_src;
+        lowered_src << in.rdbuf();
+        module_op = mlir::parseSourceString<mlir::ModuleOp>(lowered_src.str(),
+                                                            parse_config);
+        // An unparsable entry (e.g. truncated by a failed write) falls back
+        // to a full compile below.
+        lowered = module_op != nullptr;
+      }
+    }
     if (!module_op) {
-      return absl::InternalError("Failed to parse module");
+      // The lowering embeds the module as MLIR bytecode, which
+      // parseSourceString dispatches on by its magic number. Textual IR from
+      // executables serialized by older versions still parses here.
+      module_op = mlir::parseSourceString<mlir::ModuleOp>(module, parse_config);
+      if (!module_op) {
+        return absl::InternalError("Failed to parse module");
+      }
     }
-    auto maybe_engine = Compile(*module_op);
+    auto maybe_engine = lowered ? CreateEngine(*module_op) : Compile(*module_op);
     if (!maybe_engine.ok()) {
       return maybe_engine.status();
     }
+    if (!lowered && !cache_path.empty()) {
+      // Compile() lowered module_op in place, so it now embeds the device
+      // binary and can be persisted for future processes.
+      WriteKernelCacheEntry(*module_op, cache_path);
+    }
     mlir::ExecutionEngine* execution_engine = maybe_engine->get();
     auto main = execution_engine->lookupPacked("_mlir_ciface_main");
     auto init = execution_engine->lookupPacked("_mlir_ciface_main_init");
@@ -401,17 +533,21 @@ absl::StatusOr<std::pair<void*, MosaicHostFunc*>> CompileAndInit(
     void* ctx;
     void** ptr_to_ctx = &ctx;
     reinterpret_cast<MosaicInitFunc*>(*init)(&ptr_to_ctx);
-    cache->insert_or_assign(
-        kernel_id, CompiledKernel(std::move(*maybe_engine), ctx,
-                                  reinterpret_cast<MosaicHostFunc*>(*main)));
+    entry->kernel.emplace(std::move(*maybe_engine), ctx,
+                          reinterpret_cast<MosaicHostFunc*>(*main));
   }
-  return cache->at(kernel_id).GetHostLaunch();
+  return entry->kernel->GetHostLaunch();
 }
 
 void MosaicGPUCustomCall(void* stream, void** buffers, char* opaque,
                          size_t opaque_len, XlaCustomCallStatus* status) {
+  auto start = std::chrono::steady_clock::now();
   uint64_t kernel_id = *reinterpret_cast<uint64_t*>(opaque);
-  auto ctx_and_kernel = CompileAndInit(kernel_id, opaque + sizeof(uint64_t));
+  // The payload after the kernel id is MLIR bytecode, so its length must be
+  // passed explicitly: bytecode routinely contains NUL bytes.
+  auto ctx_and_kernel = CompileAndInit(
+      kernel_id, llvm::StringRef(opaque + sizeof(uint64_t),
+                                 opaque_len - sizeof(uint64_t)));
   if (!ctx_and_kernel.ok()) {
     XlaCustomCallStatusSetFailure(status,
                                   ctx_and_kernel.status().message().data(),
@@ -420,6 +556,12 @@ void MosaicGPUCustomCall(void* stream, void** buffers, char* opaque,
   }
   void* args[3] = {&ctx_and_kernel->first, &stream, &buffers};
   ctx_and_kernel->second(args);
+  // Mosaic kernels are identified by an opaque id rather than a name, so the
+  // histogram is keyed per kernel id. First-touch samples include the compile.
+  jax::RecordLaunchLatency(absl::StrCat("mosaic_gpu:", kernel_id),
+                           std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - start)
+                               .count());
 }
 
 XLA_REGISTER_CUSTOM_CALL_TARGET_WITH_SYM("mosaic_gpu", &MosaicGPUCustomCall,
@@ -118,6 +118,31 @@ void emitRuntimeDecls(mlir::ModuleOp module) {
                               {ptr_ty}),
       decl_builder.getStringAttr("private"), /*arg_attr=*/nullptr,
       /*res_attrs=*/nullptr);
+  // Stream-capture entry points: launches issued between begin and end become
+  // a replayable graph, which mosaic_gpu_graph_launch replays with a single
+  // call. Used by kernels whose steady state re-issues many small launches.
+  decl_builder.create<mlir::func::FuncOp>(
+      module.getLoc(),
+      decl_builder.getStringAttr("mosaic_gpu_begin_stream_capture"),
+      mlir::FunctionType::get(module.getContext(), {ptr_ty}, {}),
+      decl_builder.getStringAttr("private"), /*arg_attr=*/nullptr,
+      /*res_attrs=*/nullptr);
+  decl_builder.create<mlir::func::FuncOp>(
+      module.getLoc(),
+      decl_builder.getStringAttr("mosaic_gpu_end_stream_capture"),
+      mlir::FunctionType::get(module.getContext(), {ptr_ty}, {ptr_ty}),
+      decl_builder.getStringAttr("private"), /*arg_attr=*/nullptr,
+      /*res_attrs=*/nullptr);
+  decl_builder.create<mlir::func::FuncOp>(
+      module.getLoc(), decl_builder.getStringAttr("mosaic_gpu_graph_launch"),
+      mlir::FunctionType::get(module.getContext(), {ptr_ty, ptr_ty}, {}),
+      decl_builder.getStringAttr("private"), /*arg_attr=*/nullptr,
+      /*res_attrs=*/nullptr);
+  decl_builder.create<mlir::func::FuncOp>(
+      module.getLoc(), decl_builder.getStringAttr("mosaic_gpu_graph_destroy"),
+      mlir::FunctionType::get(module.getContext(), {ptr_ty}, {}),
+      decl_builder.getStringAttr("private"), /*arg_attr=*/nullptr,
+      /*res_attrs=*/nullptr);
 }
 
 void buildInitFunction(mlir::OpBuilder &module_builder,
@@ -14,8 +14,12 @@ limitations under the License.
 ==============================================================================*/
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "nanobind/nanobind.h"
+#include "nanobind/stl/pair.h"
+#include "nanobind/stl/vector.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
 #include "jaxlib/gpu/vendor.h"
@@ -27,6 +31,26 @@ namespace {
 
 namespace nb = nanobind;
 
+// Pools of idle events, keyed by the device that created them. Events handed
+// out by _gpu_event_create return here on _gpu_event_destroy instead of being
+// destroyed, so per-step profiling stops paying event creation in the driver
+// for every measurement. Events are bound to the device current at creation
+// time, so an event must only ever be recycled onto its own device's pool.
+absl::Mutex event_pool_mutex;
+absl::flat_hash_map<int, std::vector<gpuEvent_t*>>& EventPool() {
+  static auto& pool = *new absl::flat_hash_map<int, std::vector<gpuEvent_t*>>;
+  return pool;
+}
+
+// The device current on the calling thread, used as the pool key.
+int CurrentDevice() {
+  gpuDevice_t device = 0;
+  if (gpuCtxGetDevice(&device) != gpuSuccess) {
+    throw std::runtime_error("Failed to query the current device");
+  }
+  return static_cast<int>(device);
+}
+
 void EventRecordCall(void* stream, void** buffers, char* opaque,
                      size_t opaque_len, XlaCustomCallStatus* status) {
   auto* event = reinterpret_cast<gpuEvent_t**>(opaque);
@@ -39,12 +63,25 @@ void EventRecordCall(void* stream, void** buffers, char* opaque,
 
 NB_MODULE(_mosaic_gpu_ext, m) {
   m.def("_gpu_event_create", []() {
+    const int device = CurrentDevice();
+    {
+      absl::MutexLock lock(&event_pool_mutex);
+      std::vector<gpuEvent_t*>& pool = EventPool()[device];
+      if (!pool.empty()) {
+        gpuEvent_t* event = pool.back();
+        pool.pop_back();
+        return reinterpret_cast<uintptr_t>(event);
+      }
+    }
     gpuEvent_t* event = new gpuEvent_t();
     gpuEventCreate(event, GPU_EVENT_DEFAULT);
     return reinterpret_cast<uintptr_t>(event);
   });
   m.def("_gpu_event_destroy", [](uintptr_t event) {
-    gpuEventDestroy(*reinterpret_cast<gpuEvent_t*>(event));
+    // Recycle the event; recording overwrites any previous state.
+    const int device = CurrentDevice();
+    absl::MutexLock lock(&event_pool_mutex);
+    EventPool()[device].push_back(reinterpret_cast<gpuEvent_t*>(event));
   });
   m.def("_gpu_event_elapsed", [](uintptr_t start_event, uintptr_t end_event) {
     float elapsed_ms = -1;
@@ -55,6 +92,24 @@ NB_MODULE(_mosaic_gpu_ext, m) {
     }
     return elapsed_ms;
   });
+  m.def("_gpu_event_elapsed_many",
+        [](const std::vector<std::pair<uintptr_t, uintptr_t>>& event_pairs) {
+          // Batched variant of _gpu_event_elapsed: queries all pairs in one
+          // native call so instrumented runs don't pay a Python boundary
+          // crossing per measurement.
+          std::vector<float> elapsed(event_pairs.size());
+          for (size_t i = 0; i < event_pairs.size(); ++i) {
+            if (gpuEventElapsedTime(
+                    &elapsed[i],
+                    *reinterpret_cast<gpuEvent_t*>(event_pairs[i].first),
+                    *reinterpret_cast<gpuEvent_t*>(event_pairs[i].second)) !=
+                gpuSuccess) {
+              throw std::runtime_error(
+                  "Failed to get elapsed time between events");
+            }
+          }
+          return elapsed;
+        });
   m.def("_record_event_capsule",
         []() { return EncapsulateFunction(EventRecordCall); });
 }
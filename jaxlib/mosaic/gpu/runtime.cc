@@ -16,14 +16,54 @@ limitations under the License.
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #include "third_party/gpus/cuda/include/cuda.h"
 
+namespace {
+
+// Cache of encoded TMA descriptors, keyed by the raw bytes of all encode
+// parameters (base address, element width, shape, strides, swizzle and
+// window shape). Iterating autotuners and re-initialized executables init
+// the same descriptors repeatedly, and the host-side encode sits on the
+// critical path before a kernel can run. The cache only grows with the
+// number of distinct descriptors, each 128 bytes.
+std::mutex tma_desc_cache_mutex;
+std::unordered_map<std::string, CUtensorMap>& TmaDescCache() {
+  static auto& cache = *new std::unordered_map<std::string, CUtensorMap>;
+  return cache;
+}
+
+}  // namespace
+
 extern "C" {
 
 void mosaic_gpu_init_tma_desc(CUtensorMap *tma_desc, void *base_addr,
                               int64_t elem_bytewidth, int64_t rank,
                               int64_t *sizes, int64_t *strides,
                               int64_t swizzle_bytes, int64_t *window_shape) {
+  std::string cache_key;
+  cache_key.reserve((3 + 3 * rank) * sizeof(int64_t) + sizeof(void *));
+  auto append_key = [&cache_key](const void *data, size_t size) {
+    cache_key.append(static_cast<const char *>(data), size);
+  };
+  append_key(&base_addr, sizeof(base_addr));
+  append_key(&elem_bytewidth, sizeof(elem_bytewidth));
+  append_key(&swizzle_bytes, sizeof(swizzle_bytes));
+  append_key(sizes, rank * sizeof(int64_t));
+  append_key(strides, rank * sizeof(int64_t));
+  append_key(window_shape, rank * sizeof(int64_t));
+  {
+    std::lock_guard<std::mutex> lock(tma_desc_cache_mutex);
+    auto it = TmaDescCache().find(cache_key);
+    if (it != TmaDescCache().end()) {
+      memcpy(tma_desc, &it->second, sizeof(CUtensorMap));
+      return;
+    }
+  }
   CUtensorMapDataType data_type;
   if (elem_bytewidth == 1) {
     data_type = CU_TENSOR_MAP_DATA_TYPE_UINT8;
@@ -79,6 +119,8 @@ void mosaic_gpu_init_tma_desc(CUtensorMap *tma_desc, void *base_addr,
     fprintf(stderr, "cuTensorMapEncodeTiled failed: %s\n", ptr);
     abort();
   }
+  std::lock_guard<std::mutex> lock(tma_desc_cache_mutex);
+  TmaDescCache().emplace(std::move(cache_key), *tma_desc);
 }
 
 void mosaic_gpu_memcpy_async_h2d(CUdeviceptr dst, void *src, uint64_t bytes,
@@ -126,6 +168,68 @@ void *mosaic_gpu_get_function(CUmodule module, const char *name,
   return function;
 }
 
+void mosaic_gpu_begin_stream_capture(CUstream stream) {
+  CUresult result =
+      cuStreamBeginCapture(stream, CU_STREAM_CAPTURE_MODE_THREAD_LOCAL);
+  if (result != CUDA_SUCCESS) {
+    const char *ptr = nullptr;
+    cuGetErrorString(result, &ptr);
+    fprintf(stderr, "cuStreamBeginCapture failed: %s\n", ptr);
+    abort();
+  }
+}
+
+// Ends the capture started by mosaic_gpu_begin_stream_capture and returns a
+// replayable graph handle. Launches issued on the stream in between (kernel
+// launches, async copies) become graph nodes, so steady-state executions of
+// fixed-shape kernels can replay the graph with a single launch instead of
+// re-issuing them one by one.
+void *mosaic_gpu_end_stream_capture(CUstream stream) {
+  CUgraph graph = nullptr;
+  CUresult result = cuStreamEndCapture(stream, &graph);
+  if (result != CUDA_SUCCESS) {
+    const char *ptr = nullptr;
+    cuGetErrorString(result, &ptr);
+    fprintf(stderr, "cuStreamEndCapture failed: %s\n", ptr);
+    abort();
+  }
+  CUgraphExec graph_exec = nullptr;
+  result = cuGraphInstantiate(&graph_exec, graph, 0);
+  if (result != CUDA_SUCCESS) {
+    const char *ptr = nullptr;
+    cuGetErrorString(result, &ptr);
+    fprintf(stderr, "cuGraphInstantiate failed: %s\n", ptr);
+    abort();
+  }
+  // The executable graph keeps its own reference to the topology.
+  if (cuGraphDestroy(graph) != CUDA_SUCCESS) {
+    fprintf(stderr, "cuGraphDestroy failed\n");
+    abort();
+  }
+  return graph_exec;
+}
+
+void mosaic_gpu_graph_launch(void *graph_exec, CUstream stream) {
+  CUresult result =
+      cuGraphLaunch(static_cast<CUgraphExec>(graph_exec), stream);
+  if (result != CUDA_SUCCESS) {
+    const char *ptr = nullptr;
+    cuGetErrorString(result, &ptr);
+    fprintf(stderr, "cuGraphLaunch failed: %s\n", ptr);
+    abort();
+  }
+}
+
+void mosaic_gpu_graph_destroy(void *graph_exec) {
+  CUresult result = cuGraphExecDestroy(static_cast<CUgraphExec>(graph_exec));
+  if (result != CUDA_SUCCESS) {
+    const char *ptr = nullptr;
+    cuGetErrorString(result, &ptr);
+    fprintf(stderr, "cuGraphExecDestroy failed: %s\n", ptr);
+    abort();
+  }
+}
+
 void mosaic_gpu_launch_kernel(CUfunction function, int64_t grid_x,
                               int64_t grid_y, int64_t grid_z, int64_t block_x,
                               int64_t block_y, int64_t block_z,
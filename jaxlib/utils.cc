@@ -23,15 +23,103 @@ namespace nb = nanobind;
 
 namespace {
 
-// A variant of map(...) that:
-// a) returns a list instead of an iterator, and
-// b) checks that the input iterables are of equal length.
-PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+// Returns the length of an argument known to be exactly a list or a tuple.
+Py_ssize_t SequenceLength(PyObject* o) {
+  return PyList_CheckExact(o) ? PyList_GET_SIZE(o) : PyTuple_GET_SIZE(o);
+}
+
+// Returns a borrowed reference to element i of an argument known to be
+// exactly a list or a tuple.
+PyObject* SequenceItem(PyObject* o, Py_ssize_t i) {
+  return PyList_CheckExact(o) ? PyList_GET_ITEM(o, i)
+                              : PyTuple_GET_ITEM(o, i);
+}
+
+// True if every argument in args[start:nargs] is exactly a list or a tuple.
+bool AllExactSequences(PyObject* const* args, Py_ssize_t start,
+                       Py_ssize_t nargs) {
+  for (Py_ssize_t i = start; i < nargs; ++i) {
+    if (!PyList_CheckExact(args[i]) && !PyTuple_CheckExact(args[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Fast path for SafeMap when every input is exactly a list or a tuple, which
+// is nearly always the case during tracing. The lengths are known up front,
+// so the equal-length check is one comparison per argument and the elements
+// can be read straight out of the backing arrays instead of going through the
+// iterator protocol per element. Fills a tuple instead of a list if
+// 'tuple_output' is set; 'name' is the Python-level function name used in
+// error messages.
+PyObject* SafeMapSequences(PyObject* fn, PyObject* const* args,
+                           Py_ssize_t nargs, bool tuple_output,
+                           const char* name) {
+  Py_ssize_t length = SequenceLength(args[1]);
+  for (Py_ssize_t i = 2; i < nargs; ++i) {
+    Py_ssize_t other_length = SequenceLength(args[i]);
+    if (other_length != length) {
+      PyErr_Format(PyExc_ValueError, "%s() argument %zd is %s than argument 1",
+                   name, i, other_length < length ? "shorter" : "longer");
+      return nullptr;
+    }
+  }
+
+  nb::object result = nb::steal<nb::object>(
+      tuple_output ? PyTuple_New(length) : PyList_New(length));
+  if (!result.ptr()) return nullptr;
+
+  // The arguments we will pass to fn. We allocate space for one more argument
+  // than we need at the start of the argument list so we can use
+  // PY_VECTORCALL_ARGUMENTS_OFFSET which may speed up the callee.
+  absl::InlinedVector<PyObject*, 4> values(nargs, nullptr);
+  for (Py_ssize_t n = 0; n < length; ++n) {
+    // Nulling the slots matters: on an error return mid-iteration the next
+    // cleanup would otherwise decref the previous iteration's pointers again.
+    absl::Cleanup values_cleanup = [&values]() {
+      for (PyObject*& v : values) {
+        Py_XDECREF(v);
+        v = nullptr;
+      }
+    };
+    for (Py_ssize_t i = 1; i < nargs; ++i) {
+      // fn may have mutated a list argument during a previous call; make sure
+      // reading the backing array stays in bounds.
+      if (SequenceLength(args[i]) != length) {
+        PyErr_Format(PyExc_RuntimeError,
+                     "%s() argument %zd changed size during iteration", name,
+                     i);
+        return nullptr;
+      }
+      values[i] = SequenceItem(args[i], n);
+      Py_INCREF(values[i]);
+    }
+    PyObject* out = PyObject_Vectorcall(
+        fn, &values[1], (nargs - 1) | PY_VECTORCALL_ARGUMENTS_OFFSET,
+        /*kwnames=*/nullptr);
+    if (!out) return nullptr;
+    if (tuple_output) {
+      PyTuple_SET_ITEM(result.ptr(), n, out);
+    } else {
+      PyList_SET_ITEM(result.ptr(), n, out);
+    }
+  }
+  return result.release().ptr();
+}
+
+// Shared implementation of safe_map and safe_map_tuple; the only difference
+// is the type of the output container.
+PyObject* SafeMapImpl(PyObject* const* args, Py_ssize_t nargs,
+                      bool tuple_output, const char* name) {
   if (nargs < 2) {
-    PyErr_SetString(PyExc_TypeError, "safe_map requires at least 2 arguments");
+    PyErr_Format(PyExc_TypeError, "%s requires at least 2 arguments", name);
     return nullptr;
   }
   PyObject* fn = args[0];
+  if (AllExactSequences(args, 1, nargs)) {
+    return SafeMapSequences(fn, args, nargs, tuple_output, name);
+  }
   absl::InlinedVector<nb::object, 4> iterators;
   iterators.reserve(nargs - 1);
   for (Py_ssize_t i = 1; i < nargs; ++i) {
@@ -49,8 +137,11 @@ PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
     length_hint = 2;
   }
 
-  nb::list list = nb::steal<nb::list>(PyList_New(length_hint));
-  int n = 0;  // Current true size of the list
+  Py_ssize_t capacity = length_hint;
+  nb::object result = nb::steal<nb::object>(
+      tuple_output ? PyTuple_New(capacity) : PyList_New(capacity));
+  if (!result.ptr()) return nullptr;
+  Py_ssize_t n = 0;  // Current true size of the output
 
   // The arguments we will pass to fn. We allocate space for one more argument
   // than we need at the start of the argument list so we can use
@@ -58,7 +149,7 @@ PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
   absl::InlinedVector<PyObject*, 4> values(nargs, nullptr);
   while (true) {
     absl::Cleanup values_cleanup = [&values]() {
-      for (PyObject* v : values) {
+      for (PyObject*& v : values) {
         Py_XDECREF(v);
         v = nullptr;
       }
@@ -72,7 +163,7 @@ PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
         if (PyErr_Occurred()) return nullptr;
         if (!values[i + 1]) {
           PyErr_Format(PyExc_ValueError,
-                       "safe_map() argument %u is shorter than argument 1",
+                       "%s() argument %u is shorter than argument 1", name,
                        i + 1);
           return nullptr;
         }
@@ -85,19 +176,25 @@ PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
         if (PyErr_Occurred()) return nullptr;
         if (values[i + 1]) {
           PyErr_Format(PyExc_ValueError,
-                       "safe_map() argument %u is longer than argument 1",
+                       "%s() argument %u is longer than argument 1", name,
                        i + 1);
           return nullptr;
         }
       }
 
-      // If the length hint was too large, truncate the list to the true size.
-      if (n < length_hint) {
-        if (PyList_SetSlice(list.ptr(), n, length_hint, nullptr) < 0) {
+      // If the length hint was too large, truncate the output to the true
+      // size.
+      if (n < capacity) {
+        if (tuple_output) {
+          PyObject* tuple = result.release().ptr();
+          if (_PyTuple_Resize(&tuple, n) < 0) return nullptr;
+          return tuple;
+        }
+        if (PyList_SetSlice(result.ptr(), n, capacity, nullptr) < 0) {
           return nullptr;
         }
       }
-      return list.release().ptr();
+      return result.release().ptr();
     }
 
     nb::object out = nb::steal<nb::object>(PyObject_Vectorcall(
@@ -107,10 +204,23 @@ PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
       return nullptr;
     }
 
-    if (n < length_hint) {
-      PyList_SET_ITEM(list.ptr(), n, out.release().ptr());
+    if (n < capacity) {
+      if (tuple_output) {
+        PyTuple_SET_ITEM(result.ptr(), n, out.release().ptr());
+      } else {
+        PyList_SET_ITEM(result.ptr(), n, out.release().ptr());
+      }
+    } else if (tuple_output) {
+      // Tuples cannot be appended to, so grow geometrically and truncate to
+      // the true size once the iterators are exhausted.
+      Py_ssize_t new_capacity = capacity > 0 ? 2 * capacity : 4;
+      PyObject* tuple = result.release().ptr();
+      if (_PyTuple_Resize(&tuple, new_capacity) < 0) return nullptr;
+      result = nb::steal<nb::object>(tuple);
+      capacity = new_capacity;
+      PyTuple_SET_ITEM(result.ptr(), n, out.release().ptr());
     } else {
-      if (PyList_Append(list.ptr(), out.ptr()) < 0) {
+      if (PyList_Append(result.ptr(), out.ptr()) < 0) {
         return nullptr;
       }
     }
@@ -118,12 +228,32 @@ PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
   }
 }
 
+// A variant of map(...) that:
+// a) returns a list instead of an iterator, and
+// b) checks that the input iterables are of equal length.
+PyObject* SafeMap(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  return SafeMapImpl(args, nargs, /*tuple_output=*/false, "safe_map");
+}
+
 PyMethodDef safe_map_def = {
     "safe_map",
     reinterpret_cast<PyCFunction>(SafeMap),
     METH_FASTCALL,
 };
 
+// Like safe_map, but fills a tuple directly instead of building a list that
+// the caller immediately converts for hashability.
+PyObject* SafeMapTuple(PyObject* self, PyObject* const* args,
+                       Py_ssize_t nargs) {
+  return SafeMapImpl(args, nargs, /*tuple_output=*/true, "safe_map_tuple");
+}
+
+PyMethodDef safe_map_tuple_def = {
+    "safe_map_tuple",
+    reinterpret_cast<PyCFunction>(SafeMapTuple),
+    METH_FASTCALL,
+};
+
 // A variant of zip(...) that:
 // a) returns a list instead of an iterator, and
 // b) checks that the input iterables are of equal length.
@@ -217,12 +347,100 @@ PyMethodDef safe_zip_def = {
     METH_FASTCALL,
 };
 
+// Implements the unzip2/unzip3 pattern from jax._src.util: transposes a
+// sequence of fixed-arity tuples into 'arity' tuples in one C pass over
+// preallocated outputs, instead of the Python-level zip(*xys) generator.
+PyObject* Unzip(PyObject* const* args, Py_ssize_t nargs, Py_ssize_t arity,
+                const char* name) {
+  if (nargs != 1) {
+    PyErr_Format(PyExc_TypeError, "%s requires exactly 1 argument", name);
+    return nullptr;
+  }
+  nb::object seq =
+      nb::steal<nb::object>(PySequence_Fast(args[0], "argument is not iterable"));
+  if (!seq.ptr()) return nullptr;
+  Py_ssize_t length = PySequence_Fast_GET_SIZE(seq.ptr());
+
+  absl::InlinedVector<nb::object, 3> outputs;
+  outputs.reserve(arity);
+  for (Py_ssize_t j = 0; j < arity; ++j) {
+    PyObject* out = PyTuple_New(length);
+    if (!out) return nullptr;
+    outputs.push_back(nb::steal<nb::object>(out));
+  }
+
+  PyObject** items = PySequence_Fast_ITEMS(seq.ptr());
+  for (Py_ssize_t i = 0; i < length; ++i) {
+    PyObject* item = items[i];
+    if (PyTuple_CheckExact(item) && PyTuple_GET_SIZE(item) == arity) {
+      for (Py_ssize_t j = 0; j < arity; ++j) {
+        PyObject* v = PyTuple_GET_ITEM(item, j);
+        Py_INCREF(v);
+        PyTuple_SET_ITEM(outputs[j].ptr(), i, v);
+      }
+    } else {
+      // Like Python-level tuple unpacking, accept any iterable of the right
+      // length, not just tuples.
+      nb::object item_seq = nb::steal<nb::object>(
+          PySequence_Fast(item, "cannot unpack non-iterable element"));
+      if (!item_seq.ptr()) return nullptr;
+      if (PySequence_Fast_GET_SIZE(item_seq.ptr()) != arity) {
+        PyErr_Format(PyExc_ValueError,
+                     "%s() expected elements of length %zd, got element %zd "
+                     "of length %zd",
+                     name, arity, i, PySequence_Fast_GET_SIZE(item_seq.ptr()));
+        return nullptr;
+      }
+      PyObject** elts = PySequence_Fast_ITEMS(item_seq.ptr());
+      for (Py_ssize_t j = 0; j < arity; ++j) {
+        Py_INCREF(elts[j]);
+        PyTuple_SET_ITEM(outputs[j].ptr(), i, elts[j]);
+      }
+    }
+  }
+
+  PyObject* result = PyTuple_New(arity);
+  if (!result) return nullptr;
+  for (Py_ssize_t j = 0; j < arity; ++j) {
+    PyTuple_SET_ITEM(result, j, outputs[j].release().ptr());
+  }
+  return result;
+}
+
+// Unzips a sequence of pairs into a pair of tuples.
+PyObject* Unzip2(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  return Unzip(args, nargs, 2, "unzip2");
+}
+
+PyMethodDef unzip2_def = {
+    "unzip2",
+    reinterpret_cast<PyCFunction>(Unzip2),
+    METH_FASTCALL,
+};
+
+// Unzips a sequence of triples into a triple of tuples.
+PyObject* Unzip3(PyObject* self, PyObject* const* args, Py_ssize_t nargs) {
+  return Unzip(args, nargs, 3, "unzip3");
+}
+
+PyMethodDef unzip3_def = {
+    "unzip3",
+    reinterpret_cast<PyCFunction>(Unzip3),
+    METH_FASTCALL,
+};
+
 }  // namespace
 
 NB_MODULE(utils, m) {
   nb::object module_name = m.attr("__name__");
   m.attr("safe_map") = nb::steal<nb::object>(
       PyCFunction_NewEx(&safe_map_def, /*self=*/nullptr, module_name.ptr()));
+  m.attr("safe_map_tuple") = nb::steal<nb::object>(PyCFunction_NewEx(
+      &safe_map_tuple_def, /*self=*/nullptr, module_name.ptr()));
   m.attr("safe_zip") = nb::steal<nb::object>(
       PyCFunction_NewEx(&safe_zip_def, /*self=*/nullptr, module_name.ptr()));
+  m.attr("unzip2") = nb::steal<nb::object>(
+      PyCFunction_NewEx(&unzip2_def, /*self=*/nullptr, module_name.ptr()));
+  m.attr("unzip3") = nb::steal<nb::object>(
+      PyCFunction_NewEx(&unzip3_def, /*self=*/nullptr, module_name.ptr()));
 }
\ No newline at end of file
@@ -120,6 +120,15 @@ class SafeMapTest(jtu.JaxTestCase):
         util.safe_map(make_tuple, range(4), range(4, 8)),
     )
 
+    # Exact lists and tuples take a separate fast path in the C++
+    # implementation.
+    self.assertEqual([0, 2, 4, 6], util.safe_map(double, [0, 1, 2, 3]))
+    self.assertEqual([0, 2, 4, 6], util.safe_map(double, (0, 1, 2, 3)))
+    self.assertEqual(
+        [(0, 4), (1, 5), (2, 6), (3, 7)],
+        util.safe_map(make_tuple, [0, 1, 2, 3], (4, 5, 6, 7)),
+    )
+
   def test_safe_map_errors(self):
     with self.assertRaisesRegex(
         TypeError, "safe_map requires at least 2 arguments"
@@ -155,6 +164,64 @@ class SafeMapTest(jtu.JaxTestCase):
     ):
       util.safe_map(operator.add, (), range(3))
 
+    with self.assertRaisesRegex(
+        ValueError, r"safe_map\(\) argument 2 is longer than argument 1"
+    ):
+      util.safe_map(operator.add, [0, 1, 2], (0, 1, 2, 3))
+
+    with self.assertRaisesRegex(
+        ValueError, r"safe_map\(\) argument 2 is shorter than argument 1"
+    ):
+      util.safe_map(operator.add, (0, 1, 2, 3), [0, 1])
+
+  def test_safe_map_tuple(self):
+    def double(x):
+      return x * 2
+
+    self.assertEqual((), util.safe_map_tuple(double, []))
+    self.assertEqual((0, 2, 4, 6), util.safe_map_tuple(double, [0, 1, 2, 3]))
+    self.assertEqual((0, 2, 4, 6), util.safe_map_tuple(double, range(4)))
+    self.assertEqual(
+        (4, 6), util.safe_map_tuple(operator.add, (1, 2), iter([3, 4]))
+    )
+
+    with self.assertRaisesRegex(
+        ValueError, r"argument 2 is longer than argument 1"
+    ):
+      util.safe_map_tuple(operator.add, range(3), range(4))
+
+
+class UnzipTest(jtu.JaxTestCase):
+
+  def test_unzip2(self):
+    self.assertEqual(((), ()), util.unzip2([]))
+    self.assertEqual(((1, 3), (2, 4)), util.unzip2([(1, 2), (3, 4)]))
+    self.assertEqual(((1, 3), (2, 4)), util.unzip2(((1, 2), (3, 4))))
+    self.assertEqual(((1, 3), (2, 4)), util.unzip2(iter([(1, 2), (3, 4)])))
+    # Like Python-level unpacking, non-tuple pairs are accepted.
+    self.assertEqual(((1, 3), (2, 4)), util.unzip2([[1, 2], [3, 4]]))
+
+  def test_unzip2_errors(self):
+    with self.assertRaises(TypeError):
+      util.unzip2(7)
+    with self.assertRaises((TypeError, ValueError)):
+      util.unzip2([(1, 2), (3, 4, 5)])
+
+  def test_unzip3(self):
+    self.assertEqual(((), (), ()), util.unzip3([]))
+    self.assertEqual(
+        ((1, 4), (2, 5), (3, 6)), util.unzip3([(1, 2, 3), (4, 5, 6)])
+    )
+    self.assertEqual(
+        ((1, 4), (2, 5), (3, 6)), util.unzip3(iter([(1, 2, 3), (4, 5, 6)]))
+    )
+
+  def test_unzip3_errors(self):
+    with self.assertRaises(TypeError):
+      util.unzip3(7)
+    with self.assertRaises((TypeError, ValueError)):
+      util.unzip3([(1, 2, 3), (4, 5)])
+
 
 class SafeZipTest(jtu.JaxTestCase):
 